@@ -0,0 +1,255 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define OB_BENCH_HAVE_TSC 1
+#endif
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace bench {
+
+/**
+ * @brief Cycle-counter clock calibrated against `steady_clock`.
+ *
+ * On x86 `now()` is a single `rdtscp`, which waits for earlier instructions to retire
+ * so the timed region cannot leak past the read. Elsewhere it falls back to
+ * `steady_clock` nanoseconds with a ratio of one. `overhead()` is the smallest
+ * back-to-back reading and is subtracted from every sample.
+ */
+class TscClock {
+public:
+    TscClock() { calibrate(); }
+
+    static std::uint64_t now() noexcept {
+#ifdef OB_BENCH_HAVE_TSC
+        unsigned aux;
+        return __rdtscp(&aux);
+#else
+        return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+    }
+
+    /// @return Nanoseconds spanned by @p ticks, net of the read overhead.
+    std::uint64_t to_ns(std::uint64_t ticks) const noexcept {
+        ticks = ticks > overhead_ ? ticks - overhead_ : 0;
+        return static_cast<std::uint64_t>(static_cast<double>(ticks) * ns_per_tick_);
+    }
+
+    double        ns_per_tick() const noexcept { return ns_per_tick_; }
+    std::uint64_t overhead() const noexcept { return overhead_; }
+
+private:
+    void calibrate() {
+        using namespace std::chrono;
+        const auto wall_start = steady_clock::now();
+        const auto tick_start = now();
+        while (steady_clock::now() - wall_start < milliseconds(50)) {}
+        const auto tick_end = now();
+        const auto wall_ns = duration_cast<nanoseconds>(steady_clock::now() - wall_start).count();
+        ns_per_tick_ = static_cast<double>(wall_ns) / static_cast<double>(tick_end - tick_start);
+
+        overhead_ = ~std::uint64_t{0};
+        for (int i = 0; i < 10'000; ++i) {
+            const auto a = now();
+            const auto b = now();
+            overhead_ = std::min(overhead_, b - a);
+        }
+    }
+
+    double        ns_per_tick_{1.0};
+    std::uint64_t overhead_{0};
+};
+
+/**
+ * @brief High-dynamic-range histogram of non-negative integer samples.
+ *
+ * Values below 2048 are counted exactly; larger values land in log-linear buckets of
+ * 1024 sub-buckets per power of two, so every recorded value is reproduced to within
+ * 0.1% across the full 64-bit range with a fixed ~450 KiB table and O(1) `record`.
+ */
+class HdrHistogram {
+public:
+    HdrHistogram() : counts_(kSubBuckets + 53 * kHalf, 0) {}
+
+    void record(std::uint64_t value) noexcept {
+        ++counts_[index_of(value)];
+        ++total_;
+        sum_ += value;
+        max_ = std::max(max_, value);
+        min_ = std::min(min_, value);
+    }
+
+    /// Fold the samples of @p other into this histogram.
+    void add(const HdrHistogram& other) noexcept {
+        for (std::size_t i = 0; i < counts_.size(); ++i) counts_[i] += other.counts_[i];
+        total_ += other.total_;
+        sum_ += other.sum_;
+        max_ = std::max(max_, other.max_);
+        min_ = std::min(min_, other.min_);
+    }
+
+    void reset() noexcept {
+        std::fill(counts_.begin(), counts_.end(), 0);
+        total_ = sum_ = max_ = 0;
+        min_ = ~std::uint64_t{0};
+    }
+
+    std::uint64_t count() const noexcept { return total_; }
+    std::uint64_t max() const noexcept { return max_; }
+    std::uint64_t min() const noexcept { return total_ ? min_ : 0; }
+    double mean() const noexcept { return total_ ? static_cast<double>(sum_) / static_cast<double>(total_) : 0.0; }
+
+    /// @return Smallest recorded bucket value with at least @p pct percent of samples at or below it.
+    std::uint64_t percentile(double pct) const noexcept {
+        if (total_ == 0) return 0;
+        const auto rank = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(pct / 100.0 * static_cast<double>(total_) + 0.5));
+        std::uint64_t seen = 0;
+        for (std::size_t i = 0; i < counts_.size(); ++i) {
+            seen += counts_[i];
+            if (seen >= rank) return std::min(value_of(i), max_);
+        }
+        return max_;
+    }
+
+private:
+    static constexpr unsigned    kSubBits    = 11;
+    static constexpr std::size_t kSubBuckets = std::size_t{1} << kSubBits;
+    static constexpr std::size_t kHalf       = kSubBuckets / 2;
+
+    static std::size_t index_of(std::uint64_t v) noexcept {
+        if (v < kSubBuckets) return static_cast<std::size_t>(v);
+        const unsigned shift = static_cast<unsigned>(std::bit_width(v)) - kSubBits;
+        return kSubBuckets + (shift - 1) * kHalf + static_cast<std::size_t>((v >> shift) - kHalf);
+    }
+
+    /// Highest value that maps to bucket @p i.
+    static std::uint64_t value_of(std::size_t i) noexcept {
+        if (i < kSubBuckets) return i;
+        const auto shift = static_cast<unsigned>((i - kSubBuckets) / kHalf + 1);
+        const auto top   = static_cast<std::uint64_t>((i - kSubBuckets) % kHalf + kHalf);
+        return ((top + 1) << shift) - 1;
+    }
+
+    std::vector<std::uint64_t> counts_;
+    std::uint64_t total_{0};
+    std::uint64_t sum_{0};
+    std::uint64_t max_{0};
+    std::uint64_t min_{~std::uint64_t{0}};
+};
+
+/// Percentiles reported by every latency benchmark.
+inline constexpr double kPercentiles[] = {50.0, 90.0, 99.0, 99.9, 99.99};
+
+/// Pin the calling thread to @p cpu; returns false where affinity is unsupported or refused.
+inline bool pin_thread(int cpu) noexcept {
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return ::pthread_setaffinity_np(::pthread_self(), sizeof(set), &set) == 0;
+#else
+    (void)cpu;
+    return false;
+#endif
+}
+
+/// Print one fixed-width summary row for @p name.
+inline void print_row(std::ostream& os, std::string_view name, const HdrHistogram& h) {
+    char line[256];
+    std::snprintf(line, sizeof(line), "%-14.*s %10llu %8.1f %7llu %7llu %7llu %8llu %9llu %9llu\n",
+                  static_cast<int>(name.size()), name.data(),
+                  static_cast<unsigned long long>(h.count()), h.mean(),
+                  static_cast<unsigned long long>(h.percentile(50.0)),
+                  static_cast<unsigned long long>(h.percentile(90.0)),
+                  static_cast<unsigned long long>(h.percentile(99.0)),
+                  static_cast<unsigned long long>(h.percentile(99.9)),
+                  static_cast<unsigned long long>(h.percentile(99.99)),
+                  static_cast<unsigned long long>(h.max()));
+    os << line;
+}
+
+inline void print_header(std::ostream& os) {
+    os << "operation           count  mean_ns     p50     p90     p99    p99.9    p99.99       max\n";
+}
+
+/**
+ * @brief Minimal streaming JSON writer for benchmark reports.
+ *
+ * Emits `{"benchmark": ..., "context": {...}, "results": [{...}, ...]}`; keys and
+ * string values are benchmark-controlled identifiers, so no escaping is attempted.
+ */
+class JsonReport {
+public:
+    explicit JsonReport(std::string benchmark) : benchmark_(std::move(benchmark)) {}
+
+    void context(std::string_view key, std::string_view value) {
+        context_ += sep(context_) + quote(key) + ": " + quote(value);
+    }
+    void context(std::string_view key, double value) {
+        context_ += sep(context_) + quote(key) + ": " + number(value);
+    }
+
+    /// Start a result object; follow with @ref field / @ref histogram calls.
+    void begin_result(std::string_view name) {
+        if (!current_.empty()) end_result();
+        current_ = quote("name") + ": " + quote(name);
+    }
+    void field(std::string_view key, double value) { current_ += ", " + quote(key) + ": " + number(value); }
+    void field(std::string_view key, std::string_view value) { current_ += ", " + quote(key) + ": " + quote(value); }
+
+    /// Append count, mean, percentiles and max (all in nanoseconds) of @p h.
+    void histogram(const HdrHistogram& h) {
+        field("count", static_cast<double>(h.count()));
+        field("mean_ns", h.mean());
+        for (double p : kPercentiles) {
+            std::string key = "p" + number(p) + "_ns";
+            field(key, static_cast<double>(h.percentile(p)));
+        }
+        field("max_ns", static_cast<double>(h.max()));
+    }
+
+    void write(std::ostream& os) {
+        if (!current_.empty()) end_result();
+        os << "{\n  \"benchmark\": " << quote(benchmark_) << ",\n  \"context\": {" << context_ << "},\n  \"results\": [\n";
+        for (std::size_t i = 0; i < results_.size(); ++i) {
+            os << "    {" << results_[i] << '}' << (i + 1 < results_.size() ? ",\n" : "\n");
+        }
+        os << "  ]\n}\n";
+    }
+
+private:
+    void end_result() {
+        results_.push_back(std::move(current_));
+        current_.clear();
+    }
+    static std::string sep(const std::string& s) { return s.empty() ? "" : ", "; }
+    static std::string quote(std::string_view s) { return '"' + std::string(s) + '"'; }
+    static std::string number(double v) {
+        char buf[32];
+        std::snprintf(buf, sizeof(buf), "%.15g", v);
+        return buf;
+    }
+
+    std::string benchmark_;
+    std::string context_;
+    std::string current_;
+    std::vector<std::string> results_;
+};
+
+} // namespace bench
@@ -0,0 +1,116 @@
+#include "EngineHarness.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct Options {
+    std::size_t                events{200'000};
+    std::vector<std::uint32_t> symbol_counts{1, 10, 1000};
+    std::size_t                producers{2};
+    std::vector<double>        loads{0.1, 0.25, 0.5, 0.75, 0.9};
+    std::string                json_path;
+};
+
+std::vector<std::uint32_t> parse_list(const char* text) {
+    std::vector<std::uint32_t> out;
+    std::stringstream ss(text);
+    std::string item;
+    while (std::getline(ss, item, ',')) out.push_back(static_cast<std::uint32_t>(std::strtoul(item.c_str(), nullptr, 10)));
+    return out;
+}
+
+Options parse_options(int argc, char** argv) {
+    Options opts;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--events" && i + 1 < argc) {
+            opts.events = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--symbols" && i + 1 < argc) {
+            opts.symbol_counts = parse_list(argv[++i]);
+        } else if (arg == "--producers" && i + 1 < argc) {
+            opts.producers = std::max<std::size_t>(1, std::strtoull(argv[++i], nullptr, 10));
+        } else if (arg == "--loads" && i + 1 < argc) {
+            opts.loads.clear();
+            std::stringstream ss(argv[++i]);
+            std::string item;
+            while (std::getline(ss, item, ',')) opts.loads.push_back(std::strtod(item.c_str(), nullptr));
+        } else if (arg == "--json" && i + 1 < argc) {
+            opts.json_path = argv[++i];
+        } else {
+            std::cerr << "usage: " << argv[0] << " [--events N] [--symbols 1,10,1000] [--producers M]"
+                      << " [--loads 0.1,0.5,0.9] [--json <path>|-]\n";
+            std::exit(1);
+        }
+    }
+    return opts;
+}
+
+} // namespace
+
+/**
+ * End-to-end pipeline benchmark: producer threads call `EngineApp::submit` with
+ * pre-generated commands; latency runs from the send to the moment the resulting trade
+ * line leaves the logger thread. For each symbol count it measures saturation
+ * throughput, then replays at fractions of it to trace latency versus offered load.
+ */
+int main(int argc, char** argv) {
+    const Options opts = parse_options(argc, argv);
+    const bench::TscClock clock;
+
+    bench::JsonReport report("engine_bench");
+    report.context("events", static_cast<double>(opts.events));
+    report.context("producers", static_cast<double>(opts.producers));
+    report.context("hardware_threads", static_cast<double>(std::thread::hardware_concurrency()));
+
+    for (const auto symbols : opts.symbol_counts) {
+        if (symbols == 0) continue;
+        const auto producers = std::min<std::size_t>(opts.producers, symbols);
+        const bench::Workload w = bench::prepare(symbols, producers, opts.events);
+
+        const bench::RunResult saturated = bench::run(w, clock, 0.0);
+        const double peak = static_cast<double>(saturated.commands) / saturated.seconds;
+        std::cout << "\n" << symbols << " symbol(s), " << producers << " producer(s): saturation "
+                  << static_cast<std::uint64_t>(peak) << " commands/s, " << saturated.latency.count() << " trades\n";
+        bench::print_header(std::cout);
+        bench::print_row(std::cout, "saturated", saturated.latency);
+
+        const std::string prefix = std::to_string(symbols) + "sym/";
+        report.begin_result(prefix + "saturated");
+        report.field("symbols", static_cast<double>(symbols));
+        report.field("offered_per_sec", 0.0);
+        report.field("achieved_per_sec", peak);
+        report.histogram(saturated.latency);
+
+        for (const double load : opts.loads) {
+            const bench::RunResult r = bench::run(w, clock, peak * load);
+            const double achieved = static_cast<double>(r.commands) / r.seconds;
+            const std::string label = "load " + std::to_string(static_cast<int>(load * 100)) + "%";
+            bench::print_row(std::cout, label, r.latency);
+
+            report.begin_result(prefix + "load_" + std::to_string(static_cast<int>(load * 100)));
+            report.field("symbols", static_cast<double>(symbols));
+            report.field("offered_per_sec", peak * load);
+            report.field("achieved_per_sec", achieved);
+            report.histogram(r.latency);
+        }
+    }
+
+    if (opts.json_path == "-") {
+        report.write(std::cout);
+    } else if (!opts.json_path.empty()) {
+        std::ofstream out(opts.json_path);
+        if (!out) {
+            std::cerr << "cannot write " << opts.json_path << '\n';
+            return 1;
+        }
+        report.write(out);
+    }
+    return 0;
+}
@@ -0,0 +1,198 @@
+#pragma once
+
+#include "BenchUtil.h"
+#include "engine/Engine.h"
+#include "workload/OrderFlow.h"
+
+#include <unistd.h>
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace bench {
+
+/// One pre-built submission owned by a producer thread.
+struct Item {
+    std::uint32_t       symbol;
+    ob::types::OrderId  order;
+    engine::CommandRef  ref;
+};
+
+/**
+ * @brief Pre-generated stream for one symbol count, split by producer.
+ *
+ * Each symbol is owned by exactly one producer, because `EngineApp::submit` is
+ * single-producer. Client IDs are the generator's order IDs rendered once up front.
+ */
+struct Workload {
+    std::uint32_t                  symbols{0};
+    ob::types::Price               max_price{0};
+    std::size_t                    orders{0};
+    std::vector<std::string>       ids;
+    std::vector<std::vector<Item>> per_producer;
+};
+
+inline Workload prepare(std::uint32_t symbols, std::size_t producers, std::size_t events, double zipf_exponent = 1.1) {
+    workload::Config config;
+    config.seed          = 2024;
+    config.symbols       = symbols;
+    config.zipf_exponent = zipf_exponent;
+    config.start_mid     = 1'000;
+    config.max_distance  = 200;
+    workload::OrderFlow flow(config);
+    const auto stream = flow.generate(events);
+
+    Workload w;
+    w.symbols   = symbols;
+    w.max_price = flow.max_price();
+    for (const auto& e : stream) w.orders = std::max<std::size_t>(w.orders, e.order + 1);
+    w.ids.reserve(w.orders);
+    for (std::size_t i = 0; i < w.orders; ++i) w.ids.push_back(std::to_string(i));
+
+    w.per_producer.resize(producers);
+    for (const auto& e : stream) {
+        engine::CommandRef ref;
+        ref.id    = w.ids[e.order];
+        ref.side  = e.side;
+        ref.tif   = e.tif;
+        ref.price = e.price;
+        ref.qty   = e.quantity;
+        switch (e.action) {
+        case workload::Action::New:
+            ref.type = e.side == ob::types::Side::Buy ? engine::Command::Type::Buy : engine::Command::Type::Sell;
+            break;
+        case workload::Action::Cancel: ref.type = engine::Command::Type::Cancel; break;
+        case workload::Action::Amend: ref.type = engine::Command::Type::Modify; break;
+        }
+        w.per_producer[e.symbol % producers].push_back(Item{e.symbol, e.order, ref});
+    }
+    return w;
+}
+
+/// Per-engine trade observer running on that engine's logger thread.
+struct Probe {
+    const TscClock*                                clock{nullptr};
+    const std::vector<std::atomic<std::uint64_t>>* sent{nullptr};
+    HdrHistogram                                   latency;
+
+    static void on_line(std::string_view line, void* ctx) {
+        auto& self = *static_cast<Probe*>(ctx);
+        const auto now = TscClock::now();
+        // "<sym> TRADE <resting> <px> <qty> <incoming> <px> <qty>": field 5 is the aggressor.
+        std::size_t pos = 0;
+        for (int field = 0; field < 5 && pos != std::string_view::npos; ++field) pos = line.find(' ', pos + 1);
+        if (pos == std::string_view::npos) return;
+        ob::types::OrderId incoming = 0;
+        const char* begin = line.data() + pos + 1;
+        if (std::from_chars(begin, line.data() + line.size(), incoming).ec != std::errc{}) return;
+        if (incoming >= self.sent->size()) return;
+        self.latency.record(self.clock->to_ns(now - (*self.sent)[incoming].load(std::memory_order_relaxed)));
+    }
+};
+
+/**
+ * @brief Heap bytes currently allocated by this process.
+ *
+ * Uses glibc's allocator accounting, which unlike RSS does not depend on whether
+ * earlier runs left freed pages behind; elsewhere falls back to resident set size.
+ * Thread stacks are not included either way.
+ */
+inline std::size_t heap_bytes() {
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+    const struct mallinfo2 info = ::mallinfo2();
+    return info.uordblks + info.hblkhd;
+#else
+    std::FILE* f = std::fopen("/proc/self/statm", "r");
+    if (!f) return 0;
+    unsigned long size = 0, resident = 0;
+    const int read = std::fscanf(f, "%lu %lu", &size, &resident);
+    std::fclose(f);
+    return read == 2 ? resident * static_cast<std::size_t>(::sysconf(_SC_PAGESIZE)) : 0;
+#endif
+}
+
+struct RunResult {
+    double       seconds{0.0};
+    std::size_t  commands{0};
+    HdrHistogram latency; ///< One sample per trade line.
+    std::size_t  idle_memory{0};   ///< Heap growth from constructing the engines, before any traffic.
+    std::size_t  loaded_memory{0}; ///< Heap growth once every command has been submitted.
+};
+
+/**
+ * @brief Replay @p w through one fresh `EngineApp` per symbol.
+ * @param rate Offered load in commands per second across all producers; 0 = unthrottled.
+ *
+ * Latency is measured from the scheduled send time, not the actual one, so a producer
+ * held back by a full ingress ring is charged for the wait (no coordinated omission).
+ */
+inline RunResult run(const Workload& w, const TscClock& clock, double rate) {
+    const std::size_t pool = std::max<std::size_t>(1'024, 65'536 / w.symbols);
+    RunResult result;
+    const std::size_t heap_before = heap_bytes();
+    const auto heap_growth = [heap_before] {
+        const std::size_t now = heap_bytes();
+        return now > heap_before ? now - heap_before : 0;
+    };
+
+    std::vector<std::unique_ptr<engine::EngineApp>> engines;
+    std::vector<std::unique_ptr<Probe>> probes;
+    std::vector<std::atomic<std::uint64_t>> sent(w.orders); // amends re-stamp while loggers read
+    engines.reserve(w.symbols);
+    for (std::uint32_t s = 0; s < w.symbols; ++s) {
+        engines.push_back(std::make_unique<engine::EngineApp>(workload::OrderFlow::symbol_name(s), 0, w.max_price, pool));
+        auto probe = std::make_unique<Probe>();
+        probe->clock = &clock;
+        probe->sent  = &sent;
+        engines.back()->set_output_sink(&Probe::on_line, probe.get());
+        probes.push_back(std::move(probe));
+    }
+    result.idle_memory = heap_growth();
+
+    const double producers = static_cast<double>(w.per_producer.size());
+    const auto interval = rate > 0.0 ? static_cast<std::uint64_t>(producers * 1e9 / rate / clock.ns_per_tick()) : 0;
+    std::atomic<bool> go{false};
+    std::vector<std::thread> threads;
+    for (const auto& items : w.per_producer) {
+        threads.emplace_back([&, interval] {
+            while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+            const auto start = TscClock::now();
+            for (std::size_t i = 0; i < items.size(); ++i) {
+                const Item& item = items[i];
+                std::uint64_t stamp;
+                if (interval) {
+                    stamp = start + i * interval;
+                    while (TscClock::now() < stamp) {}
+                } else {
+                    stamp = TscClock::now();
+                }
+                if (item.ref.type != engine::Command::Type::Cancel) sent[item.order].store(stamp, std::memory_order_relaxed);
+                engines[item.symbol]->submit(item.ref);
+            }
+        });
+    }
+
+    const auto begin = std::chrono::steady_clock::now();
+    go.store(true, std::memory_order_release);
+    for (auto& t : threads) t.join();
+    result.loaded_memory = heap_growth();
+    engines.clear(); // drains every ingress and log queue before returning
+    const auto end = std::chrono::steady_clock::now();
+
+    result.seconds = std::chrono::duration<double>(end - begin).count();
+    for (const auto& items : w.per_producer) result.commands += items.size();
+    for (const auto& probe : probes) result.latency.add(probe->latency);
+    return result;
+}
+
+} // namespace bench
@@ -0,0 +1,193 @@
+#include "BenchUtil.h"
+#include "orderbook/OrderBook.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+
+namespace {
+
+using ob::types::OrderId;
+using ob::types::Price;
+using ob::types::Side;
+using ob::types::TimeInForce;
+
+// Warm book: bids rest in [9000, 9500), asks in [10500, 11000); the gap in between is
+// where measured orders live so they never disturb the resting depth.
+constexpr Price kBidLow  = 9'000;
+constexpr Price kAskLow  = 10'500;
+constexpr Price kLevels  = 500;
+constexpr Price kGapLow  = 9'600;
+constexpr Price kGapHigh = 10'400;
+
+struct Options {
+    std::size_t iterations{200'000};
+    std::size_t depth{20};
+    int         cpu{0};
+    std::string json_path;
+};
+
+class Harness {
+public:
+    explicit Harness(const Options& opts)
+        : opts_(opts)
+        , book_(0, 20'000, opts.depth * kLevels * 2 + 64) {}
+
+    void warm() {
+        // Several orders per level so cancels and fills run through realistic FIFOs.
+        for (Price level = 0; level < kLevels; ++level) {
+            for (std::size_t i = 0; i < opts_.depth; ++i) {
+                book_.create_order(next_id_++, kBidLow + level, 1 + i % 7, Side::Buy, TimeInForce::GFD);
+                book_.create_order(next_id_++, kAskLow + level, 1 + i % 7, Side::Sell, TimeInForce::GFD);
+            }
+        }
+        // Fault in the index and pool slots the measured orders will use.
+        for (std::size_t i = 0; i < 4; ++i) {
+            book_.create_order(scratch_id(i), kGapLow, 1, Side::Buy, TimeInForce::GFD);
+            book_.cancel(scratch_id(i));
+        }
+    }
+
+    /// Passive GFD insert into the gap; removed again outside the timed region.
+    std::uint64_t insert(std::size_t i) {
+        const auto id = scratch_id(0);
+        const Price px = kGapLow + static_cast<Price>(rng_() % 200);
+        const auto start = bench::TscClock::now();
+        book_.create_order(id, px, 1 + i % 9, Side::Buy, TimeInForce::GFD);
+        const auto ticks = bench::TscClock::now() - start;
+        book_.cancel(id);
+        return ticks;
+    }
+
+    /// Cancel of an order sitting behind others at a warm level.
+    std::uint64_t cancel(std::size_t i) {
+        const auto id = scratch_id(1);
+        book_.create_order(id, kBidLow + static_cast<Price>(rng_() % kLevels), 1 + i % 9, Side::Buy, TimeInForce::GFD);
+        const auto start = bench::TscClock::now();
+        book_.cancel(id);
+        return bench::TscClock::now() - start;
+    }
+
+    /// Price/quantity amend of a resting order inside the gap.
+    std::uint64_t amend(std::size_t i) {
+        const auto id = scratch_id(2);
+        if (!book_.has_order(id)) book_.create_order(id, kGapLow, 5, Side::Buy, TimeInForce::GFD);
+        const Price px = kGapLow + static_cast<Price>(rng_() % 200);
+        const auto start = bench::TscClock::now();
+        book_.modify(id, Side::Buy, px, 1 + i % 9, TimeInForce::GFD);
+        return bench::TscClock::now() - start;
+    }
+
+    /// Marketable IOC that takes the liquidity parked inside the gap.
+    std::uint64_t ioc_sweep(std::size_t i) {
+        const auto resting = scratch_id(3);
+        const Price px = kGapHigh - static_cast<Price>(rng_() % 200);
+        const auto qty = 1 + i % 9;
+        book_.create_order(resting, px, qty, Side::Sell, TimeInForce::GFD);
+        const auto start = bench::TscClock::now();
+        book_.create_order(scratch_id(4), kGapHigh, qty, Side::Buy, TimeInForce::IOC);
+        return bench::TscClock::now() - start;
+    }
+
+    /// FOK that cannot be filled within its limit; the book is left untouched.
+    std::uint64_t fok_reject(std::size_t i) {
+        const Price px = kAskLow + static_cast<Price>(i % 8);
+        const auto start = bench::TscClock::now();
+        book_.create_order(scratch_id(5), px, 1'000'000, Side::Buy, TimeInForce::FOK);
+        return bench::TscClock::now() - start;
+    }
+
+private:
+    OrderId scratch_id(std::size_t slot) const noexcept { return opts_.depth * kLevels * 2 + 16 + slot; }
+
+    const Options&   opts_;
+    ob::OrderBook    book_;
+    OrderId          next_id_{0};
+    std::mt19937_64  rng_{42};
+};
+
+Options parse_options(int argc, char** argv) {
+    Options opts;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--iterations" && i + 1 < argc) {
+            opts.iterations = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--depth" && i + 1 < argc) {
+            opts.depth = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--cpu" && i + 1 < argc) {
+            opts.cpu = std::atoi(argv[++i]);
+        } else if (arg == "--json" && i + 1 < argc) {
+            opts.json_path = argv[++i];
+        } else {
+            std::cerr << "usage: " << argv[0] << " [--iterations N] [--depth N] [--cpu N] [--json <path>|-]\n";
+            std::exit(1);
+        }
+    }
+    if (opts.depth == 0) opts.depth = 1;
+    return opts;
+}
+
+} // namespace
+
+/**
+ * Per-operation latency distribution of the order book, timed with calibrated
+ * `rdtscp` and recorded into HDR histograms. The thread is pinned and the book warmed
+ * with `depth` orders on each of 500 levels per side before anything is measured.
+ */
+int main(int argc, char** argv) {
+    const Options opts = parse_options(argc, argv);
+    const bool pinned = bench::pin_thread(opts.cpu);
+    const bench::TscClock clock;
+
+    Harness harness(opts);
+    harness.warm();
+
+    struct Op {
+        const char* name;
+        std::uint64_t (Harness::*run)(std::size_t);
+    };
+    const Op ops[] = {
+        {"insert", &Harness::insert},
+        {"cancel", &Harness::cancel},
+        {"amend", &Harness::amend},
+        {"ioc_sweep", &Harness::ioc_sweep},
+        {"fok_reject", &Harness::fok_reject},
+    };
+
+    bench::JsonReport report("latency_bench");
+    report.context("iterations", static_cast<double>(opts.iterations));
+    report.context("depth_per_level", static_cast<double>(opts.depth));
+    report.context("pinned_cpu", pinned ? opts.cpu : -1);
+    report.context("ns_per_tick", clock.ns_per_tick());
+    report.context("timer_overhead_ticks", static_cast<double>(clock.overhead()));
+
+    std::cout << "ns/tick " << clock.ns_per_tick() << ", timer overhead " << clock.overhead() << " ticks"
+              << (pinned ? ", pinned to cpu " + std::to_string(opts.cpu) : std::string(", unpinned")) << '\n';
+    bench::print_header(std::cout);
+
+    bench::HdrHistogram hist;
+    for (const auto& op : ops) {
+        for (std::size_t i = 0; i < opts.iterations / 10; ++i) (harness.*op.run)(i);
+        hist.reset();
+        for (std::size_t i = 0; i < opts.iterations; ++i) {
+            hist.record(clock.to_ns((harness.*op.run)(i)));
+        }
+        bench::print_row(std::cout, op.name, hist);
+        report.begin_result(op.name);
+        report.histogram(hist);
+    }
+
+    if (opts.json_path == "-") {
+        report.write(std::cout);
+    } else if (!opts.json_path.empty()) {
+        std::ofstream out(opts.json_path);
+        if (!out) {
+            std::cerr << "cannot write " << opts.json_path << '\n';
+            return 1;
+        }
+        report.write(out);
+    }
+    return 0;
+}
@@ -1,3 +1,4 @@
+#include "PerfCounters.h"
 #include "orderbook/OrderBook.h"
 
 #include <chrono>
@@ -15,6 +16,9 @@ int main() {
     std::mt19937_64 rng{42};
     std::uniform_int_distribution<int> price_dist(95, 105);
 
+    // Counters span the whole loop, so they include the two clock reads per insert.
+    bench::PerfCounters perf;
+    perf.start();
     for (std::size_t i = 0; i < iters; ++i) {
         auto price = price_dist(rng);
         auto quantity = 1 + (i % 10);
@@ -28,9 +32,12 @@ int main() {
         samples.emplace_back(end - start);
     }
 
+    const auto counters = perf.stop();
+
     auto sum = std::chrono::nanoseconds::zero();
     for (auto ns : samples) sum += ns;
     auto mean = sum / samples.size();
     std::cout << "mean latency: " << mean.count() << " ns\n";
+    perf.print(std::cout, counters, static_cast<double>(iters));
     return 0;
 }
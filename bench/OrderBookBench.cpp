@@ -1,16 +1,56 @@
+#include "PerfCounters.h"
+#include "engine/Risk.h"
+#include "orderbook/BookSet.h"
 #include "orderbook/OrderBook.h"
+#include "workload/OrderFlow.h"
 
 #include <benchmark/benchmark.h>
 
+#include <memory>
+#include <random>
+#include <vector>
+
 namespace {
 constexpr ob::types::Price kMinPrice = 0;
 constexpr ob::types::Price kMaxPrice = 200'000;
 constexpr std::size_t      kPool     = 1'000'000;
+
+/// Hardware counters over the timed loop, published per operation as user counters.
+class CounterScope {
+public:
+    explicit CounterScope(benchmark::State& state) : state_(state) { perf_.start(); }
+
+    /// Mirror `PauseTiming`/`ResumeTiming` so untimed setup is not counted.
+    void pause() noexcept { perf_.pause(); }
+    void resume() noexcept { perf_.resume(); }
+
+    /// @param ops_per_iteration Operations performed by one benchmark iteration.
+    void publish(double ops_per_iteration = 1.0) {
+        const auto sample = perf_.stop();
+        if (!perf_.available()) {
+            state_.SetLabel("no hw counters");
+            return;
+        }
+        const double ops = static_cast<double>(state_.iterations()) * ops_per_iteration;
+        for (std::size_t i = 0; i < bench::PerfCounters::kEventCount; ++i) {
+            const auto event = static_cast<bench::PerfCounters::Event>(i);
+            if (sample[event] >= 0) state_.counters[bench::PerfCounters::name(event)] = sample[event] / ops;
+        }
+        if (sample[bench::PerfCounters::Cycles] > 0) {
+            state_.counters["ipc"] = sample[bench::PerfCounters::Instructions] / sample[bench::PerfCounters::Cycles];
+        }
+    }
+
+private:
+    benchmark::State&   state_;
+    bench::PerfCounters perf_;
+};
 }
 
 static void BM_Insert(benchmark::State& state) {
     ob::OrderBook book(kMinPrice, kMaxPrice, kPool);
     ob::types::OrderId order_id = 0;
+    CounterScope counters(state);
     for (auto _ : state) {
         benchmark::DoNotOptimize(book.create_order(order_id++,
                                                    100,
@@ -21,6 +61,7 @@ static void BM_Insert(benchmark::State& state) {
             book.cancel(order_id - 1);
         }
     }
+    counters.publish();
 }
 BENCHMARK(BM_Insert);
 
@@ -30,17 +71,52 @@ static void BM_Match(benchmark::State& state) {
     for (int i = 0; i < 5000; ++i) {
         book.create_order(id++, 100, 10, ob::types::Side::Sell, ob::types::TimeInForce::GFD);
     }
+    CounterScope counters(state);
     for (auto _ : state) {
         book.create_order(id++, 100, 10, ob::types::Side::Buy, ob::types::TimeInForce::IOC);
     }
+    counters.publish();
 }
 BENCHMARK(BM_Match);
 
+// Per-fill cost of the match loop with self-trade prevention off and on. Owners never
+// collide, so the enabled run pays for the owner check and nothing else. Each
+// iteration sweeps 1'024 one-lot sells; refilling the level is not timed.
+static void BM_MatchStp(benchmark::State& state) {
+    constexpr int kFills = 1'024;
+    ob::OrderBook book(kMinPrice, kMaxPrice, kFills + 16);
+    book.set_stp_mode(state.range(0) != 0 ? ob::types::StpMode::CancelResting : ob::types::StpMode::None);
+    ob::types::OrderId id = 0;
+    const auto refill = [&] {
+        for (int i = 0; i < kFills; ++i) {
+            ob::OrderSpec sell{id++, 100, 1, ob::types::Side::Sell, ob::types::TimeInForce::GFD};
+            sell.owner = 1;
+            book.create_order(sell);
+        }
+    };
+    refill();
+    CounterScope counters(state);
+    for (auto _ : state) {
+        ob::OrderSpec buy{id++, 100, kFills, ob::types::Side::Buy, ob::types::TimeInForce::GFD};
+        buy.owner = 2;
+        book.create_order(buy);
+        state.PauseTiming();
+        counters.pause();
+        refill();
+        counters.resume();
+        state.ResumeTiming();
+    }
+    counters.publish(kFills);
+    state.SetItemsProcessed(state.iterations() * kFills);
+}
+BENCHMARK(BM_MatchStp)->ArgName("stp")->Arg(0)->Arg(1);
+
 static void BM_Cancel(benchmark::State& state) {
     ob::OrderBook book(kMinPrice, kMaxPrice, kPool);
     ob::types::OrderId id = 0;
     std::vector<ob::types::OrderId> ids;
     ids.reserve(10'000);
+    CounterScope counters(state);
     for (auto _ : state) {
         for (int i = 0; i < 100; ++i) {
             auto current = id++;
@@ -51,7 +127,299 @@ static void BM_Cancel(benchmark::State& state) {
         for (auto cancel_id : ids) book.cancel(cancel_id);
         ids.clear();
     }
+    counters.publish(200.0); // 100 inserts + 100 cancels
 }
 BENCHMARK(BM_Cancel);
 
+static void BM_Restore(benchmark::State& state) {
+    const auto orders = static_cast<std::size_t>(state.range(0));
+    std::vector<char> image;
+    {
+        ob::OrderBook source(kMinPrice, kMaxPrice, orders);
+        for (std::size_t i = 0; i < orders; ++i) {
+            const auto side = (i & 1) ? ob::types::Side::Sell : ob::types::Side::Buy;
+            const ob::types::Price px = side == ob::types::Side::Buy ? 1'000 - static_cast<ob::types::Price>(i % 500)
+                                                                     : 1'001 + static_cast<ob::types::Price>(i % 500);
+            source.create_order(i, px, 10, side, ob::types::TimeInForce::GFD);
+        }
+        source.checkpoint(image);
+    }
+    CounterScope counters(state);
+    for (auto _ : state) {
+        state.PauseTiming();
+        counters.pause();
+        auto book = std::make_unique<ob::OrderBook>(kMinPrice, kMaxPrice, orders);
+        counters.resume();
+        state.ResumeTiming();
+        benchmark::DoNotOptimize(book->restore(image.data(), image.size()));
+        state.PauseTiming();
+        counters.pause();
+        book.reset();
+        counters.resume();
+        state.ResumeTiming();
+    }
+    counters.publish(static_cast<double>(orders));
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(orders));
+}
+BENCHMARK(BM_Restore)->Arg(1'000'000)->Unit(benchmark::kMillisecond);
+
+// End-of-day purge of day orders: one sweep (`bulk` = 1) versus a cancel per order.
+// One order in ten is GTT and must survive either way.
+static void BM_EndOfDay(benchmark::State& state) {
+    const auto orders = static_cast<std::size_t>(state.range(0));
+    const bool bulk   = state.range(1) != 0;
+    std::vector<char> image;
+    {
+        ob::OrderBook source(kMinPrice, kMaxPrice, orders);
+        for (std::size_t i = 0; i < orders; ++i) {
+            const auto side = (i & 1) ? ob::types::Side::Sell : ob::types::Side::Buy;
+            const ob::types::Price px = side == ob::types::Side::Buy ? 1'000 - static_cast<ob::types::Price>(i % 500)
+                                                                     : 1'001 + static_cast<ob::types::Price>(i % 500);
+            ob::OrderSpec spec{i, px, 10, side, i % 10 == 0 ? ob::types::TimeInForce::GTT : ob::types::TimeInForce::GFD};
+            spec.expire_at = 3'600'000'000'000;
+            source.create_order(spec);
+        }
+        source.checkpoint(image);
+    }
+    CounterScope counters(state);
+    for (auto _ : state) {
+        state.PauseTiming();
+        counters.pause();
+        auto book = std::make_unique<ob::OrderBook>(kMinPrice, kMaxPrice, orders);
+        book->restore(image.data(), image.size());
+        counters.resume();
+        state.ResumeTiming();
+        if (bulk) {
+            benchmark::DoNotOptimize(book->end_of_day());
+        } else {
+            for (std::size_t i = 0; i < orders; ++i) {
+                if (i % 10 != 0) book->cancel(i);
+            }
+        }
+        state.PauseTiming();
+        counters.pause();
+        book.reset();
+        counters.resume();
+        state.ResumeTiming();
+    }
+    counters.publish(static_cast<double>(orders));
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(orders));
+}
+BENCHMARK(BM_EndOfDay)->ArgNames({"orders", "bulk"})->Args({1'000'000, 1})->Args({1'000'000, 0})
+    ->Unit(benchmark::kMillisecond);
+
+// Kill switch for one owner holding a tenth of a 1M-order book (1'000 levels of 1'000),
+// quoting in runs of `run` consecutive orders: `mass_cancel` (`bulk` = 1) versus a
+// cancel per order.
+static void BM_MassCancel(benchmark::State& state) {
+    constexpr std::size_t levels = 1'000;
+    constexpr std::size_t per_level = 1'000;
+    const auto run  = static_cast<std::size_t>(state.range(0));
+    const bool bulk = state.range(1) != 0;
+    std::vector<char> image;
+    std::vector<ob::types::OrderId> owned;
+    {
+        ob::OrderBook source(kMinPrice, kMaxPrice, levels * per_level);
+        ob::types::OrderId id = 0;
+        for (std::size_t level = 0; level < levels; ++level) {
+            const auto side = (level & 1) ? ob::types::Side::Sell : ob::types::Side::Buy;
+            const auto offset = static_cast<ob::types::Price>(level / 2);
+            const ob::types::Price px = side == ob::types::Side::Buy ? 1'000 - offset : 1'001 + offset;
+            for (std::size_t pos = 0; pos < per_level; ++pos, ++id) {
+                ob::OrderSpec spec{id, px, 10, side, ob::types::TimeInForce::GFD};
+                if ((pos / run) % 10 == 0) {
+                    spec.owner = 7;
+                    owned.push_back(id);
+                }
+                source.create_order(spec);
+            }
+        }
+        source.checkpoint(image);
+    }
+    CounterScope counters(state);
+    for (auto _ : state) {
+        state.PauseTiming();
+        counters.pause();
+        auto book = std::make_unique<ob::OrderBook>(kMinPrice, kMaxPrice, levels * per_level);
+        book->restore(image.data(), image.size());
+        counters.resume();
+        state.ResumeTiming();
+        if (bulk) {
+            benchmark::DoNotOptimize(book->mass_cancel(7));
+        } else {
+            for (const auto id : owned) book->cancel(id);
+        }
+        state.PauseTiming();
+        counters.pause();
+        book.reset();
+        counters.resume();
+        state.ResumeTiming();
+    }
+    counters.publish(static_cast<double>(owned.size()));
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(owned.size()));
+}
+// Setup dwarfs the timed section, so pin the iteration count.
+BENCHMARK(BM_MassCancel)->ArgNames({"run", "bulk"})->Args({1, 1})->Args({1, 0})->Args({50, 1})->Args({50, 0})
+    ->Iterations(20)->Unit(benchmark::kMicrosecond);
+
+// Call auction over a 1M-order book, half bids and half asks spread across the same
+// 1'000 ticks so about half the quantity crosses. `execute` = 0 times only the
+// equilibrium search (depth gather, prefix-sum curves, reductions); 1 runs the uncross.
+static void BM_Uncross(benchmark::State& state) {
+    constexpr std::size_t orders = 1'000'000;
+    const bool execute = state.range(0) != 0;
+    std::vector<char> image;
+    {
+        ob::OrderBook source(kMinPrice, kMaxPrice, orders);
+        source.begin_auction();
+        for (std::size_t i = 0; i < orders; ++i) {
+            const auto side = (i & 1) ? ob::types::Side::Sell : ob::types::Side::Buy;
+            const auto px = static_cast<ob::types::Price>(500 + (i * 7'919) % 1'000);
+            source.create_order(i, px, 1 + static_cast<ob::types::Quantity>(i % 10), side,
+                                ob::types::TimeInForce::GFD);
+        }
+        source.checkpoint(image);
+    }
+    CounterScope counters(state);
+    for (auto _ : state) {
+        state.PauseTiming();
+        counters.pause();
+        auto book = std::make_unique<ob::OrderBook>(kMinPrice, kMaxPrice, orders);
+        book->restore(image.data(), image.size());
+        counters.resume();
+        state.ResumeTiming();
+        if (execute) {
+            benchmark::DoNotOptimize(book->uncross());
+        } else {
+            benchmark::DoNotOptimize(book->indicative_uncross());
+        }
+        state.PauseTiming();
+        counters.pause();
+        book.reset();
+        counters.resume();
+        state.ResumeTiming();
+    }
+    counters.publish();
+}
+// Setup dwarfs the timed section, so pin the iteration count.
+BENCHMARK(BM_Uncross)->ArgName("execute")->Arg(0)->Arg(1)->Iterations(20)->Unit(benchmark::kMicrosecond);
+
+// A primary-pegged group of `pegged` bids chasing a limit bid that steps between 1'000
+// and 1'001: each iteration moves the whole group up and back down again.
+static void BM_PegReprice(benchmark::State& state) {
+    const auto pegged = static_cast<std::size_t>(state.range(0));
+    ob::OrderBook book(kMinPrice, kMaxPrice, pegged + 16);
+    book.create_order(0, 1'000, 10, ob::types::Side::Buy, ob::types::TimeInForce::GFD);
+    book.create_order(1, 1'010, 10, ob::types::Side::Sell, ob::types::TimeInForce::GFD);
+    for (std::size_t i = 0; i < pegged; ++i) {
+        ob::OrderSpec spec{10 + i, 0, 1, ob::types::Side::Buy, ob::types::TimeInForce::GFD};
+        spec.peg = ob::types::PegType::Primary;
+        book.create_order(spec);
+    }
+    CounterScope counters(state);
+    for (auto _ : state) {
+        book.create_order(2, 1'001, 10, ob::types::Side::Buy, ob::types::TimeInForce::GFD);
+        book.cancel(2);
+    }
+    counters.publish(2.0); // two group moves
+}
+BENCHMARK(BM_PegReprice)->Arg(1'000)->Arg(100'000);
+
+// Per-order cost of the engine's pre-trade stage: quantity and notional limits, the
+// price collar and one account's open quantity read from a book holding `accounts`
+// owners. Orders cycle through a pre-drawn batch so the branch predictor cannot learn
+// the outcomes; a little under half of them fail one check or another.
+static void BM_RiskCheck(benchmark::State& state) {
+    const auto accounts = static_cast<ob::types::OwnerId>(state.range(0));
+    ob::OrderBook book(kMinPrice, kMaxPrice, accounts * 4 + 16);
+    for (ob::types::OwnerId owner = 1; owner <= accounts; ++owner) {
+        for (ob::types::OrderId j = 0; j < 4; ++j) {
+            const bool buy = (j & 1) == 0;
+            ob::OrderSpec spec{owner * 4 + j, buy ? 990 - static_cast<ob::types::Price>(j) : 1'010 + static_cast<ob::types::Price>(j), 10,
+                               buy ? ob::types::Side::Buy : ob::types::Side::Sell, ob::types::TimeInForce::GFD};
+            spec.owner = owner;
+            book.create_order(spec);
+        }
+    }
+    engine::RiskLimits limits;
+    limits.max_order_qty = 95;
+    limits.max_notional  = 90'000;
+    limits.collar_bps    = 100;
+    limits.max_open_qty  = 120;
+    engine::RiskGate gate(limits);
+    gate.set_reference(1'000);
+
+    struct Candidate {
+        ob::types::Price    price;
+        ob::types::Quantity qty;
+        ob::types::OwnerId  owner;
+    };
+    std::mt19937_64 rng{11};
+    std::vector<Candidate> batch(4'096);
+    for (auto& c : batch) {
+        c.price = 985 + static_cast<ob::types::Price>(rng() % 30);
+        c.qty   = 1 + static_cast<ob::types::Quantity>(rng() % 100);
+        c.owner = 1 + static_cast<ob::types::OwnerId>(rng() % accounts);
+    }
+
+    std::size_t i = 0;
+    CounterScope counters(state);
+    for (auto _ : state) {
+        const Candidate& c = batch[i++ & (batch.size() - 1)];
+        auto reason = gate.check_order(c.price, c.qty);
+        if (reason == engine::RejectReason::None) reason = gate.check_live(c.price, true, book.open_quantity(c.owner), c.qty);
+        benchmark::DoNotOptimize(reason);
+    }
+    counters.publish();
+}
+BENCHMARK(BM_RiskCheck)->ArgName("accounts")->Arg(16)->Arg(100'000);
+
+// Queue position of random orders in one level `depth` orders deep; the answer comes
+// from the order's snapshot and its level's counters, so depth should not matter.
+static void BM_QueueAhead(benchmark::State& state) {
+    const auto depth = static_cast<ob::types::OrderId>(state.range(0));
+    ob::OrderBook book(kMinPrice, kMaxPrice, depth + 16);
+    for (ob::types::OrderId id = 0; id < depth; ++id) {
+        book.create_order(id, 1'000, 10, ob::types::Side::Buy, ob::types::TimeInForce::GFD);
+    }
+    std::mt19937_64 rng{13};
+    std::vector<ob::types::OrderId> ids(4'096);
+    for (auto& id : ids) id = rng() % depth;
+
+    std::size_t i = 0;
+    CounterScope counters(state);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(book.queue_ahead(ids[i++ & (ids.size() - 1)]));
+    }
+    counters.publish();
+}
+BENCHMARK(BM_QueueAhead)->ArgName("depth")->Arg(16)->Arg(100'000);
+
+// Add and cancel on random symbols of a `BookSet` holding `symbols` books with a few
+// resting orders each; the pool and ID index are shared, so only the books' ladders,
+// which span just the prices seen, grow with the symbol count.
+static void BM_BookSetChurn(benchmark::State& state) {
+    const auto symbols = static_cast<std::uint32_t>(state.range(0));
+    ob::BookSet set(static_cast<std::size_t>(symbols) * 4 + 16);
+    ob::types::OrderId next_id = 0;
+    for (std::uint32_t s = 0; s < symbols; ++s) {
+        set.open(s);
+        set.create_order(s, ob::OrderSpec{next_id++, 990, 10, ob::types::Side::Buy, ob::types::TimeInForce::GFD});
+        set.create_order(s, ob::OrderSpec{next_id++, 1'010, 10, ob::types::Side::Sell, ob::types::TimeInForce::GFD});
+    }
+    std::mt19937_64 rng{17};
+    std::vector<std::uint32_t> picks(4'096);
+    for (auto& pick : picks) pick = static_cast<std::uint32_t>(rng() % symbols);
+
+    std::size_t i = 0;
+    CounterScope counters(state);
+    for (auto _ : state) {
+        const std::uint32_t symbol = picks[i++ & (picks.size() - 1)];
+        set.create_order(symbol, ob::OrderSpec{next_id, 995, 1, ob::types::Side::Buy, ob::types::TimeInForce::GFD});
+        set.cancel(next_id);
+    }
+    counters.publish(2.0); // one add, one cancel
+}
+BENCHMARK(BM_BookSetChurn)->ArgName("symbols")->Arg(16)->Arg(10'000);
+
 BENCHMARK_MAIN();
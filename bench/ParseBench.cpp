@@ -0,0 +1,148 @@
+#include "engine/BinaryProtocol.h"
+#include "engine/CommandParser.h"
+#include "engine/Engine.h"
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+
+namespace {
+
+constexpr std::size_t kLines = 100'000;
+
+/// Representative mix of order entry, cancel and modify lines across a few symbols.
+const std::string& command_text() {
+    static const std::string text = [] {
+        std::mt19937_64 rng{7};
+        const char* symbols[] = {"AAPL", "MSFT", "GOOG", "AMZN", "NVDA", "META", "TSLA", "NFLX"};
+        const char* tifs[] = {"GFD", "IOC", "FOK"};
+        std::string out;
+        out.reserve(kLines * 40);
+        for (std::size_t i = 0; i < kLines; ++i) {
+            const char* symbol = symbols[rng() % 8];
+            const auto roll = rng() % 10;
+            out += symbol;
+            if (roll < 6) {
+                out += (rng() & 1) ? " BUY " : " SELL ";
+                out += tifs[rng() % 3];
+                out += ' ' + std::to_string(95 + rng() % 10) + ' ' + std::to_string(1 + rng() % 100);
+                out += " ord" + std::to_string(i);
+                if (roll == 0) out += " MIN 5";
+            } else if (roll < 9) {
+                out += " CANCEL ord" + std::to_string(rng() % (i + 1));
+            } else {
+                out += " MODIFY ord" + std::to_string(rng() % (i + 1)) + " BUY 100 10";
+            }
+            out += '\n';
+        }
+        return out;
+    }();
+    return text;
+}
+
+/// The pre-parser CLI loop: getline, istringstream, string tokens and a string-keyed map.
+std::size_t legacy_parse(const std::string& text) {
+    std::unordered_map<std::string, int> engines;
+    std::istringstream input(text);
+    std::size_t commands = 0;
+    std::string line;
+    while (std::getline(input, line)) {
+        if (line.empty()) continue;
+        std::istringstream iss(line);
+        std::string symbol;
+        std::string verb;
+        if (!(iss >> symbol >> verb)) continue;
+        auto& engine = engines[symbol];
+        ++engine;
+
+        engine::Command cmd;
+        if (verb == "BUY" || verb == "SELL") {
+            std::string tif_text;
+            std::string client_id;
+            if (!(iss >> tif_text >> cmd.price >> cmd.qty >> client_id)) continue;
+            std::string token;
+            while (iss >> token) {
+                if (token == "MIN") {
+                    ob::types::Quantity m;
+                    if (iss >> m) cmd.min_qty = m;
+                }
+            }
+            cmd.id = client_id;
+        } else if (verb == "CANCEL" || verb == "MODIFY") {
+            std::string client_id;
+            if (!(iss >> client_id)) continue;
+            cmd.id = client_id;
+            if (verb == "MODIFY") {
+                std::string side_text;
+                if (!(iss >> side_text >> cmd.price >> cmd.qty)) continue;
+            }
+        }
+        benchmark::DoNotOptimize(cmd);
+        ++commands;
+    }
+    return commands;
+}
+
+} // namespace
+
+static void BM_LegacyParse(benchmark::State& state) {
+    const auto& text = command_text();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(legacy_parse(text));
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(kLines));
+    state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(text.size()));
+}
+BENCHMARK(BM_LegacyParse)->Unit(benchmark::kMillisecond);
+
+static void BM_CommandParser(benchmark::State& state) {
+    const auto& text = command_text();
+    engine::SymbolTable symbols;
+    engine::CommandParser parser(symbols);
+    for (auto _ : state) {
+        std::size_t commands = 0;
+        parser.parse(text.data(), text.size(), [&](std::uint32_t symbol, const engine::CommandRef& cmd) {
+            benchmark::DoNotOptimize(symbol);
+            benchmark::DoNotOptimize(cmd);
+            ++commands;
+        }, /*final=*/true);
+        benchmark::DoNotOptimize(commands);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(kLines));
+    state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(text.size()));
+}
+BENCHMARK(BM_CommandParser)->Unit(benchmark::kMillisecond);
+
+static void BM_BinaryParser(benchmark::State& state) {
+    const auto& text = command_text();
+    std::vector<char> binary;
+    {
+        engine::SymbolTable symbols;
+        engine::CommandParser parser(symbols);
+        engine::wire::BinaryEncoder encoder(symbols);
+        std::uint64_t next_id = 0;
+        parser.parse(text.data(), text.size(), [&](std::uint32_t symbol, const engine::CommandRef& cmd) {
+            encoder.encode(symbol, cmd, next_id++, binary);
+        }, /*final=*/true);
+    }
+
+    engine::SymbolTable symbols;
+    engine::wire::BinaryParser parser(symbols);
+    for (auto _ : state) {
+        std::size_t commands = 0;
+        parser.parse(binary.data(), binary.size(), [&](std::uint32_t symbol, const engine::CommandRef& cmd) {
+            benchmark::DoNotOptimize(symbol);
+            benchmark::DoNotOptimize(cmd);
+            ++commands;
+        });
+        benchmark::DoNotOptimize(commands);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(kLines));
+    state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(binary.size()));
+}
+BENCHMARK(BM_BinaryParser)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,168 @@
+#pragma once
+
+#include <array>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <ostream>
+#include <string>
+#include <utility>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace bench {
+
+/**
+ * @brief Hardware performance counters around a measured region via `perf_event_open`.
+ *
+ * Each event is opened on its own (user space only) so one unsupported
+ * event does not take the rest down with it; counts are scaled by enabled/running time
+ * when the kernel multiplexes. Where nothing can be opened (containers without a PMU,
+ * `perf_event_paranoid` too strict, non-Linux) `available()` is false, readings are
+ * negative and `unavailable_reason()` says why, so harnesses just print the reason.
+ *
+ * By default only the constructing thread is counted. `Scope::SpawnedThreads` also
+ * counts threads created after construction; their totals reach @ref stop once they
+ * have exited, so join them first.
+ */
+class PerfCounters {
+public:
+    enum Event : std::size_t { Cycles, Instructions, L1dMisses, LlcMisses, BranchMisses, DtlbMisses, kEventCount };
+
+    /// Counter totals for one region; negative entries were not measurable.
+    struct Sample {
+        std::array<double, kEventCount> values{};
+        double operator[](Event e) const noexcept { return values[e]; }
+    };
+
+    static constexpr const char* name(Event e) noexcept {
+        constexpr const char* names[] = {"cycles", "instructions", "l1d_misses", "llc_misses", "branch_misses", "dtlb_misses"};
+        return names[e];
+    }
+
+    enum class Scope { ThisThread, SpawnedThreads };
+
+    explicit PerfCounters(Scope scope = Scope::ThisThread) {
+#if defined(__linux__)
+        constexpr auto cache = [](std::uint64_t id, std::uint64_t op, std::uint64_t result) {
+            return id | (op << 8) | (result << 16);
+        };
+        const std::pair<std::uint32_t, std::uint64_t> config[kEventCount] = {
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+            {PERF_TYPE_HW_CACHE, cache(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_MISS)},
+            {PERF_TYPE_HW_CACHE, cache(PERF_COUNT_HW_CACHE_LL, PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_MISS)},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+            {PERF_TYPE_HW_CACHE, cache(PERF_COUNT_HW_CACHE_DTLB, PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_MISS)},
+        };
+        for (std::size_t i = 0; i < kEventCount; ++i) {
+            perf_event_attr attr{};
+            attr.size           = sizeof(attr);
+            attr.type           = config[i].first;
+            attr.config         = config[i].second;
+            attr.disabled       = 1;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv     = 1;
+            attr.inherit        = scope == Scope::SpawnedThreads;
+            attr.read_format    = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+            fds_[i] = static_cast<int>(::syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+            if (fds_[i] >= 0) {
+                ++opened_;
+            } else if (reason_.empty()) {
+                reason_ = std::string("perf_event_open: ") + std::strerror(errno);
+            }
+        }
+        if (opened_ > 0) reason_.clear();
+#else
+        (void)scope;
+        reason_ = "perf_event_open is Linux-only";
+#endif
+    }
+
+    ~PerfCounters() {
+#if defined(__linux__)
+        for (int fd : fds_) {
+            if (fd >= 0) ::close(fd);
+        }
+#endif
+    }
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    bool available() const noexcept { return opened_ > 0; }
+    const std::string& unavailable_reason() const noexcept { return reason_; }
+
+    /// Zero and start every counter.
+    void start() noexcept {
+        control(Control::Reset);
+        resume();
+    }
+    /// Stop counting without resetting (e.g. around untimed setup).
+    void pause() noexcept { control(Control::Disable); }
+    /// Continue counting after @ref pause.
+    void resume() noexcept { control(Control::Enable); }
+
+    /// Stop counting and return the totals since @ref start.
+    Sample stop() noexcept {
+        pause();
+        Sample sample;
+        sample.values.fill(-1.0);
+#if defined(__linux__)
+        for (std::size_t i = 0; i < kEventCount; ++i) {
+            std::uint64_t data[3] = {0, 0, 0}; // value, time enabled, time running
+            if (fds_[i] < 0 || ::read(fds_[i], data, sizeof(data)) != static_cast<ssize_t>(sizeof(data))) continue;
+            sample.values[i] = data[2] ? static_cast<double>(data[0]) * static_cast<double>(data[1]) / static_cast<double>(data[2])
+                                       : 0.0;
+        }
+#endif
+        return sample;
+    }
+
+    /// Print "name=value/op" for every measurable counter, or the unavailability reason.
+    void print(std::ostream& os, const Sample& sample, double ops) const {
+        if (!available()) {
+            os << "  (hardware counters unavailable: " << reason_ << ")\n";
+            return;
+        }
+        os << ' ';
+        for (std::size_t i = 0; i < kEventCount; ++i) {
+            if (sample.values[i] < 0) continue;
+            char buf[64];
+            std::snprintf(buf, sizeof(buf), " %s/op=%.2f", name(static_cast<Event>(i)), sample.values[i] / ops);
+            os << buf;
+        }
+        if (sample[Cycles] > 0 && sample[Instructions] >= 0) {
+            char buf[32];
+            std::snprintf(buf, sizeof(buf), " ipc=%.2f", sample[Instructions] / sample[Cycles]);
+            os << buf;
+        }
+        os << '\n';
+    }
+
+private:
+    enum class Control { Reset, Enable, Disable };
+
+    void control([[maybe_unused]] Control op) noexcept {
+#if defined(__linux__)
+        const unsigned long request = op == Control::Reset  ? PERF_EVENT_IOC_RESET
+                                    : op == Control::Enable ? PERF_EVENT_IOC_ENABLE
+                                                            : PERF_EVENT_IOC_DISABLE;
+        for (int fd : fds_) {
+            if (fd >= 0) ::ioctl(fd, request, 0);
+        }
+#endif
+    }
+
+    std::array<int, kEventCount> fds_{-1, -1, -1, -1, -1, -1};
+    std::size_t                  opened_{0};
+    std::string                  reason_;
+};
+
+} // namespace bench
@@ -0,0 +1,133 @@
+#include "EngineHarness.h"
+#include "PerfCounters.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct Options {
+    std::size_t                events{200'000};
+    std::vector<std::uint32_t> engines{1, 8, 64, 512};
+    std::vector<std::uint32_t> producers{1, 2, 4};
+    double                     zipf{1.1};
+    std::string                json_path;
+};
+
+std::vector<std::uint32_t> parse_list(const char* text) {
+    std::vector<std::uint32_t> out;
+    std::stringstream ss(text);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        const auto value = static_cast<std::uint32_t>(std::strtoul(item.c_str(), nullptr, 10));
+        if (value > 0) out.push_back(value);
+    }
+    return out;
+}
+
+Options parse_options(int argc, char** argv) {
+    Options opts;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--events" && i + 1 < argc) {
+            opts.events = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--engines" && i + 1 < argc) {
+            opts.engines = parse_list(argv[++i]);
+        } else if (arg == "--producers" && i + 1 < argc) {
+            opts.producers = parse_list(argv[++i]);
+        } else if (arg == "--zipf" && i + 1 < argc) {
+            opts.zipf = std::strtod(argv[++i], nullptr);
+        } else if (arg == "--json" && i + 1 < argc) {
+            opts.json_path = argv[++i];
+        } else {
+            std::cerr << "usage: " << argv[0] << " [--events N] [--engines 1,8,64,512] [--producers 1,2,4]"
+                      << " [--zipf S] [--json <path>|-]\n";
+            std::exit(1);
+        }
+    }
+    return opts;
+}
+
+} // namespace
+
+/**
+ * Scaling benchmark: N `EngineApp`s (one per symbol, so 2N engine threads) fed by M
+ * producer threads with Zipf-skewed symbol popularity, unthrottled. For every (N, M)
+ * pair it reports aggregate command and trade throughput, submit-to-trade latency
+ * percentiles, heap bytes per symbol, and hardware counters per trade summed over
+ * all threads, where LLC misses stand in for cross-core cache-line traffic between
+ * producers, workers and loggers.
+ */
+int main(int argc, char** argv) {
+    const Options opts = parse_options(argc, argv);
+    const bench::TscClock clock;
+
+    bench::JsonReport report("scaling_bench");
+    report.context("events", static_cast<double>(opts.events));
+    report.context("zipf_exponent", opts.zipf);
+    report.context("hardware_threads", static_cast<double>(std::thread::hardware_concurrency()));
+
+    std::cout << "hardware threads: " << std::thread::hardware_concurrency() << ", events per run: " << opts.events
+              << ", zipf " << opts.zipf << "\n";
+    for (const auto engines : opts.engines) {
+        for (const auto requested : opts.producers) {
+            // A symbol belongs to exactly one producer, so extra producers would idle.
+            const auto producers = std::min(requested, engines);
+            if (producers != requested && requested != opts.producers.front()) continue;
+            const bench::Workload w = bench::prepare(engines, producers, opts.events, opts.zipf);
+
+            bench::PerfCounters counters(bench::PerfCounters::Scope::SpawnedThreads);
+            counters.start();
+            const bench::RunResult r = bench::run(w, clock, 0.0);
+            const bench::PerfCounters::Sample sample = counters.stop();
+
+            const double commands_per_sec = static_cast<double>(r.commands) / r.seconds;
+            const double trades = static_cast<double>(r.latency.count());
+            const double trades_per_sec = trades / r.seconds;
+            const double idle_per_symbol = static_cast<double>(r.idle_memory) / engines;
+            const double loaded_per_symbol = static_cast<double>(r.loaded_memory) / engines;
+
+            std::cout << "\nN=" << engines << " engines, M=" << producers << " producers: "
+                      << static_cast<std::uint64_t>(commands_per_sec) << " commands/s, "
+                      << static_cast<std::uint64_t>(trades_per_sec) << " trades/s, heap/symbol "
+                      << static_cast<std::uint64_t>(idle_per_symbol / 1024) << " KiB idle, "
+                      << static_cast<std::uint64_t>(loaded_per_symbol / 1024) << " KiB loaded\n";
+            bench::print_header(std::cout);
+            bench::print_row(std::cout, "submit->trade", r.latency);
+            std::cout << "  counters per trade (all threads):";
+            counters.print(std::cout, sample, trades > 0 ? trades : 1.0);
+
+            report.begin_result("N" + std::to_string(engines) + "_M" + std::to_string(producers));
+            report.field("engines", static_cast<double>(engines));
+            report.field("producers", static_cast<double>(producers));
+            report.field("commands_per_sec", commands_per_sec);
+            report.field("trades_per_sec", trades_per_sec);
+            report.field("bytes_per_symbol_idle", idle_per_symbol);
+            report.field("bytes_per_symbol_loaded", loaded_per_symbol);
+            for (std::size_t e = 0; e < bench::PerfCounters::kEventCount; ++e) {
+                const auto event = static_cast<bench::PerfCounters::Event>(e);
+                if (sample[event] >= 0 && trades > 0) {
+                    report.field(std::string(bench::PerfCounters::name(event)) + "_per_trade", sample[event] / trades);
+                }
+            }
+            report.histogram(r.latency);
+        }
+    }
+
+    if (opts.json_path == "-") {
+        report.write(std::cout);
+    } else if (!opts.json_path.empty()) {
+        std::ofstream out(opts.json_path);
+        if (!out) {
+            std::cerr << "cannot write " << opts.json_path << '\n';
+            return 1;
+        }
+        report.write(out);
+    }
+    return 0;
+}
@@ -0,0 +1,133 @@
+#include "engine/ShmRing.h"
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+void report(const char* label, std::vector<std::int64_t>& samples) {
+    std::sort(samples.begin(), samples.end());
+    auto pct = [&](double p) {
+        return samples[static_cast<std::size_t>(p * static_cast<double>(samples.size() - 1))];
+    };
+    std::cout << label << " round trip (ns): p50=" << pct(0.50) << " p90=" << pct(0.90)
+              << " p99=" << pct(0.99) << " p99.9=" << pct(0.999) << " max=" << samples.back() << '\n';
+}
+
+/// Spin briefly, then yield so the benchmark stays usable on machines with few cores.
+template <typename Pred>
+void wait_until(Pred&& ready) {
+    for (unsigned spins = 0; !ready(); ++spins) {
+        if (spins > 64) std::this_thread::yield();
+    }
+}
+
+engine::wire::NewOrder sample_order(std::uint64_t id) {
+    engine::wire::NewOrder msg{};
+    msg.header    = engine::wire::make_header<engine::wire::NewOrder>(engine::wire::MessageType::NewOrder, 0);
+    msg.client_id = id;
+    msg.price     = 100;
+    msg.quantity  = 10;
+    return msg;
+}
+
+void bench_shm(std::size_t iterations) {
+    const std::string base = "/nanobook_bench_" + std::to_string(::getpid());
+    auto requests  = engine::shm::RingSegment::create(base + "_req", 1, 1024);
+    auto responses = engine::shm::RingSegment::create(base + "_rsp", 1, 1024);
+
+    const pid_t child = ::fork();
+    if (child == 0) {
+        // Echo process standing in for the engine: opens the segments by name like a peer would.
+        auto req = engine::shm::RingSegment::open(base + "_req");
+        auto rsp = engine::shm::RingSegment::open(base + "_rsp");
+        while (!req.shutdown_requested()) {
+            const auto n = req.drain(0, [&](const char* slot, std::size_t) {
+                const auto* header = reinterpret_cast<const engine::wire::MessageHeader*>(slot);
+                while (!rsp.try_push(0, slot, header->length)) std::this_thread::yield();
+            });
+            if (n == 0) std::this_thread::yield();
+        }
+        std::_Exit(0);
+    }
+
+    std::vector<std::int64_t> samples;
+    samples.reserve(iterations);
+    for (std::size_t i = 0; i < iterations; ++i) {
+        const auto msg = sample_order(i);
+        const auto start = clock_type::now();
+        while (!requests.try_push(0, msg)) std::this_thread::yield();
+        bool echoed = false;
+        wait_until([&] {
+            responses.drain(0, [&](const char*, std::size_t) { echoed = true; });
+            return echoed;
+        });
+        samples.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(clock_type::now() - start).count());
+    }
+    requests.request_shutdown();
+    ::waitpid(child, nullptr, 0);
+    report("shm ring", samples);
+}
+
+void bench_pipe(std::size_t iterations) {
+    int to_child[2];
+    int to_parent[2];
+    if (::pipe(to_child) != 0 || ::pipe(to_parent) != 0) {
+        std::cerr << "pipe() failed\n";
+        return;
+    }
+
+    const pid_t child = ::fork();
+    if (child == 0) {
+        ::close(to_child[1]);
+        ::close(to_parent[0]);
+        engine::wire::NewOrder msg{};
+        while (::read(to_child[0], &msg, sizeof(msg)) == static_cast<ssize_t>(sizeof(msg))) {
+            if (::write(to_parent[1], &msg, sizeof(msg)) != static_cast<ssize_t>(sizeof(msg))) break;
+        }
+        std::_Exit(0);
+    }
+    ::close(to_child[0]);
+    ::close(to_parent[1]);
+
+    std::vector<std::int64_t> samples;
+    samples.reserve(iterations);
+    for (std::size_t i = 0; i < iterations; ++i) {
+        auto msg = sample_order(i);
+        const auto start = clock_type::now();
+        if (::write(to_child[1], &msg, sizeof(msg)) != static_cast<ssize_t>(sizeof(msg))) break;
+        if (::read(to_parent[0], &msg, sizeof(msg)) != static_cast<ssize_t>(sizeof(msg))) break;
+        samples.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(clock_type::now() - start).count());
+    }
+    ::close(to_child[1]);
+    ::waitpid(child, nullptr, 0);
+    ::close(to_parent[0]);
+    if (!samples.empty()) report("pipe (stdin path)", samples);
+}
+
+} // namespace
+
+/**
+ * Two-process round-trip latency: a parent "gateway" sends a binary NewOrder and waits
+ * for a forked peer to echo it back, once over shared-memory rings and once over pipes
+ * (the transport behind the engine's stdin). Usage: shm_ring_bench [iterations]
+ */
+int main(int argc, char** argv) {
+    std::size_t iterations = 100'000;
+    if (argc > 1) iterations = std::strtoull(argv[1], nullptr, 10);
+    if (iterations == 0) return 0;
+
+    bench_shm(iterations);
+    bench_pipe(iterations);
+    return 0;
+}
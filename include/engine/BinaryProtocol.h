@@ -0,0 +1,299 @@
+#pragma once
+
+#include "engine/CommandParser.h"
+#include "engine/Engine.h"
+
+#include <bit>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace engine::wire {
+
+static_assert(std::endian::native == std::endian::little,
+              "wire structs are read in place and assume a little-endian host");
+
+/// Protocol revision carried in every @ref MessageHeader.
+inline constexpr std::uint8_t version = 1;
+
+/// Every message length is a multiple of this, keeping records naturally aligned.
+inline constexpr std::size_t alignment = 8;
+
+/// Upper bound (exclusive) on stream-local symbol indices accepted by a @ref SymbolDefinition.
+inline constexpr std::uint32_t max_symbols = 65536;
+
+/// Discriminator stored in @ref MessageHeader::type.
+enum class MessageType : std::uint8_t {
+    SymbolDefinition = 1,
+    NewOrder         = 2,
+    Cancel           = 3,
+    Modify           = 4,
+    Print            = 5,
+    MassCancel       = 6,
+};
+
+/// Bit flags stored in the `flags` field of order and mass-cancel messages.
+enum Flags : std::uint8_t {
+    HasMinQty = 1u << 0,
+    HasSide   = 1u << 1,
+    HasRange  = 1u << 2,
+};
+
+/**
+ * @brief Common 8-byte prefix of every message.
+ *
+ * `symbol` is a stream-local index bound to a name by an earlier
+ * @ref SymbolDefinition.
+ */
+struct MessageHeader {
+    std::uint16_t length{0};
+    MessageType   type{MessageType::Print};
+    std::uint8_t  version{wire::version};
+    std::uint32_t symbol{0};
+};
+
+/// Binds @ref MessageHeader::symbol to a name (up to 23 bytes).
+struct SymbolDefinition {
+    MessageHeader header;
+    std::uint8_t  name_length{0};
+    char          name[23]{};
+};
+
+/**
+ * @brief New limit order; `side` and `tif` hold `ob::types::Side` / `TimeInForce` values.
+ *
+ * A non-zero `owner` tags the order like `OWNER <n>`; zero leaves it untagged.
+ */
+struct NewOrder {
+    MessageHeader header;
+    std::uint64_t client_id{0};
+    std::int64_t  price{0};
+    std::int64_t  quantity{0};
+    std::int64_t  min_qty{0};
+    std::uint8_t  side{0};
+    std::uint8_t  tif{0};
+    std::uint8_t  flags{0};
+    std::uint8_t  reserved{0};
+    std::uint32_t owner{0};
+};
+
+/// Cancel a resting order by client ID.
+struct Cancel {
+    MessageHeader header;
+    std::uint64_t client_id{0};
+};
+
+/// Cancel/replace a resting order; TIF is inherited from the original order.
+struct Modify {
+    MessageHeader header;
+    std::uint64_t client_id{0};
+    std::int64_t  price{0};
+    std::int64_t  quantity{0};
+    std::int64_t  min_qty{0};
+    std::uint8_t  side{0};
+    std::uint8_t  flags{0};
+    std::uint8_t  reserved[6]{};
+};
+
+/// Request a book snapshot for the symbol.
+struct Print {
+    MessageHeader header;
+};
+
+/**
+ * @brief Cancel every live order tagged with `owner`, like `MASSCANCEL`.
+ *
+ * `side` applies only with @ref HasSide and the inclusive `low`/`high` range only
+ * with @ref HasRange.
+ */
+struct MassCancel {
+    MessageHeader header;
+    std::uint32_t owner{0};
+    std::uint8_t  side{0};
+    std::uint8_t  flags{0};
+    std::uint8_t  reserved[2]{};
+    std::int64_t  low{0};
+    std::int64_t  high{0};
+};
+
+static_assert(sizeof(MessageHeader) == 8);
+static_assert(sizeof(SymbolDefinition) == 32);
+static_assert(sizeof(NewOrder) == 48);
+static_assert(sizeof(Cancel) == 16);
+static_assert(sizeof(Modify) == 48);
+static_assert(sizeof(Print) == 8);
+static_assert(sizeof(MassCancel) == 32);
+static_assert(offsetof(NewOrder, owner) == 44, "owner must reuse the old reserved bytes");
+static_assert(std::is_trivially_copyable_v<NewOrder> && std::is_trivially_copyable_v<Modify>);
+
+/// @return Header for a message of type @p Msg addressed to @p symbol.
+template <typename Msg>
+MessageHeader make_header(MessageType type, std::uint32_t symbol) noexcept {
+    return MessageHeader{static_cast<std::uint16_t>(sizeof(Msg)), type, wire::version, symbol};
+}
+
+/**
+ * @brief Outcome of @ref decode.
+ *
+ * `Rejected` messages are well framed but carry invalid field values and can be
+ * skipped; `Invalid` means framing is lost.
+ */
+enum class DecodeStatus : std::uint8_t { Ok, NeedMore, Rejected, Invalid };
+
+/**
+ * @brief Validate the message at @p data without copying it.
+ *
+ * Checks alignment, version, declared length against the fixed size for the type,
+ * and that the whole message is present. On @c Ok the caller may cast the header
+ * pointer to the concrete message struct.
+ *
+ * @return Pointer to the header for `Ok` and `Rejected`, nullptr otherwise.
+ */
+const MessageHeader* decode(const char* data, std::size_t available, DecodeStatus& status) noexcept;
+
+/**
+ * @brief Appends wire messages for parsed commands.
+ *
+ * A @ref SymbolDefinition is emitted the first time each symbol index appears, using
+ * the indices of the supplied @ref SymbolTable as stream-local symbol numbers.
+ */
+class BinaryEncoder {
+public:
+    explicit BinaryEncoder(const SymbolTable& symbols) : symbols_(symbols) {}
+
+    /**
+     * @brief Encode @p cmd for @p symbol into @p out.
+     * @param client_id Numeric identifier replacing the textual client ID.
+     * @return False when the command has no binary form, the symbol name is too long,
+     *         or the index is at or above @ref max_symbols.
+     */
+    bool encode(std::uint32_t symbol, const CommandRef& cmd, std::uint64_t client_id, std::vector<char>& out);
+
+private:
+    const SymbolTable& symbols_;
+    std::size_t        defined_{0};
+};
+
+/**
+ * @brief Streaming decoder translating wire messages into @ref CommandRef views.
+ *
+ * Numeric client IDs are rendered into a stack buffer, and stream-local symbol indices
+ * are remapped to the caller's @ref SymbolTable, so decoding never allocates except
+ * when a new symbol is defined.
+ */
+class BinaryParser {
+public:
+    explicit BinaryParser(SymbolTable& symbols) : symbols_(symbols) {}
+
+    /**
+     * @brief Decode every complete message in a block.
+     *
+     * @param data Block start; must be 8-byte aligned.
+     * @param size Block length in bytes.
+     * @param sink Callable invoked as `sink(std::uint32_t symbol, const CommandRef&)`.
+     * @return Number of bytes consumed. A malformed stream consumes the whole block
+     *         and bumps @ref errors since framing cannot be recovered.
+     */
+    template <typename Sink>
+    std::size_t parse(const char* data, std::size_t size, Sink&& sink) {
+        std::size_t offset = 0;
+        while (offset < size) {
+            DecodeStatus status;
+            const MessageHeader* header = decode(data + offset, size - offset, status);
+            if (status == DecodeStatus::NeedMore) break;
+            if (status == DecodeStatus::Invalid) {
+                ++errors_;
+                return size;
+            }
+            offset += header->length;
+            if (status == DecodeStatus::Rejected) {
+                ++errors_;
+                continue;
+            }
+            dispatch(*header, sink);
+        }
+        return offset;
+    }
+
+    /// @return Number of malformed messages or unknown symbols encountered.
+    std::size_t errors() const noexcept { return errors_; }
+
+private:
+    template <typename Sink>
+    void dispatch(const MessageHeader& header, Sink& sink) {
+        if (header.type == MessageType::SymbolDefinition) {
+            define(reinterpret_cast<const SymbolDefinition&>(header));
+            return;
+        }
+        if (header.symbol >= remap_.size() || remap_[header.symbol] == SymbolTable::npos) {
+            ++errors_;
+            return;
+        }
+        const auto symbol = remap_[header.symbol];
+
+        CommandRef cmd;
+        char id_text[24];
+        auto set_id = [&](std::uint64_t client_id) {
+            auto [end, ec] = std::to_chars(id_text, id_text + sizeof(id_text), client_id);
+            cmd.id = std::string_view(id_text, static_cast<std::size_t>(end - id_text));
+        };
+
+        switch (header.type) {
+            case MessageType::NewOrder: {
+                const auto& msg = reinterpret_cast<const NewOrder&>(header);
+                const bool buy = msg.side == static_cast<std::uint8_t>(ob::types::Side::Buy);
+                cmd.type  = buy ? Command::Type::Buy : Command::Type::Sell;
+                cmd.side  = buy ? ob::types::Side::Buy : ob::types::Side::Sell;
+                cmd.tif   = static_cast<ob::types::TimeInForce>(msg.tif);
+                cmd.price = msg.price;
+                cmd.qty   = msg.quantity;
+                if (msg.flags & HasMinQty) cmd.min_qty = msg.min_qty;
+                cmd.owner = msg.owner;
+                set_id(msg.client_id);
+                break;
+            }
+            case MessageType::Cancel: {
+                const auto& msg = reinterpret_cast<const Cancel&>(header);
+                cmd.type = Command::Type::Cancel;
+                set_id(msg.client_id);
+                break;
+            }
+            case MessageType::Modify: {
+                const auto& msg = reinterpret_cast<const Modify&>(header);
+                cmd.type  = Command::Type::Modify;
+                cmd.side  = msg.side == static_cast<std::uint8_t>(ob::types::Side::Buy) ? ob::types::Side::Buy
+                                                                                        : ob::types::Side::Sell;
+                cmd.price = msg.price;
+                cmd.qty   = msg.quantity;
+                if (msg.flags & HasMinQty) cmd.min_qty = msg.min_qty;
+                set_id(msg.client_id);
+                break;
+            }
+            case MessageType::Print:
+                cmd.type = Command::Type::Print;
+                break;
+            case MessageType::MassCancel: {
+                const auto& msg = reinterpret_cast<const MassCancel&>(header);
+                cmd.type  = Command::Type::MassCancel;
+                cmd.owner = msg.owner;
+                if (msg.flags & HasSide) cmd.cancel_side = static_cast<ob::types::Side>(msg.side);
+                if (msg.flags & HasRange) cmd.cancel_range = ob::PriceRange{msg.low, msg.high};
+                break;
+            }
+            case MessageType::SymbolDefinition:
+                return;
+        }
+        sink(symbol, static_cast<const CommandRef&>(cmd));
+    }
+
+    void define(const SymbolDefinition& msg);
+
+    SymbolTable&               symbols_;
+    std::vector<std::uint32_t> remap_;
+    std::size_t                errors_{0};
+};
+
+} // namespace engine::wire
@@ -0,0 +1,99 @@
+#pragma once
+
+#include "engine/Engine.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace engine {
+
+/**
+ * @brief Maps symbol names to dense indices so dispatch is a vector lookup.
+ */
+class SymbolTable {
+public:
+    /// Sentinel returned by @ref find for unknown symbols.
+    static constexpr std::uint32_t npos = static_cast<std::uint32_t>(-1);
+
+    /// @return Index for @p name, assigning the next dense index on first sight.
+    std::uint32_t intern(std::string_view name);
+
+    /// @return Index for @p name, or @ref npos when it has never been interned.
+    std::uint32_t find(std::string_view name) const noexcept;
+
+    /// @return Original name for a previously interned @p index.
+    const std::string& name(std::uint32_t index) const { return names_[index]; }
+
+    /// @return Number of interned symbols.
+    std::size_t size() const noexcept { return names_.size(); }
+
+private:
+    std::unordered_map<std::string, std::uint32_t, TransparentStringHash, std::equal_to<>> index_;
+    std::vector<std::string> names_;
+};
+
+/**
+ * @brief In-place tokenizer for the line-oriented text protocol.
+ *
+ * The parser works directly on caller-owned blocks (read buffers or mmapped files):
+ * lines are located with `memchr`, tokens are `std::string_view`s into the block and
+ * numbers are decoded with `std::from_chars`. The only allocations happen when a new
+ * symbol is interned.
+ */
+class CommandParser {
+public:
+    explicit CommandParser(SymbolTable& symbols) : symbols_(symbols) {}
+
+    /**
+     * @brief Parse a single line (without the trailing newline).
+     *
+     * @param line   Input text; a trailing '\r' is ignored.
+     * @param symbol Receives the interned symbol index when the line names one.
+     * @param out    Receives the decoded command; views point into @p line.
+     * @return True when @p out holds a complete, well-formed command.
+     */
+    bool parse_line(std::string_view line, std::uint32_t& symbol, CommandRef& out);
+
+    /**
+     * @brief Parse every complete line in a block and forward it to @p sink.
+     *
+     * @param data  Block start.
+     * @param size  Block length in bytes.
+     * @param sink  Callable invoked as `sink(std::uint32_t symbol, const CommandRef&)`.
+     * @param final When true an unterminated trailing line is parsed as well.
+     * @return Number of bytes consumed; the caller carries the remainder into the
+     *         next block.
+     */
+    template <typename Sink>
+    std::size_t parse(const char* data, std::size_t size, Sink&& sink, bool final = false) {
+        std::size_t offset = 0;
+        CommandRef cmd;
+        std::uint32_t symbol = SymbolTable::npos;
+        while (offset < size) {
+            const void* hit = std::memchr(data + offset, '\n', size - offset);
+            if (!hit) break;
+            const auto end = static_cast<std::size_t>(static_cast<const char*>(hit) - data);
+            if (parse_line(std::string_view(data + offset, end - offset), symbol, cmd)) {
+                sink(symbol, static_cast<const CommandRef&>(cmd));
+            }
+            offset = end + 1;
+        }
+        if (final && offset < size) {
+            if (parse_line(std::string_view(data + offset, size - offset), symbol, cmd)) {
+                sink(symbol, static_cast<const CommandRef&>(cmd));
+            }
+            offset = size;
+        }
+        return offset;
+    }
+
+private:
+    SymbolTable& symbols_;
+};
+
+} // namespace engine
@@ -1,13 +1,23 @@
 #pragma once
 
+#include "engine/Instruments.h"
+#include "engine/Risk.h"
+#include "engine/SymbolStats.h"
+#include "orderbook/BookSet.h"
 #include "orderbook/OrderBook.h"
 #include "orderbook/SpscRingBuffer.h"
 
 #include <atomic>
+#include <deque>
 #include <iostream>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
 #include <optional>
 #include <thread>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 
@@ -17,16 +27,59 @@ namespace engine {
  * @brief Command submitted by the CLI layer into the per-symbol engine.
  */
 struct Command {
-    enum class Type { Buy, Sell, Cancel, Modify, Print };
+    enum class Type { Buy, Sell, Cancel, Modify, Print, Checkpoint, Stats, Time, EndOfDay, MassCancel, Auction, Uncross, Reject, Bars };
 
     Type type{Type::Print};
-    std::string id;
+    std::string id; ///< Client order ID, or the output path for Checkpoint and Bars commands.
     ob::types::OrderId internal_id{ob::types::invalid_order_id};
     ob::types::Price price{0};
     ob::types::Quantity qty{0};
     ob::types::Side side{ob::types::Side::Buy};
     ob::types::TimeInForce tif{ob::types::TimeInForce::GFD};
     std::optional<ob::types::Quantity> min_qty;
+    ob::types::OrderType order_type{ob::types::OrderType::Limit};
+    ob::types::Price stop_price{0};
+    ob::types::Quantity display{0}; ///< Iceberg slice size; 0 = fully displayed.
+    ob::types::Timestamp timestamp{0}; ///< Expiry for GTT orders, or the new book clock for Time commands.
+    ob::types::OwnerId owner{0}; ///< Session tag for new orders, or the owner a MassCancel targets; a dense account ID once queued.
+    ob::types::PegType peg{ob::types::PegType::None};
+    std::optional<ob::types::Side> cancel_side; ///< MassCancel side filter.
+    std::optional<ob::PriceRange> cancel_range; ///< MassCancel price filter.
+    RejectReason reject{RejectReason::None}; ///< Why a Reject command's order was turned away at ingress.
+    std::vector<char> ids; ///< Client-ID table serialised at submit for Checkpoint commands.
+    std::uint32_t lane{0}; ///< Symbol slot within a grouped engine; always 0 for a single-symbol one.
+};
+
+/**
+ * @brief Non-owning view of a command, produced by zero-copy parsers.
+ *
+ * String fields reference the caller's input buffer and only need to stay valid for
+ * the duration of @ref EngineApp::submit.
+ */
+struct CommandRef {
+    Command::Type type{Command::Type::Print};
+    std::string_view id; ///< Client order ID, or the output path for Checkpoint and Bars commands.
+    ob::types::Price price{0};
+    ob::types::Quantity qty{0};
+    ob::types::Side side{ob::types::Side::Buy};
+    ob::types::TimeInForce tif{ob::types::TimeInForce::GFD};
+    std::optional<ob::types::Quantity> min_qty;
+    ob::types::OrderType order_type{ob::types::OrderType::Limit};
+    ob::types::Price stop_price{0};
+    ob::types::Quantity display{0}; ///< Iceberg slice size; 0 = fully displayed.
+    ob::types::Timestamp timestamp{0}; ///< Expiry for GTT orders, or the new book clock for Time commands.
+    ob::types::OwnerId owner{0}; ///< Session tag for new orders, or the owner a MassCancel targets.
+    ob::types::PegType peg{ob::types::PegType::None};
+    std::optional<ob::types::Side> cancel_side; ///< MassCancel side filter.
+    std::optional<ob::PriceRange> cancel_range; ///< MassCancel price filter.
+};
+
+/// Hash enabling `std::string_view` lookups into string-keyed unordered maps.
+struct TransparentStringHash {
+    using is_transparent = void;
+    std::size_t operator()(std::string_view text) const noexcept {
+        return std::hash<std::string_view>{}(text);
+    }
 };
 
 /**
@@ -35,6 +88,10 @@ struct Command {
  * Incoming text commands are converted into @ref Command instances, queued in a
  * single-producer/single-consumer ring buffer, and processed deterministically
  * by a dedicated worker thread invoking @ref ob::OrderBook.
+ *
+ * A grouped engine hosts several symbols, called lanes, on the same three threads.
+ * Their books live in one @ref ob::BookSet and share its pool. Each lane keeps its
+ * own client IDs, tick, band, collar and statistics.
  */
 class EngineApp {
 public:
@@ -50,17 +107,157 @@ public:
                        ob::types::Price min_price = 0,
                        ob::types::Price max_price = 1'000'000,
                        std::size_t      pool_capacity = 1'000'000);
+
+    /**
+     * @brief Create an engine for @p symbol sized and priced from its reference data.
+     *
+     * The book runs in ticks of the instrument's tick size. Its ladders span the band
+     * and its pool holds the expected open interest. Client prices are divided into
+     * ticks in @ref submit and multiplied back in trade lines, snapshots and statistics.
+     * A limit or stop price that is not a multiple of the tick publishes `REJECT ...
+     * TICK`, and one outside the band publishes `REJECT ... BAND`. The matching
+     * policy is not applied here; see @ref set_stp_mode and @ref set_market_protection.
+     */
+    EngineApp(std::string symbol, const Instrument& instrument);
+
+    /**
+     * @brief Create a grouped engine with room for @p lanes symbols.
+     *
+     * Name each lane with @ref add_symbol before its first command. A lane's book is
+     * opened by the worker when its first command arrives, so idle lanes cost almost
+     * nothing. Checkpoints and @ref restore are not supported in this mode.
+     *
+     * @param pool_capacity Maximum number of live orders across all lanes.
+     */
+    EngineApp(std::uint32_t lanes, std::size_t pool_capacity);
     ~EngineApp();
 
+    /**
+     * @brief Name lane @p lane of a grouped engine and take its tick and band from @p instrument.
+     *
+     * Without an instrument the lane takes client prices as they are. Call it from the
+     * producer thread before the lane's first @ref submit. Returns false if @p lane is
+     * out of range.
+     */
+    bool add_symbol(std::uint32_t lane, std::string symbol, const Instrument* instrument = nullptr);
+
     /**
      * @brief Submit a command for processing.
      *
-     * Performs synchronous validation (ID mapping, duplicate checks) and enqueues
-     * the command for the worker thread. Returns false if validation fails.
+     * Maps client IDs synchronously and enqueues the command for the worker thread,
+     * which owns the book and drops duplicates or commands for orders no longer live.
+     * Owner tags are interned to dense account IDs here, so the book's per-owner arrays
+     * stay as small as the set of accounts seen.
+     * Returns false for cancels and modifies of never-seen client IDs, mass cancels of
+     * never-seen owners, and for orders and modifies failing a quantity or notional
+     * limit (see @ref set_risk_limits).
      */
     bool submit(Command cmd);
 
+    /**
+     * @brief Submit a parsed command without materialising temporary strings.
+     *
+     * Client IDs are resolved through a heterogeneous lookup; a string is only
+     * allocated the first time an ID is seen.
+     */
+    bool submit(const CommandRef& cmd) { return submit(0, cmd); }
+
+    /// Submit a parsed command for lane @p lane; returns false if the lane is out of range.
+    bool submit(std::uint32_t lane, const CommandRef& cmd);
+
+    /**
+     * @brief Load a checkpoint written by a `Checkpoint` command.
+     *
+     * Rebuilds the order book and the client-ID mapping. Must be called before the
+     * first @ref submit; returns false if the file is unreadable or malformed, or the
+     * engine is grouped.
+     */
+    bool restore(const std::string& path);
+
+    /// Callback receiving each published trade line (without trailing newline).
+    using output_sink_t = void(*)(std::string_view line, void* ctx);
+
+    /**
+     * @brief Redirect the logger's output from stdout to @p sink.
+     *
+     * The sink runs on the logger thread, after the trade has crossed the log queue, so
+     * it observes exactly what a downstream consumer would. Install it before the first
+     * @ref submit; the ingress and log queues then order the write before any call.
+     */
+    void set_output_sink(output_sink_t sink, void* ctx) noexcept {
+        output_sink_ = sink;
+        output_ctx_  = ctx;
+    }
+
+    /**
+     * @brief Install pre-trade limits for new orders and modifies.
+     *
+     * Quantity and notional are checked in @ref submit before an internal ID is
+     * assigned; the price collar and the per-account open quantity are checked on
+     * the worker against the book. The collar is centred on the last trade price, or
+     * the midpoint of the touch before the first trade, and is recomputed after each
+     * command rather than per order. Pegged, market and stop-market orders skip the
+     * collar, and pegged and market orders the notional check, as they carry no price
+     * of their own yet.
+     * A failed check publishes `<symbol> REJECT <client-id> <reason>` in command order
+     * and leaves the book untouched. The limits apply to every lane. Install before the
+     * first @ref submit.
+     */
+    void set_risk_limits(const RiskLimits& limits) noexcept;
+
+    /// Select @p lane's self-trade prevention policy; install before the lane's first @ref submit.
+    void set_stp_mode(ob::types::StpMode mode, std::uint32_t lane = 0) noexcept {
+        Lane& target = lanes_[lane];
+        target.stp = mode;
+        if (target.book) target.book->set_stp_mode(mode);
+    }
+
+    /**
+     * @brief Latest session statistics of @p lane's symbol (OHLC, volume, VWAP, touch and imbalance).
+     *
+     * Reads the snapshot the worker publishes after each command; callable from any
+     * thread, never blocks the worker and never touches the book.
+     */
+    SymbolStats market_stats(std::uint32_t lane = 0) const noexcept { return lanes_[lane].market_stats.read(); }
+
+    /// Set the sweep bound of protected market orders in ticks past the touch; install before the lane's first @ref submit.
+    void set_market_protection(ob::types::Price ticks, std::uint32_t lane = 0) noexcept {
+        Lane& target = lanes_[lane];
+        target.market_protection = ticks;
+        if (target.book) target.book->set_market_protection(ticks);
+    }
+
 private:
+    /// One symbol's state. Lanes are allocated up front and never move.
+    struct Lane {
+        std::string        symbol;
+        ob::types::Price   tick_size{1};
+        ob::types::Price   band_low{std::numeric_limits<ob::types::Price>::min()};  ///< In client prices.
+        ob::types::Price   band_high{std::numeric_limits<ob::types::Price>::max()};
+        ob::types::StpMode stp{ob::types::StpMode::None};
+        ob::types::Price   market_protection{0};
+        ob::OrderBook*     book{nullptr}; ///< Opened by the worker on the lane's first command when grouped.
+        RiskGate           risk;
+        SymbolStatsTracker market_stats;
+    };
+
+    /// Serialise the book on the worker thread and hand it to the writer with the ID table @p ids.
+    void take_checkpoint(const std::string& path, const std::vector<char>& ids);
+    /// Serialise the client-ID table below @p id_watermark and the account table (producer thread).
+    std::vector<char> serialise_ids(ob::types::OrderId id_watermark) const;
+    /// Hand the bars @p lane closed so far to a writer as raw @ref Bar records.
+    void export_bars(Lane& lane, const std::string& path);
+    /// Queue @p image of @p symbol for the writer thread, starting one if none is running;
+    /// never waits for I/O in flight.
+    void write_async(const std::string& symbol, const std::string& path, std::vector<char> image);
+    /// Writer thread body: writes queued images in order, records failures and exits once the queue is empty.
+    void run_writer();
+    /// Emit the error lines the writer recorded (logger thread).
+    void emit_write_errors();
+    /// Refresh @p lane's touch in its statistics and publish them (worker thread).
+    void publish_stats(Lane& lane) noexcept;
+    /// Return lane @p index, opening its book in the group first if needed (worker thread).
+    Lane& open_lane(std::uint32_t index);
     /// Worker thread body: drains ingress queue and forwards to the order book.
     void process();
     /// Logger thread body: flushes trade strings to stdout.
@@ -69,23 +266,58 @@ private:
     void on_trade(const ob::Trade& trade);
     /// Static adapter passed to @ref ob::OrderBook so it can invoke @ref on_trade.
     static void trade_sink(const ob::Trade& trade, void* ctx);
-    /// Map a client-supplied ID to an internal numeric identifier.
-    ob::types::OrderId assign_order_id(const std::string& client_id);
+    /// Key of @p client_id in @p lane's ID space; grouped lanes prefix their index (producer thread).
+    std::string_view id_key(std::uint32_t lane, std::string_view client_id);
+    /// Map a client-supplied ID, looked up by @p key, to an internal numeric identifier.
+    ob::types::OrderId assign_order_id(std::string_view key, std::string_view client_id);
     /// Lookup helper returning an internal ID when one exists.
-    std::optional<ob::types::OrderId> find_order_id(const std::string& client_id) const;
+    std::optional<ob::types::OrderId> find_order_id(std::string_view key) const;
+    /// Check @p price against @p lane's tick and band and convert it to ticks in place.
+    static RejectReason to_ticks(const Lane& lane, ob::types::Price& price) noexcept;
+    /// Push a validated command onto the ingress ring, spinning while it is full.
+    void enqueue(Command&& cmd);
     /// Resolve an internal ID back to the original client string.
     const std::string& to_client_id(ob::types::OrderId internal) const;
+    /// Deliver one log line to the installed sink or stdout.
+    void emit(const std::string& line);
+    /// Collar and exposure checks for a new order or a modify (worker thread).
+    static RejectReason check_live(const Lane& lane, const Command& cmd) noexcept;
+    /// Re-centre @p lane's collar on its book's current reference price.
+    static void refresh_collar(Lane& lane) noexcept;
+    /// Queue a `REJECT` line for @p client_id of @p lane on the logger (worker thread).
+    void publish_reject(const Lane& lane, std::string_view client_id, RejectReason reason);
+    /// Hand a formatted line to the logger thread, spinning while its queue is full.
+    void publish(std::string line);
 
     std::atomic<bool> running_{true};
-    std::string                 symbol_;
-    ob::OrderBook               book_;
+    std::atomic<bool> worker_done_{false};
+    /// A file image waiting for the writer thread. The queue is declared ahead of the threads that use it.
+    struct WriteJob {
+        std::string       symbol;
+        std::string       path;
+        std::vector<char> image;
+    };
+    std::mutex                  write_mutex_;
+    std::deque<WriteJob>        writes_;
+    bool                        writer_running_{false}; ///< A writer thread is draining @ref writes_.
+    std::vector<std::string>    write_errors_;      ///< Guarded by write_mutex_; drained by the logger.
+    std::atomic<bool>           write_failed_{false};
+    std::vector<Lane>              lanes_;
+    std::unique_ptr<ob::OrderBook> book_;  ///< Lane 0's book of a single-symbol engine.
+    std::unique_ptr<ob::BookSet>   books_; ///< Books of a grouped engine, opened on demand.
+    Lane*                          current_{nullptr}; ///< Lane of the command in progress, for @ref on_trade.
     ob::SpscRingBuffer<Command> ingress_;
     std::thread                 worker_;
     ob::SpscRingBuffer<std::string> log_queue_;
     std::thread                 log_thread_;
-    std::unordered_map<std::string, ob::types::OrderId> id_lookup_;
+    std::thread                 checkpoint_writer_; ///< Started by @ref write_async; guarded by write_mutex_.
+    std::unordered_map<std::string, ob::types::OrderId, TransparentStringHash, std::equal_to<>> id_lookup_;
     std::vector<std::string>                         id_reverse_;
+    std::string                                      id_key_; ///< Scratch buffer for grouped lookup keys.
+    AccountTable                                     accounts_; ///< Owner tags seen by @ref submit.
     ob::types::OrderId                               next_internal_id_{0};
+    output_sink_t                                    output_sink_{nullptr};
+    void*                                            output_ctx_{nullptr};
 };
 
 } // namespace engine
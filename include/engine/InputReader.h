@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace engine::io {
+
+/**
+ * @brief Reads many file descriptors concurrently and hands each source's bytes to a
+ *        parser in place.
+ *
+ * Every source owns one page-aligned buffer. With io_uring the buffers are registered
+ * once and filled with `IORING_OP_READ_FIXED`, one read in flight per source; when
+ * io_uring is unavailable (old kernel, seccomp, memlock limits) the reader falls back
+ * to non-blocking reads driven by epoll, servicing regular files round-robin since
+ * they cannot be polled. Either way a slow pipe never stalls the other sources.
+ * Off Linux neither exists, and the sources are read one after another with
+ * blocking `read()`.
+ *
+ * The consumer sees `consume(source, data, size, final)` and returns how many bytes it
+ * used; the unconsumed tail (a partial line or message) is moved to the front of the
+ * buffer and the next read appends after it, so complete messages are never copied.
+ */
+class MultiSourceReader {
+public:
+    /// Which kernel interface drives the reads.
+    enum class Backend : std::uint8_t { IoUring, Epoll, Blocking };
+
+    /// Type-erased consumer: returns bytes consumed from @p data.
+    using consume_fn = std::size_t (*)(std::size_t source, const char* data, std::size_t size, bool final, void* ctx);
+
+    /**
+     * @param fds         Open descriptors to read; ownership stays with the caller.
+     * @param block_size  Per-source buffer size; bounds the longest message.
+     * @param allow_uring When false the epoll backend (blocking reads off Linux) is used unconditionally.
+     */
+    explicit MultiSourceReader(std::vector<int> fds, std::size_t block_size = 1 << 20, bool allow_uring = true);
+    ~MultiSourceReader();
+
+    MultiSourceReader(const MultiSourceReader&) = delete;
+    MultiSourceReader& operator=(const MultiSourceReader&) = delete;
+
+    /// @return Backend selected at construction.
+    Backend backend() const noexcept { return backend_; }
+
+    /// Read every source to EOF, invoking @p consume with each source's bytes.
+    void run(consume_fn consume, void* ctx);
+
+    /// Convenience overload accepting any callable with the @ref consume_fn signature.
+    template <typename Fn>
+    void run(Fn& fn) {
+        run([](std::size_t source, const char* data, std::size_t size, bool final, void* ctx) -> std::size_t {
+            return (*static_cast<Fn*>(ctx))(source, data, size, final);
+        }, &fn);
+    }
+
+private:
+    struct Source {
+        int           fd{-1};
+        char*         buffer{nullptr};
+        std::size_t   pending{0};
+        std::uint64_t offset{0};
+        bool          seekable{false};
+        bool          done{false};
+    };
+
+    struct Uring;
+    /// Defined beside @ref Uring so this header never needs the io_uring definitions.
+    struct UringDeleter {
+        void operator()(Uring* ring) const noexcept;
+    };
+
+    /// Feed newly read bytes to the consumer and compact the unconsumed tail.
+    void deliver(Source& src, std::size_t source, std::size_t got, consume_fn consume, void* ctx);
+    /// Flush the final partial message once a source reaches EOF.
+    void finish(Source& src, std::size_t source, consume_fn consume, void* ctx);
+    bool setup_uring();
+    void run_uring(consume_fn consume, void* ctx);
+    void run_epoll(consume_fn consume, void* ctx);
+    /// Portable fallback: drain each source to EOF in turn.
+    void run_blocking(consume_fn consume, void* ctx);
+
+    std::vector<Source> sources_;
+    std::size_t         block_size_;
+    Backend             backend_{Backend::Epoll};
+    std::unique_ptr<Uring, UringDeleter> uring_;
+};
+
+} // namespace engine::io
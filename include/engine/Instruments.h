@@ -0,0 +1,82 @@
+#pragma once
+
+#include "orderbook/Types.h"
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace engine {
+
+/// @return Number of whole @p tick steps at or below @p price; @p tick must be positive.
+constexpr ob::types::Price floor_ticks(ob::types::Price price, ob::types::Price tick) noexcept {
+    return price / tick - (price % tick != 0 && price < 0 ? 1 : 0);
+}
+
+/// @return Number of whole @p tick steps at or above @p price; @p tick must be positive.
+constexpr ob::types::Price ceil_ticks(ob::types::Price price, ob::types::Price tick) noexcept {
+    return price / tick + (price % tick != 0 && price > 0 ? 1 : 0);
+}
+
+/// Widest band, in ticks, an instrument file may give a symbol; ten times the default window.
+inline constexpr ob::types::Price max_band_ticks = 10'000'000;
+
+/**
+ * @brief Reference data of one symbol, as read from an instrument file.
+ *
+ * Prices are in the units clients send. The book works in ticks of @ref tick_size, so
+ * its ladders hold one level per tick of the band.
+ */
+struct Instrument {
+    ob::types::Price tick_size{1};             ///< Accepted prices are multiples of it.
+    ob::types::Price min_price{0};             ///< Lowest accepted price.
+    ob::types::Price max_price{1'000'000};     ///< Highest accepted price.
+    std::size_t      open_interest{1'000'000}; ///< Expected live orders; sizes the order pool.
+    std::optional<ob::types::StpMode> stp;     ///< Overrides the command-line policy when set.
+    std::optional<ob::types::Price>   market_protection; ///< Overrides the command-line bound when set, in ticks.
+
+    /// @return Lowest accepted price in ticks: the band rounded inwards.
+    ob::types::Price min_tick() const noexcept { return ceil_ticks(min_price, tick_size); }
+
+    /// @return Highest accepted price in ticks.
+    ob::types::Price max_tick() const noexcept { return floor_ticks(max_price, tick_size); }
+};
+
+/// @return Policy named @p name (`none`, `cancel-resting`, `cancel-incoming`, `decrement-both`), or nullopt.
+std::optional<ob::types::StpMode> parse_stp_mode(std::string_view name) noexcept;
+
+/**
+ * @brief Instruments by symbol, loaded once at startup.
+ *
+ * The file holds one symbol per line followed by `key=value` fields, any of which may
+ * be omitted to keep the default; `#` starts a comment:
+ *
+ *     # symbol  tick    band           open interest          policy
+ *     AAPL      tick=5  band=5000:20000 open-interest=50000   stp=cancel-resting market-protection=10
+ */
+class InstrumentTable {
+public:
+    /**
+     * @brief Parse @p path; throws `std::runtime_error` naming the line of the first bad entry.
+     *
+     * A band wider than @ref max_band_ticks ticks is an error, since the book
+     * allocates one ladder level per tick of it.
+     */
+    static InstrumentTable load(const std::string& path);
+
+    /// @return Reference data of @p symbol, or nullptr when the file does not list it.
+    const Instrument* find(const std::string& symbol) const {
+        auto it = instruments_.find(symbol);
+        return it == instruments_.end() ? nullptr : &it->second;
+    }
+
+    /// @return Number of symbols listed.
+    std::size_t size() const noexcept { return instruments_.size(); }
+
+private:
+    std::unordered_map<std::string, Instrument> instruments_;
+};
+
+} // namespace engine
@@ -0,0 +1,152 @@
+#pragma once
+
+#include "orderbook/Types.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace engine {
+
+/// Why a pre-trade check turned an order away; printed in `REJECT` lines.
+enum class RejectReason : std::uint8_t { None, Quantity, Notional, Collar, Exposure, Tick, Band };
+
+/// @return Reason code as printed in `REJECT` lines.
+constexpr const char* to_string(RejectReason reason) noexcept {
+    switch (reason) {
+        case RejectReason::Quantity: return "QTY";
+        case RejectReason::Notional: return "NOTIONAL";
+        case RejectReason::Collar:   return "COLLAR";
+        case RejectReason::Exposure: return "EXPOSURE";
+        case RejectReason::Tick:     return "TICK";
+        case RejectReason::Band:     return "BAND";
+        case RejectReason::None:     break;
+    }
+    return "NONE";
+}
+
+/**
+ * @brief Pre-trade limits for one symbol; zero disables a limit.
+ *
+ * Accounts are owner tags, interned to dense IDs by an @ref AccountTable at ingress:
+ * untagged orders are exempt from @ref max_open_qty.
+ */
+struct RiskLimits {
+    ob::types::Quantity max_order_qty{0}; ///< Largest quantity of one order.
+    std::int64_t        max_notional{0};  ///< Largest price × quantity of one order, at the price the client sent.
+    std::uint32_t       collar_bps{0};    ///< Furthest a limit price may sit from the reference, in basis points.
+    ob::types::Quantity max_open_qty{0};  ///< Largest live quantity per account, the new order included.
+};
+
+/**
+ * @brief Maps client owner tags to dense account IDs, as @ref SymbolTable does for names.
+ *
+ * Tags are any 32-bit value a client sends; books index their owner lists and open
+ * quantities by the dense ID, so those arrays grow with the number of accounts seen
+ * rather than with the largest tag. ID 0 stays "untagged".
+ */
+class AccountTable {
+public:
+    /// @return Dense ID for @p tag (0 for 0), assigning the next one on first sight.
+    ob::types::OwnerId intern(ob::types::OwnerId tag) {
+        if (tag == 0) return 0;
+        const auto [it, inserted] = index_.try_emplace(tag, static_cast<ob::types::OwnerId>(tags_.size()));
+        if (inserted) tags_.push_back(tag);
+        return it->second;
+    }
+
+    /// @return Dense ID for @p tag, or 0 when it has never been interned.
+    ob::types::OwnerId find(ob::types::OwnerId tag) const noexcept {
+        auto it = index_.find(tag);
+        return it == index_.end() ? 0 : it->second;
+    }
+
+    /// @return Client tag of the account with dense ID @p id.
+    ob::types::OwnerId tag(ob::types::OwnerId id) const noexcept { return tags_[id]; }
+
+    /// @return Number of interned accounts.
+    std::size_t size() const noexcept { return tags_.size() - 1; }
+
+private:
+    std::unordered_map<ob::types::OwnerId, ob::types::OwnerId> index_;
+    std::vector<ob::types::OwnerId> tags_{0}; ///< Indexed by dense ID; slot 0 is the untagged account.
+};
+
+/**
+ * @brief Compiled form of @ref RiskLimits evaluated on every order.
+ *
+ * Disabled limits are widened to the type maximum and the collar is kept as a
+ * precomputed band, so each check is a compare and a reason is picked with
+ * conditional moves rather than an early return per limit. Nothing allocates.
+ *
+ * The order checks only read the limits and may run on the ingress thread; the
+ * collar and exposure checks belong to the thread that owns the book.
+ */
+class RiskGate {
+public:
+    RiskGate() = default;
+
+    explicit RiskGate(const RiskLimits& limits) noexcept
+        : max_qty_(limits.max_order_qty > 0 ? limits.max_order_qty : kUnlimited)
+        , max_notional_(limits.max_notional > 0 ? limits.max_notional : kUnlimited)
+        , max_open_(limits.max_open_qty > 0 ? limits.max_open_qty : kUnlimited)
+        , collar_bps_(limits.collar_bps) {}
+
+    /// @return True when a collar is configured and needs a reference price.
+    bool collared() const noexcept { return collar_bps_ != 0; }
+
+    /**
+     * @brief Quantity and notional checks, which need no book state.
+     * @param price Price the notional is taken at, or 0 when the order has none yet.
+     */
+    RejectReason check_order(ob::types::Price price, ob::types::Quantity qty) const noexcept {
+        const __int128 notional = static_cast<__int128>(price) * qty;
+        const bool qty_bad      = qty > max_qty_;
+        const bool notional_bad = notional > max_notional_;
+        return qty_bad ? RejectReason::Quantity : notional_bad ? RejectReason::Notional : RejectReason::None;
+    }
+
+    /**
+     * @brief Collar and exposure checks against the current book.
+     * @param collared Whether @p price is a limit the collar applies to (not a peg or stop-market order).
+     * @param open     Live quantity the account already has, after anything this order replaces;
+     *                 read from the book's open-quantity array at the account's dense ID.
+     */
+    RejectReason check_live(ob::types::Price price, bool collared, ob::types::Quantity open, ob::types::Quantity qty) const noexcept {
+        // One unsigned compare tests both ends of the band.
+        const bool collar_bad   = collared && static_cast<std::uint64_t>(price) - static_cast<std::uint64_t>(low_) > width_;
+        const bool exposure_bad = qty > max_open_ - open;
+        return collar_bad ? RejectReason::Collar : exposure_bad ? RejectReason::Exposure : RejectReason::None;
+    }
+
+    /// Centre the collar on @p reference; without one every price passes.
+    void set_reference(std::optional<ob::types::Price> reference) noexcept {
+        if (reference == reference_) return;
+        reference_ = reference;
+        if (!reference || collar_bps_ == 0) {
+            low_   = std::numeric_limits<ob::types::Price>::min();
+            width_ = std::numeric_limits<std::uint64_t>::max();
+            return;
+        }
+        const ob::types::Price ref  = *reference < 0 ? -*reference : *reference;
+        const ob::types::Price band = static_cast<ob::types::Price>(static_cast<__int128>(ref) * collar_bps_ / 10'000);
+        low_   = *reference - band;
+        width_ = static_cast<std::uint64_t>(band) * 2;
+    }
+
+private:
+    static constexpr std::int64_t kUnlimited = std::numeric_limits<std::int64_t>::max();
+
+    ob::types::Quantity              max_qty_{kUnlimited};
+    std::int64_t                     max_notional_{kUnlimited};
+    ob::types::Quantity              max_open_{kUnlimited};
+    std::uint32_t                    collar_bps_{0};
+    ob::types::Price                 low_{std::numeric_limits<ob::types::Price>::min()};
+    std::uint64_t                    width_{std::numeric_limits<std::uint64_t>::max()};
+    std::optional<ob::types::Price>  reference_;
+};
+
+} // namespace engine
@@ -0,0 +1,199 @@
+#pragma once
+
+#include "engine/BinaryProtocol.h"
+#include "orderbook/Types.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace engine::shm {
+
+/// Segment signature ("OBSHMRNG").
+inline constexpr std::uint64_t magic = 0x474E524D4853424FULL;
+
+/// Layout revision; bumped whenever @ref SegmentHeader or @ref RingControl change.
+inline constexpr std::uint32_t version = 1;
+
+/// Bytes per slot; each slot carries exactly one binary-protocol message.
+inline constexpr std::size_t slot_size = 64;
+
+/**
+ * @brief First cache line of a segment.
+ *
+ * Segment layout (all offsets from the mapping base, everything 64-byte aligned):
+ *
+ *     [0, 64)                       SegmentHeader
+ *     64 + i * ring_stride          RingControl for ring i (128 bytes)
+ *     64 + i * ring_stride + 128    slot_count slots of slot_size bytes
+ *
+ * Each ring is single-producer/single-consumer: one gateway writes, the engine reads.
+ * `head` and `tail` are monotonically increasing message counters; the slot for
+ * counter @c n is `n & (slot_count - 1)`. The producer publishes with a release store
+ * of `head`, the consumer frees slots with a release store of `tail`, mirroring
+ * @ref ob::SpscRingBuffer.
+ */
+struct SegmentHeader {
+    std::uint64_t              magic{shm::magic};
+    std::uint32_t              version{shm::version};
+    std::uint32_t              ring_count{0};
+    std::uint32_t              slot_count{0};
+    std::uint32_t              slot_size{static_cast<std::uint32_t>(shm::slot_size)};
+    std::uint64_t              ring_stride{0};
+    std::atomic<std::uint32_t> shutdown{0};
+};
+
+/// Producer and consumer cursors, each on its own cache line.
+struct RingControl {
+    alignas(64) std::atomic<std::uint64_t> head{0};
+    alignas(64) std::atomic<std::uint64_t> tail{0};
+};
+
+static_assert(sizeof(SegmentHeader) <= 64);
+static_assert(sizeof(RingControl) == 128);
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free,
+              "cross-process rings require address-free atomics");
+static_assert(sizeof(wire::NewOrder) <= slot_size && sizeof(wire::Modify) <= slot_size);
+
+/**
+ * @brief Named POSIX shared-memory segment holding SPSC message rings.
+ *
+ * The engine creates the segment (`shm_open` + `ftruncate` + `mmap`) and removes the
+ * name on destruction; gateways open it by name. Construction failures throw
+ * `std::runtime_error`.
+ */
+class RingSegment {
+public:
+    /**
+     * @brief Create (or replace) segment @p name.
+     * @param name       POSIX shm name, e.g. "/nanobook".
+     * @param rings      Number of rings (one per symbol or shard).
+     * @param slot_count Slots per ring; must be a power of two >= 2.
+     */
+    static RingSegment create(const std::string& name, std::uint32_t rings, std::uint32_t slot_count);
+
+    /// Map an existing segment created by @ref create.
+    static RingSegment open(const std::string& name);
+
+    RingSegment(RingSegment&& other) noexcept;
+    RingSegment& operator=(RingSegment&&) = delete;
+    RingSegment(const RingSegment&) = delete;
+    RingSegment& operator=(const RingSegment&) = delete;
+    ~RingSegment();
+
+    /// @return Number of rings in the segment.
+    std::uint32_t ring_count() const noexcept { return header_->ring_count; }
+
+    /**
+     * @brief Copy one message into @p ring.
+     * @return False when the ring is full, the index is out of range or @p len exceeds a slot.
+     */
+    bool try_push(std::uint32_t ring, const void* msg, std::size_t len) noexcept;
+
+    /// Typed convenience wrapper around @ref try_push.
+    template <typename Msg>
+    bool try_push(std::uint32_t ring, const Msg& msg) noexcept {
+        return try_push(ring, &msg, sizeof(msg));
+    }
+
+    /**
+     * @brief Consume up to @p max messages from @p ring in place.
+     *
+     * @param fn Callable invoked as `fn(const char* slot, std::size_t slot_size)`; the
+     *           slot stays valid until @p fn returns.
+     * @return Number of messages consumed.
+     */
+    template <typename Fn>
+    std::size_t drain(std::uint32_t ring, Fn&& fn, std::size_t max = 256) noexcept {
+        RingControl& ctl = control(ring);
+        const auto tail = ctl.tail.load(std::memory_order_relaxed);
+        const auto head = ctl.head.load(std::memory_order_acquire);
+        auto count = static_cast<std::size_t>(head - tail);
+        if (count > max) count = max;
+        for (std::size_t i = 0; i < count; ++i) {
+            fn(slot(ring, tail + i), shm::slot_size);
+        }
+        if (count) ctl.tail.store(tail + count, std::memory_order_release);
+        return count;
+    }
+
+    /// Ask the consumer to exit once every ring is drained.
+    void request_shutdown() noexcept { header_->shutdown.store(1, std::memory_order_release); }
+
+    /// @return True after any participant called @ref request_shutdown.
+    bool shutdown_requested() const noexcept { return header_->shutdown.load(std::memory_order_acquire) != 0; }
+
+private:
+    RingSegment(std::string name, void* base, std::size_t size, bool owner) noexcept;
+
+    RingControl& control(std::uint32_t ring) const noexcept {
+        return *reinterpret_cast<RingControl*>(base_ + sizeof(SegmentHeader) + ring * header_->ring_stride);
+    }
+    char* slot(std::uint32_t ring, std::uint64_t counter) const noexcept {
+        return base_ + sizeof(SegmentHeader) + ring * header_->ring_stride + sizeof(RingControl)
+             + (counter & (header_->slot_count - 1)) * shm::slot_size;
+    }
+
+    std::string    name_;
+    char*          base_{nullptr};
+    SegmentHeader* header_{nullptr};
+    std::size_t    size_{0};
+    bool           owner_{false};
+};
+
+/**
+ * @brief Gateway-side helper that encodes binary-protocol messages into a segment.
+ *
+ * Each ring is an independent binary stream: define a symbol on a ring before sending
+ * orders for it there. Every call returns false when the target ring is full so the
+ * caller decides whether to spin, yield or drop.
+ */
+class IngressClient {
+public:
+    /// Attach to the segment published by an engine started with `--shm <name>`.
+    explicit IngressClient(const std::string& name) : segment_(RingSegment::open(name)) {}
+
+    bool define_symbol(std::uint32_t ring, std::uint32_t symbol, std::string_view name) noexcept;
+
+    bool new_order(std::uint32_t ring,
+                   std::uint32_t symbol,
+                   std::uint64_t client_id,
+                   ob::types::Side side,
+                   ob::types::TimeInForce tif,
+                   ob::types::Price price,
+                   ob::types::Quantity qty,
+                   std::optional<ob::types::Quantity> min_qty = std::nullopt,
+                   ob::types::OwnerId owner = 0) noexcept;
+
+    bool cancel(std::uint32_t ring, std::uint32_t symbol, std::uint64_t client_id) noexcept;
+
+    bool modify(std::uint32_t ring,
+                std::uint32_t symbol,
+                std::uint64_t client_id,
+                ob::types::Side side,
+                ob::types::Price price,
+                ob::types::Quantity qty,
+                std::optional<ob::types::Quantity> min_qty = std::nullopt) noexcept;
+
+    bool print(std::uint32_t ring, std::uint32_t symbol) noexcept;
+
+    bool mass_cancel(std::uint32_t ring,
+                     std::uint32_t symbol,
+                     ob::types::OwnerId owner,
+                     std::optional<ob::types::Side> side = std::nullopt,
+                     std::optional<ob::PriceRange> range = std::nullopt) noexcept;
+
+    /// Signal the engine to stop after draining every ring.
+    void shutdown() noexcept { segment_.request_shutdown(); }
+
+    /// @return Underlying segment for raw pushes.
+    RingSegment& segment() noexcept { return segment_; }
+
+private:
+    RingSegment segment_;
+};
+
+} // namespace engine::shm
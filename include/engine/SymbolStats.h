@@ -0,0 +1,111 @@
+#pragma once
+
+#include "orderbook/Seqlock.h"
+#include "orderbook/Types.h"
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace engine {
+
+/**
+ * @brief Session statistics of one symbol as last published by its worker.
+ *
+ * Prices are zero until the first trade (OHLC) or while a side is empty (quotes).
+ */
+struct alignas(64) SymbolStats {
+    ob::types::Price     open{0};
+    ob::types::Price     high{0};
+    ob::types::Price     low{0};
+    ob::types::Price     close{0};
+    ob::types::Quantity  volume{0};
+    double               notional{0}; ///< Sum of price × quantity over every trade.
+    std::uint64_t        trades{0};
+    ob::types::Price     bid{0};
+    ob::types::Quantity  bid_qty{0};  ///< Visible quantity at the best bid.
+    ob::types::Price     ask{0};
+    ob::types::Quantity  ask_qty{0};  ///< Visible quantity at the best ask.
+    ob::types::Timestamp updated_at{0}; ///< Book clock at publication.
+
+    /// @return Volume-weighted average price, or 0 before the first trade.
+    double vwap() const noexcept { return volume > 0 ? notional / static_cast<double>(volume) : 0.0; }
+
+    /// @return Top-of-book imbalance in [-1, 1]: positive when the bid holds more.
+    double imbalance() const noexcept {
+        const auto total = bid_qty + ask_qty;
+        return total > 0 ? static_cast<double>(bid_qty - ask_qty) / static_cast<double>(total) : 0.0;
+    }
+};
+
+/**
+ * @brief One closed OHLCV interval, written as-is by the `BARS` export.
+ *
+ * 64 bytes, little-endian. Intervals are aligned to multiples of their length on
+ * the book clock; an interval without trades produces no bar.
+ */
+struct Bar {
+    std::uint64_t       start{0};       ///< Book clock at the start of the interval, ns.
+    std::uint32_t       interval_ms{0}; ///< 1'000 or 60'000.
+    std::uint32_t       trades{0};
+    ob::types::Price    open{0};
+    ob::types::Price    high{0};
+    ob::types::Price    low{0};
+    ob::types::Price    close{0};
+    ob::types::Quantity volume{0};
+    double              notional{0};    ///< Sum of price × quantity; divide by volume for the VWAP.
+};
+static_assert(sizeof(Bar) == 64, "Bar is a fixed 64-byte export record");
+
+/**
+ * @brief Incremental statistics kept by a symbol's worker thread.
+ *
+ * Each trade updates the session figures and the open 1s and 1m bars in O(1);
+ * quotes are refreshed from the book's best levels after each command. The worker
+ * publishes a snapshot through a @ref ob::Seqlock, so any thread can @ref read it
+ * without locking and without touching the book. Bars roll on the book clock, which
+ * only moves with `TIME` commands, so replays produce the same bars.
+ */
+class SymbolStatsTracker {
+public:
+    SymbolStatsTracker() noexcept;
+
+    /// Account for a trade of @p qty at @p price at book time @p now (worker thread).
+    void on_trade(ob::types::Price price, ob::types::Quantity qty, ob::types::Timestamp now);
+
+    /// Record the visible touch; a missing side is passed as price 0, quantity 0 (worker thread).
+    void on_quote(ob::types::Price bid, ob::types::Quantity bid_qty,
+                  ob::types::Price ask, ob::types::Quantity ask_qty) noexcept {
+        current_.bid     = bid;
+        current_.bid_qty = bid_qty;
+        current_.ask     = ask;
+        current_.ask_qty = ask_qty;
+    }
+
+    /// Close every open bar whose interval ended before @p now (worker thread).
+    void roll(ob::types::Timestamp now);
+
+    /// Make the current figures visible to @ref read (worker thread).
+    void publish(ob::types::Timestamp now) noexcept {
+        current_.updated_at = now;
+        published_.store(current_);
+    }
+
+    /// @return The last published snapshot; safe from any thread.
+    SymbolStats read() const noexcept { return published_.load(); }
+
+    /// Bars closed since the last @ref take_bars, in the order they closed (worker thread).
+    std::vector<Bar> take_bars();
+
+private:
+    static constexpr std::array<std::uint32_t, 2> kIntervalsMs{1'000, 60'000};
+
+    void close(std::size_t slot);
+
+    SymbolStats                current_;
+    std::array<Bar, 2>         open_bars_{};
+    ob::Seqlock<SymbolStats>   published_;
+    std::vector<Bar>           closed_;
+};
+
+} // namespace engine
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "orderbook/OrderBook.h"
+#include "orderbook/Types.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace ob {
+
+/**
+ * @brief Many small order books driven from one thread, sharing one @ref OrderStore.
+ *
+ * Memory follows open interest rather than symbol count. Every book draws from one
+ * pool and one ID index, so a book only costs its ladders. Those start empty and
+ * grow to span the prices the book has seen, and the expiry wheel is only built for
+ * a book that receives a `GTT` order. Books are addressed by the dense symbol
+ * index that @ref engine::SymbolTable interns; commands that carry only an order ID
+ * are routed by the tag on the order. Not thread-safe.
+ */
+class BookSet {
+public:
+    /// @param pool_capacity Maximum number of live orders across all books.
+    explicit BookSet(std::size_t pool_capacity) : store_(pool_capacity) {}
+
+    /// Create the book for @p symbol, or return the one already open.
+    OrderBook& open(std::uint32_t symbol);
+
+    /// @return Book of @p symbol, or nullptr when it was never opened.
+    OrderBook* book(std::uint32_t symbol) noexcept {
+        return symbol < books_.size() ? books_[symbol].get() : nullptr;
+    }
+
+    /// @return Book holding live order @p id, or nullptr.
+    OrderBook* book_of(types::OrderId id) noexcept {
+        if (id >= store_.index.size() || !store_.index[id]) return nullptr;
+        return books_[store_.index[id]->book].get();
+    }
+
+    /**
+     * @brief Add an order to @p symbol's book; see @ref OrderBook::create_order.
+     *
+     * IDs are shared by every book, so one live in another book is a duplicate.
+     * @return nullptr as well when @p symbol has no open book.
+     */
+    Order* create_order(std::uint32_t symbol, const OrderSpec& spec) {
+        OrderBook* target = book(symbol);
+        return target ? target->create_order(spec) : nullptr;
+    }
+
+    /// Cancel order @p id in whichever book holds it (no-op if absent).
+    void cancel(types::OrderId id) {
+        if (OrderBook* owner = book_of(id)) owner->cancel(id);
+    }
+
+    /// Replace order @p id in whichever book holds it; see @ref OrderBook::modify.
+    void modify(types::OrderId id,
+                types::Side side,
+                types::Price price,
+                types::Quantity qty,
+                types::TimeInForce tif,
+                std::optional<types::Quantity> min_qty = std::nullopt) {
+        if (OrderBook* owner = book_of(id)) owner->modify(id, side, price, qty, tif, min_qty);
+    }
+
+    /// @return Number of books opened.
+    std::size_t size() const noexcept { return open_; }
+
+    /// @return Number of live orders across all books.
+    std::size_t live_orders() const noexcept { return store_.pool.capacity() - store_.pool.available(); }
+
+private:
+    OrderStore                              store_;
+    std::vector<std::unique_ptr<OrderBook>> books_; ///< Indexed by symbol; null until opened.
+    std::size_t                             open_{0};
+};
+
+} // namespace ob
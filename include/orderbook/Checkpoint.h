@@ -0,0 +1,67 @@
+#pragma once
+
+#include "orderbook/Types.h"
+
+#include <cstdint>
+#include <type_traits>
+
+namespace ob::checkpoint {
+
+/// File signature ("OBCK" little-endian) written at the start of every checkpoint.
+inline constexpr std::uint32_t magic = 0x4B43424F;
+
+/// Layout revision; bumped whenever @ref Header or @ref OrderRecord change.
+inline constexpr std::uint16_t version = 7;
+
+/**
+ * @brief Fixed-size preamble describing the book a checkpoint was taken from.
+ *
+ * All fields are stored in host (little-endian) byte order. The header is followed
+ * by @ref order_count @ref OrderRecord entries: bid levels, ask levels, armed buy
+ * stops, then armed sell stops, each ladder walked from lowest to highest price and
+ * each level in FIFO order.
+ */
+struct Header {
+    std::uint32_t magic{checkpoint::magic};
+    std::uint16_t version{checkpoint::version};
+    std::uint16_t record_size{0};
+    types::Price  bid_min_price{0};
+    types::Price  bid_max_price{0};
+    types::Price  ask_min_price{0};
+    types::Price  ask_max_price{0};
+    std::uint64_t pool_capacity{0};
+    std::uint64_t index_size{0};
+    std::uint64_t order_count{0};
+    types::Price  last_trade_price{0};
+    std::uint8_t  has_last_trade{0};
+    std::uint8_t  in_auction{0};
+    std::uint8_t  reserved[6]{};
+    types::Timestamp clock{0}; ///< Book clock, so restored `GTT` orders expire on schedule.
+};
+
+/**
+ * @brief Serialised form of a single resting order or armed stop.
+ */
+struct OrderRecord {
+    types::OrderId  id{types::invalid_order_id};
+    types::Price    price{0};
+    types::Quantity quantity{0};
+    types::Quantity min_qty{0};
+    std::uint8_t    side{0};
+    std::uint8_t    tif{0};
+    std::uint8_t    has_min_qty{0};
+    std::uint8_t    type{0};
+    types::OwnerId  owner{0};
+    types::Price    stop_price{0};
+    types::Quantity hidden{0};
+    types::Quantity display{0};
+    types::Timestamp expire_at{0};
+    std::uint8_t    peg{0};
+    std::uint8_t    reserved[7]{};
+};
+
+static_assert(std::is_trivially_copyable_v<Header>);
+static_assert(std::is_trivially_copyable_v<OrderRecord>);
+static_assert(sizeof(OrderRecord) == 80, "checkpoint record layout changed; bump version");
+
+} // namespace ob::checkpoint
@@ -76,6 +76,74 @@ public:
         node->prev = nullptr;
     }
 
+    /**
+     * @brief Visit every node from head to tail.
+     * @param fn Callable invoked as `fn(const Node&)`; must not mutate the queue.
+     */
+    template <typename Fn>
+    void for_each(Fn&& fn) const {
+        for (const Node* node = head_; node; node = node->next) fn(*node);
+    }
+
+    /// @return Node queued behind @p node, or nullptr at the tail.
+    Node* next(Node* node) noexcept { return node->next; }
+    const Node* next(const Node* node) const noexcept { return node->next; }
+
+    /// @return Node queued ahead of @p node, or nullptr at the head.
+    const Node* prev(const Node* node) const noexcept { return node->prev; }
+
+    /// Move the contiguous run [@p first, @p last] of @p from to this queue's tail in one splice.
+    void splice_back(IntrusiveFifo& from, Node* first, Node* last) noexcept {
+        from.erase_run(first, last);
+        first->prev = tail_;
+        if (tail_) tail_->next = first;
+        else head_ = first;
+        tail_ = last;
+    }
+
+    /// Drop every node at once; their links are left stale until they are pushed again.
+    void clear() noexcept {
+        head_ = nullptr;
+        tail_ = nullptr;
+    }
+
+    /**
+     * @brief Unlink the contiguous run [@p first, @p last] with one splice.
+     *
+     * Interior links are left as they are; callers must not reuse them before the
+     * nodes are pushed again.
+     */
+    void erase_run(Node* first, Node* last) noexcept {
+        if (first->prev) first->prev->next = last->next;
+        else head_ = last->next;
+        if (last->next) last->next->prev = first->prev;
+        else tail_ = first->prev;
+        first->prev = nullptr;
+        last->next = nullptr;
+    }
+
+    /**
+     * @brief Unlink every node matching @p pred in a single pass.
+     * @param pred    Callable invoked as `pred(const Node&)`.
+     * @param dispose Callable invoked as `dispose(Node*)` once the node is unlinked.
+     */
+    template <typename Pred, typename Disposer>
+    void remove_and_dispose_if(Pred&& pred, Disposer&& dispose) {
+        for (Node* node = head_; node;) {
+            Node* next = node->next;
+            if (pred(static_cast<const Node&>(*node))) {
+                if (node->prev) node->prev->next = next;
+                else head_ = next;
+                if (next) next->prev = node->prev;
+                else tail_ = node->prev;
+                node->next = nullptr;
+                node->prev = nullptr;
+                dispose(node);
+            }
+            node = next;
+        }
+    }
+
 private:
     Node* head_{nullptr};
     Node* tail_{nullptr};
@@ -132,6 +200,54 @@ public:
         node->order = nullptr;
     }
 
+    /**
+     * @brief Visit every node from head to tail.
+     * @param fn Callable invoked as `fn(const Node&)`; must not mutate the queue.
+     */
+    template <typename Fn>
+    void for_each(Fn&& fn) const {
+        for (const Node& node : list_) fn(node);
+    }
+
+    /// @return Node queued behind @p node, or nullptr at the tail.
+    Node* next(Node* node) noexcept {
+        auto it = std::next(list_.iterator_to(*node));
+        return it == list_.end() ? nullptr : &*it;
+    }
+    const Node* next(const Node* node) const noexcept {
+        auto it = std::next(list_.iterator_to(*node));
+        return it == list_.end() ? nullptr : &*it;
+    }
+
+    /// @return Node queued ahead of @p node, or nullptr at the head.
+    const Node* prev(const Node* node) const noexcept {
+        auto it = list_.iterator_to(*node);
+        return it == list_.begin() ? nullptr : &*std::prev(it);
+    }
+
+    /// Move the contiguous run [@p first, @p last] of @p from to this queue's tail in one splice.
+    void splice_back(IntrusiveFifo& from, Node* first, Node* last) noexcept {
+        list_.splice(list_.end(), from.list_, from.list_.iterator_to(*first), std::next(from.list_.iterator_to(*last)));
+    }
+
+    /// Drop every node at once (constant time with normal-link hooks).
+    void clear() noexcept { list_.clear(); }
+
+    /// Unlink the contiguous run [@p first, @p last] with one splice.
+    void erase_run(Node* first, Node* last) noexcept {
+        list_.erase(list_.iterator_to(*first), std::next(list_.iterator_to(*last)));
+    }
+
+    /**
+     * @brief Unlink every node matching @p pred in a single pass.
+     * @param pred    Callable invoked as `pred(const Node&)`.
+     * @param dispose Callable invoked as `dispose(Node*)` once the node is unlinked.
+     */
+    template <typename Pred, typename Disposer>
+    void remove_and_dispose_if(Pred&& pred, Disposer&& dispose) {
+        list_.remove_and_dispose_if(pred, dispose);
+    }
+
 private:
     using list_type = boost::intrusive::list<Node, boost::intrusive::constant_time_size<false>>;
     list_type list_{};
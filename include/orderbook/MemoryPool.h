@@ -58,6 +58,17 @@ public:
         free_list_.push_back(ptr);
     }
 
+    /**
+     * @brief Destroy @p count objects and return their storage in one append.
+     * @param ptrs Pointers previously obtained from @ref create.
+     */
+    void destroy(T* const* ptrs, std::size_t count) noexcept {
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            for (std::size_t i = 0; i < count; ++i) ptrs[i]->~T();
+        }
+        free_list_.insert(free_list_.end(), ptrs, ptrs + count);
+    }
+
     /// @return Maximum number of concurrently live objects.
     std::size_t capacity() const noexcept { return capacity_; }
 
@@ -6,6 +6,7 @@
 
 #include "orderbook/Types.h"
 
+#include <cstdint>
 #include <optional>
 
 namespace ob {
@@ -25,6 +26,19 @@ struct alignas(64) OrderNode
     OrderNode* next{nullptr};
     OrderNode* prev{nullptr};
 #endif
+    types::Quantity entered{0}; ///< Level's queue counter when the node joined; see PriceLevel::ahead_of.
+};
+
+/**
+ * @brief Intrusive link embedded inside an @ref Order for the expiry timing wheel.
+ */
+struct TimerNode {
+    static constexpr std::uint16_t unlinked = 0xFFFF;
+
+    Order*         order{nullptr}; ///< Owning order; its `expire_at` is the deadline.
+    TimerNode*     next{nullptr};
+    TimerNode*     prev{nullptr};
+    std::uint16_t  slot{unlinked}; ///< Wheel bucket currently holding the node.
 };
 
 /**
@@ -68,11 +82,22 @@ struct Order {
     types::Quantity    quantity{0};
     types::Side        side{types::Side::Buy};
     types::TimeInForce tif{types::TimeInForce::GFD};
-    types::Quantity    min_qty{0};
     bool               has_min_qty{false};
+    types::OrderType   type{types::OrderType::Limit};
+    types::OwnerId     owner{0};      ///< Session tag for mass cancel; 0 = untagged.
+    types::Quantity    min_qty{0};
+    types::Price       stop_price{0}; ///< Trigger price while `type` is a stop kind.
+    types::Quantity    hidden{0};     ///< Iceberg reserve not yet shown; `quantity` is the visible slice.
+    types::Quantity    display{0};    ///< Iceberg slice size; 0 for fully displayed orders.
 
     OrderNode node{};
     bool      resting{false};
+    types::PegType   peg{types::PegType::None}; ///< Peg group while resting pegged; `price` may lag the group's level.
+    std::uint32_t    book{0};      ///< Owning book's tag within a @ref BookSet; 0 for a standalone book.
+    types::Timestamp expire_at{0}; ///< Expiry time for `GTT` orders.
+    TimerNode        timer{};
+    Order*           owner_next{nullptr}; ///< Intrusive list of the owner's live orders.
+    Order*           owner_prev{nullptr};
 };
 
 } // namespace ob
@@ -3,8 +3,13 @@
 #include "orderbook/MemoryPool.h"
 #include "orderbook/Order.h"
 #include "orderbook/SideBook.h"
+#include "orderbook/Stats.h"
+#include "orderbook/StopBook.h"
+#include "orderbook/TimingWheel.h"
 #include "orderbook/Types.h"
 
+#include <cstdint>
+#include <memory>
 #include <optional>
 #include <ostream>
 #include <vector>
@@ -22,11 +27,59 @@ struct Trade {
     types::Price     incoming_px{0};
 };
 
+/**
+ * @brief Full description of an order entering the book.
+ *
+ * The positional @ref OrderBook::create_order overload covers plain limit orders;
+ * this form carries the attributes that only some order kinds use.
+ */
+struct OrderSpec {
+    types::OrderId                 id{types::invalid_order_id};
+    types::Price                   price{0}; ///< Limit price; ignored for `Stop` orders.
+    types::Quantity                quantity{0};
+    types::Side                    side{types::Side::Buy};
+    types::TimeInForce             tif{types::TimeInForce::GFD};
+    std::optional<types::Quantity> min_qty{};
+    types::OrderType               type{types::OrderType::Limit};
+    types::Price                   stop_price{0}; ///< Trigger price for `Stop` / `StopLimit`.
+    types::Quantity                display{0};    ///< Iceberg slice shown while resting; 0 = all.
+    types::Timestamp               expire_at{0};  ///< Expiry time for `GTT` orders.
+    types::OwnerId                 owner{0};      ///< Session tag for @ref OrderBook::mass_cancel; 0 = none.
+    types::PegType                 peg{types::PegType::None}; ///< Reference followed instead of `price`.
+};
+
+/// Inclusive price window used to narrow a mass cancel.
+struct PriceRange {
+    types::Price low{0};
+    types::Price high{0};
+};
+
+/// Outcome of a call auction uncross, or of the indicative calculation ahead of it.
+struct AuctionResult {
+    std::optional<types::Price> price{}; ///< Equilibrium price; nullopt when nothing crosses.
+    types::Quantity volume{0};           ///< Quantity executable at @ref price.
+    types::Quantity imbalance{0};        ///< Demand minus supply at @ref price; positive means buyers left over.
+};
+
+/**
+ * @brief Order slots and the ID index, owned by one book or shared by a @ref BookSet.
+ *
+ * Order IDs are unique across every book drawing from the same store.
+ */
+struct OrderStore {
+    explicit OrderStore(std::size_t capacity) : pool(capacity) {}
+
+    MemoryPool<Order>   pool;
+    std::vector<Order*> index; ///< Internal order ID to live order, in any book.
+};
+
 /**
  * @brief Deterministic single-symbol order book with price-time priority.
  *
- * The book owns both bid and ask ladders, a memory pool for orders,
- * and a direct index from internal order IDs to `Order*`.
+ * The book owns both bid and ask ladders and normally its own @ref OrderStore: a
+ * memory pool for orders and a direct index from internal order IDs to `Order*`.
+ * Books built by a @ref BookSet borrow the set's store instead and only see the
+ * orders carrying their tag.
  */
 class OrderBook {
 public:
@@ -43,6 +96,16 @@ public:
               types::Price max_price,
               std::size_t  pool_capacity = 1'000);
 
+    /**
+     * @brief Construct a book drawing its orders from @p store, which must outlive it.
+     *
+     * All four ladders start empty and grow to the prices the book actually sees, so
+     * an idle book holds no levels at all.
+     *
+     * @param tag Stamped on this book's orders; unique among the books sharing @p store.
+     */
+    OrderBook(OrderStore& store, std::uint32_t tag);
+
     /**
      * @brief Add an order to the book, matching immediately if possible.
      *
@@ -56,12 +119,65 @@ public:
                         types::TimeInForce tif,
                         std::optional<types::Quantity> min_qty = std::nullopt);
 
+    /**
+     * @brief Add an order of any kind.
+     *
+     * Iceberg orders (`display` below the quantity) match with their full quantity on
+     * entry; once resting only `display` is visible and each time that slice fills the
+     * next one is shown at the back of the level's FIFO.
+     *
+     * Market and protected market orders (`price` ignored) are always `IOC`, or `FOK`
+     * when asked for; they are rejected during an auction or when the opposite side is
+     * empty.
+     *
+     * Stop orders are armed off-book and stay live (findable, cancellable) until the
+     * last trade price reaches their stop price; one already reached fires at once.
+     * Fired stops re-enter through the matching path after the command that moved the
+     * price, in trigger order, and may fire further stops in turn.
+     *
+     * `GTT` orders are scheduled on the book's timing wheel and removed by
+     * @ref advance_time once the clock reaches `expire_at`; one whose expiry is not
+     * after the current clock is rejected.
+     *
+     * Pegged orders (`peg` set, `price` ignored) never match on entry: they join their
+     * peg group, or start it at the reference price. References are the best limit
+     * prices, pegged orders excluded, and every group follows them after each command
+     * that changes the book, moving as a block to the back of its new level. Buy pegs
+     * are held a tick below the lowest sell peg so groups never cross, and a group
+     * stays put while its reference is missing. A pegged order must be a fully
+     * displayed `GFD` or `GTT` order without a minimum quantity, and is rejected
+     * during an auction or when it has no reference to start from.
+     *
+     * @return Pointer to the live order when it rests or is armed, otherwise nullptr.
+     */
+    Order* create_order(const OrderSpec& spec);
+
     /// Cancel an order by its internal identifier (no-op if absent).
     void cancel(types::OrderId id);
 
+    /**
+     * @brief Cancel every live order tagged with @p owner, optionally narrowed by side and price.
+     *
+     * Each owner's orders are chained in an intrusive list, so the cost is linear in
+     * that owner's orders, not the book. Orders queued back to back in a level leave
+     * their FIFO in one splice, a level holding nothing else is cleared outright,
+     * the pool slots go back in one batch and each side's best level is fixed up once.
+     * Armed stops are included and filtered on their stop price.
+     *
+     * @return Number of orders cancelled.
+     */
+    std::size_t mass_cancel(types::OwnerId owner,
+                            std::optional<types::Side> side = std::nullopt,
+                            std::optional<PriceRange> range = std::nullopt);
+
     /**
      * @brief Modify an existing order by cancel+reenter semantics.
      *
+     * The replacement keeps the owner tag, an iceberg's display size and a `GTT`
+     * order's expiry time; @p qty counts the iceberg reserve too. An armed stop stays
+     * armed at its stop price, and @p price is only used by a `StopLimit` once it
+     * fires. Modifying a pegged order re-enters it as a plain limit order.
+     *
      * @param id        Existing order identifier.
      * @param side      Replacement side.
      * @param price     Replacement price.
@@ -76,6 +192,89 @@ public:
                 types::TimeInForce tif,
                 std::optional<types::Quantity> min_qty = std::nullopt);
 
+    /**
+     * @brief Move the book clock to @p now and cancel every `GTT` order that has expired.
+     *
+     * Time only comes from the caller (the engine forwards timestamps from its command
+     * stream), so replaying the same commands expires the same orders. Expiry is
+     * honoured at the wheel's resolution of one millisecond; a clock going backwards
+     * is ignored.
+     */
+    void advance_time(types::Timestamp now);
+
+    /// @return Current book clock, the latest time passed to @ref advance_time.
+    types::Timestamp now() const noexcept { return clock_; }
+
+    /**
+     * @brief End-of-day purge: remove every order that is not `GTT`, armed stops included.
+     *
+     * Runs as one sweep per ladder that unlinks the orders and releases their pool
+     * slots directly instead of going through @ref cancel per order, and fixes up each
+     * side's best level once at the end.
+     *
+     * @return Number of orders removed.
+     */
+    std::size_t end_of_day();
+
+    /**
+     * @brief Enter a call auction phase (opening or closing auction).
+     *
+     * Until @ref uncross, limit orders rest without matching, so the ladders may
+     * cross; `IOC` and `FOK` orders are rejected, minimum quantities are not checked
+     * and stops stay armed even if the last trade price has already reached them.
+     * Peg groups stay where they are and take part like limit orders.
+     * Cancel, modify, expiry and mass cancel work as in continuous trading.
+     */
+    void begin_auction() noexcept { in_auction_ = true; }
+
+    /// @return True between @ref begin_auction and @ref uncross.
+    bool in_auction() const noexcept { return in_auction_; }
+
+    /**
+     * @brief Equilibrium the book would uncross at right now, without executing.
+     *
+     * Cumulative demand (bids at or above each price) and supply (asks at or below it)
+     * are built over the crossed price range with prefix sums. The price maximises the
+     * executable volume, then minimises the imbalance; remaining ties go up when every
+     * candidate has surplus demand, down when every one has surplus supply, and
+     * otherwise to the candidate nearest the last trade price (or the middle of the
+     * candidates when there is none), the lower one on a tie. Iceberg reserves count.
+     */
+    AuctionResult indicative_uncross() const;
+
+    /**
+     * @brief Leave the auction phase, executing everything that crosses at one price.
+     *
+     * Fills are allocated in price-time priority on both sides and paired into trades
+     * at the equilibrium price, which becomes the last trade price; the sell order is
+     * reported as the resting side. Stops reached by that price fire afterwards.
+     * Continuous trading resumes on an uncrossed book.
+     *
+     * @return The equilibrium used; `volume` is zero when the book did not cross.
+     */
+    AuctionResult uncross();
+
+    /**
+     * @brief Select the self-trade prevention policy (`None` by default).
+     *
+     * The match loop is instantiated once per mode and picked per incoming order, so
+     * untagged orders and books without a policy run the loop with no owner check.
+     * `FOK` and minimum-quantity checks still count the owner's own resting orders.
+     */
+    void set_stp_mode(types::StpMode mode) noexcept { stp_mode_ = mode; }
+
+    /**
+     * @brief Set how far past the touch a `ProtectedMarket` order may sweep, in ticks.
+     *
+     * The bound is fixed when the order arrives: a buy trades up to the best ask plus
+     * @p ticks, a sell down to the best bid minus @p ticks. The default of 0 keeps
+     * protected orders at the touch.
+     */
+    void set_market_protection(types::Price ticks) noexcept { market_protection_ = ticks; }
+
+    /// @return Current self-trade prevention policy.
+    types::StpMode stp_mode() const noexcept { return stp_mode_; }
+
     /// @return True if the internal identifier currently maps to a live order.
     bool has_order(types::OrderId id) const;
 
@@ -88,18 +287,150 @@ public:
         trade_ctx_  = ctx;
     }
 
-    /// Emit a textual snapshot of the book to @p os.
-    void snapshot(std::ostream& os) const;
+    /// @return Price of the most recent trade, if any has happened.
+    std::optional<types::Price> last_trade_price() const noexcept { return last_trade_price_; }
+
+    /// @return Best bid price, or nullopt when no bid rests.
+    std::optional<types::Price> best_bid() const noexcept { return bids_.best_price(); }
+
+    /// @return Best ask price, or nullopt when no ask rests.
+    std::optional<types::Price> best_ask() const noexcept { return asks_.best_price(); }
+
+    /// @return Visible quantity at the best bid, or 0 when no bid rests.
+    types::Quantity best_bid_quantity() const noexcept { return bids_.best_quantity(); }
+
+    /// @return Visible quantity at the best ask, or 0 when no ask rests.
+    types::Quantity best_ask_quantity() const noexcept { return asks_.best_quantity(); }
+
+    /**
+     * @brief Live quantity of @p owner's orders: displayed plus iceberg reserve, armed stops included.
+     *
+     * Kept per owner next to the owner lists and adjusted on every fill, so the lookup
+     * is one array read.
+     */
+    types::Quantity open_quantity(types::OwnerId owner) const noexcept {
+        return owner < owner_open_.size() ? owner_open_[owner] : 0;
+    }
+
+    /**
+     * @brief Visible quantity that must trade before resting order @p id gets a fill.
+     *
+     * Two reads from the order and its level, whatever the queue's length. Orders
+     * only join at the tail, so it never understates. It is exact unless quantity left
+     * from inside the queue since @p id joined it, by cancel or by a peg group moving
+     * to the tail; then it may overstate, bounded by the rest of the level; see
+     * @ref PriceLevel::ahead_of. Iceberg reserve behind the visible slices is not
+     * counted, and a replenished iceberg slice queues afresh at the tail.
+     *
+     * @return nullopt unless @p id is a limit order resting on the book unpegged.
+     */
+    std::optional<types::Quantity> queue_ahead(types::OrderId id) const noexcept;
+
+    /**
+     * @brief Emit a textual snapshot of the book to @p os.
+     * @param tick_size Multiplier turning level prices into the printed prices.
+     */
+    void snapshot(std::ostream& os, types::Price tick_size = 1) const;
+
+    /**
+     * @brief Serialise configuration and all resting orders into @p out.
+     *
+     * Orders are written per level in FIFO order so @ref restore reproduces the exact
+     * time priority. The buffer is sized once up front; the call performs a single
+     * pass over the ladders and never touches the matching state, so callers can
+     * run it between commands and hand the bytes to another thread for I/O.
+     *
+     * @param out Destination buffer; existing contents are replaced.
+     */
+    void checkpoint(std::vector<char>& out) const;
+
+    /**
+     * @brief Rebuild resting state from a buffer produced by @ref checkpoint.
+     *
+     * Orders are placed straight into the ladders and the ID index without going
+     * through the matching path. The book must be empty.
+     *
+     * @return False when the book is not empty, the buffer is malformed, or the pool
+     *         is smaller than the one the checkpoint was taken from or cannot hold
+     *         every serialised order; the book is left empty on failure.
+     */
+    bool restore(const char* data, std::size_t size);
+
+    /**
+     * @brief Hot-path counters recorded on the calling thread.
+     *
+     * Counters are thread-local, so they aggregate every book the thread drives; the
+     * engine runs one book per worker, making them per-symbol there. All zero unless
+     * built with `-DENABLE_BOOK_STATS=ON`.
+     */
+    static const BookStats& stats() noexcept { return stats::local(); }
+
+    /// @return Number of live orders in this book.
+    std::size_t live_orders() const noexcept { return live_; }
+
+    /// @return Tag stamped on this book's orders.
+    std::uint32_t tag() const noexcept { return tag_; }
 
 private:
+    /// Remove order @p id from every structure and release it, without repricing pegs.
+    void erase(types::OrderId id);
     void process(Order& order);
+    /// Move every peg group to its reference after the book changed.
+    void reprice_pegs();
+    /// Price a new pegged order would join at, or nullopt when it has no reference.
+    std::optional<types::Price> peg_entry_price(types::Side side, types::PegType peg) const;
     void match(Order& incoming, SideBook& opposite, SideBook& same);
+    /// The match loop with self-trade prevention policy @p Mode compiled in.
+    template <types::StpMode Mode>
+    void match_with(Order& incoming, SideBook& opposite, SideBook& same);
+    /// Rest the remainder of @p order on @p same if its time-in-force allows, otherwise cancel it.
+    void rest(Order& order, SideBook& same);
     void ensure_index_capacity(types::OrderId id);
+    /// Live order @p id when it belongs to this book, otherwise nullptr.
+    Order* lookup(types::OrderId id) const noexcept {
+        if (id >= id_index_.size()) return nullptr;
+        Order* order = id_index_[id];
+        return order && order->book == tag_ ? order : nullptr;
+    }
+    /// Fire stops reached by the last trade and feed them through @ref process until none remain.
+    void run_triggers();
+    void link_owner(Order& order);
+    void unlink_owner(Order& order) noexcept;
+    /// Expiry wheel, created at the book clock by the first `GTT` order.
+    TimingWheel& expiries();
+    /// Take @p order off the expiry wheel, if it is on one.
+    void unschedule(Order& order) noexcept {
+        if (expiries_) expiries_->remove(order.timer);
+    }
 
-    MemoryPool<Order> pool_;
+    std::unique_ptr<OrderStore> own_store_; ///< Set unless the store is borrowed from a @ref BookSet.
+    MemoryPool<Order>&   pool_;
+    std::vector<Order*>& id_index_;
+    std::uint32_t        tag_{0};
+    std::size_t          live_{0};
     SideBook bids_;
     SideBook asks_;
-    std::vector<Order*> id_index_;
+    StopBook buy_stops_;
+    StopBook sell_stops_;
+    std::vector<Order*> triggered_;
+    std::vector<Order*> owner_heads_; ///< Oldest live order per owner, indexed by owner ID.
+    std::vector<types::Quantity> owner_open_; ///< @ref open_quantity, indexed by owner ID.
+    std::vector<Order*> doomed_;      ///< Scratch batch for @ref mass_cancel.
+
+    /// One order's share of an uncross; the order itself may already be released.
+    struct AuctionFill {
+        types::OrderId  id;
+        types::Quantity quantity;
+    };
+    std::vector<AuctionFill> auction_fills_;
+    mutable std::vector<types::Quantity> demand_; ///< Scratch curves for @ref indicative_uncross.
+    mutable std::vector<types::Quantity> supply_;
+    bool                in_auction_{false};
+    types::StpMode      stp_mode_{types::StpMode::None};
+    types::Price        market_protection_{0};
+    std::unique_ptr<TimingWheel> expiries_; ///< Null until needed: the buckets cost 8 KiB per book.
+    types::Timestamp    clock_{0};
+    std::optional<types::Price> last_trade_price_;
     trade_sink_t        trade_sink_{nullptr};
     void*               trade_ctx_{nullptr};
 };
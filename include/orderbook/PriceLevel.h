@@ -4,13 +4,24 @@
 #include "orderbook/Order.h"
 #include "orderbook/Types.h"
 
+#include <cstddef>
+
 namespace ob {
 
 /**
  * @brief Aggregates all resting orders at a single price.
  *
  * Each level maintains total resting quantity and a FIFO of orders to enforce
- * price-time priority within the level.
+ * price-time priority within the level. Visible and iceberg reserve quantities are
+ * kept as separate aggregates so liquidity checks never walk the FIFO.
+ *
+ * Two cumulative counters give each order's queue position without a walk either:
+ * `entered_` advances by the visible quantity of every order joining the tail and
+ * `consumed_` by every quantity leaving the head. A joining order snapshots
+ * `entered_`, so the quantity still ahead of it is its snapshot minus `consumed_`.
+ * Quantity leaving from inside the queue is taken back out of `entered_`, which keeps
+ * later snapshots exact; orders already queued behind it are then overstated until
+ * the head catches up, which @ref ahead_of bounds by the level's total.
  */
 class PriceLevel {
 public:
@@ -20,9 +31,29 @@ public:
     /// @return Price represented by this level.
     types::Price price() const noexcept { return price_; }
 
-    /// @return Aggregate resting quantity at this price.
+    /// @return Aggregate visible resting quantity at this price.
     types::Quantity total() const noexcept { return total_quantity_; }
 
+    /// @return Aggregate iceberg reserve at this price (executable but not displayed).
+    types::Quantity hidden() const noexcept { return hidden_quantity_; }
+
+    /**
+     * @brief Visible quantity queued ahead of @p order, which must rest at this level.
+     *
+     * Exact while orders only leave at the head, and at the head itself. Orders only
+     * ever join at the tail, so nothing is missed: quantity that left from inside the
+     * queue since @p order joined, by cancel or by a splice to the tail, may still be
+     * counted as ahead of it, but the result never understates and never exceeds the
+     * level's visible quantity less the order's own. Pegged orders move between levels
+     * by splice without a fresh snapshot, so their own answer is meaningless.
+     */
+    types::Quantity ahead_of(const Order& order) const noexcept {
+        if (orders_.front() == &order.node) return 0;
+        const types::Quantity ahead = order.node.entered - consumed_;
+        const types::Quantity others = total_quantity_ - order.quantity;
+        return ahead < 0 ? 0 : ahead > others ? others : ahead;
+    }
+
     /// @return True when no orders currently rest at this level.
     bool empty() const noexcept { return orders_.empty(); }
 
@@ -35,16 +66,188 @@ public:
     /// @return Pointer to the oldest resting order, or nullptr when empty.
     Order* top() noexcept;
 
+    /// @return Order queued directly behind @p order, or nullptr at the tail.
+    Order* after(const Order& order) const noexcept {
+        const OrderNode* node = orders_.next(&order.node);
+        return node ? node->order : nullptr;
+    }
+
+    /// @return Order queued directly ahead of @p order, or nullptr at the head.
+    Order* before(const Order& order) const noexcept {
+        const OrderNode* node = orders_.prev(&order.node);
+        return node ? node->order : nullptr;
+    }
+
+    /**
+     * @brief Move the contiguous run [@p first, @p last] from @p from to this level's tail.
+     *
+     * One FIFO splice whatever the run's length: the caller supplies the run's visible
+     * @p quantity and @p count so neither level walks it. The run must carry no iceberg
+     * reserve, and its orders keep their `price` field until the caller refreshes it.
+     */
+    void splice_run(PriceLevel& from, Order& first, Order& last, types::Quantity quantity, std::size_t count) noexcept;
+
     /// Remove the specified order from the FIFO and update aggregates.
     void remove(Order& order) noexcept;
 
     /// Apply a fill delta to the aggregate quantity.
     void on_fill(types::Quantity delta) noexcept;
 
+    /**
+     * @brief Show the next iceberg slice of a fully filled @p order.
+     *
+     * Moves up to `display` from the reserve into `quantity` and relinks the order's
+     * node at the tail of the FIFO, so it loses time priority without leaving its
+     * pool slot or the level.
+     */
+    void replenish(Order& order) noexcept;
+
+    /**
+     * @brief Execute up to @p volume against this level in FIFO order (auction uncross).
+     *
+     * Each order offers its whole remaining quantity, iceberg reserve included, and
+     * @p on_fill is invoked as `on_fill(Order&, types::Quantity filled, bool complete)`.
+     * A complete order is reported while still queued and unlinked right after, so the
+     * callback can retire it while it is in cache but must not return its slot to the
+     * pool. Only the last order can be partially filled and is reported once adjusted;
+     * it keeps its place unless its visible slice ran out, in which case it is
+     * replenished at the tail.
+     *
+     * @return Volume still to be executed elsewhere.
+     */
+    template <typename Fn>
+    types::Quantity execute(types::Quantity volume, Fn&& on_fill) {
+        while (volume > 0) {
+            OrderNode* node = orders_.front();
+            if (!node) break;
+            Order& order = *node->order;
+            const types::Quantity available = order.quantity + order.hidden;
+            if (available <= volume) {
+                volume -= available;
+                on_fill(order, available, true);
+                remove(order);
+                continue;
+            }
+            if (volume < order.quantity) {
+                order.quantity -= volume;
+                total_quantity_ -= volume;
+                consumed_ += volume;
+            } else {
+                const types::Quantity from_reserve = volume - order.quantity;
+                total_quantity_ -= order.quantity;
+                consumed_ += order.quantity;
+                order.quantity = 0;
+                order.hidden -= from_reserve;
+                hidden_quantity_ -= from_reserve;
+                replenish(order);
+            }
+            on_fill(order, volume, false);
+            volume = 0;
+        }
+        return volume;
+    }
+
+#ifdef ENABLE_BOOK_STATS
+    /// @return Number of orders queued at this level (stats builds only).
+    std::uint32_t depth() const noexcept { return depth_; }
+#endif
+
+    /// Visit resting orders in FIFO (time priority) order.
+    template <typename Fn>
+    void for_each_order(Fn&& fn) const {
+        orders_.for_each([&](const OrderNode& node) { fn(*node.order); });
+    }
+
+    /**
+     * @brief Unlink every order matching @p pred in one walk of the FIFO.
+     *
+     * Aggregates are adjusted as orders leave; @p on_removed receives each one after it
+     * is unlinked and may release it.
+     *
+     * @return Number of orders removed.
+     */
+    template <typename Pred, typename Fn>
+    std::size_t remove_if(Pred&& pred, Fn&& on_removed) {
+        std::size_t removed = 0;
+        bool at_head = true; // nothing kept yet, so the next removal leaves from the head
+        orders_.remove_and_dispose_if(
+            [&](const OrderNode& node) {
+                const bool doomed = pred(static_cast<const Order&>(*node.order));
+                at_head = at_head && doomed;
+                return doomed;
+            },
+            [&](OrderNode* node) {
+                Order& order = *node->order;
+                total_quantity_ -= order.quantity;
+                hidden_quantity_ -= order.hidden;
+                if (at_head) consumed_ += order.quantity;
+                else entered_ -= order.quantity;
+                order.resting = false;
+                node->order = nullptr;
+#ifdef ENABLE_BOOK_STATS
+                --depth_;
+#endif
+                ++removed;
+                on_removed(order);
+            });
+        if (total_quantity_ < 0) total_quantity_ = 0;
+        return removed;
+    }
+
+    /**
+     * @brief Unlink @p first and every order queued directly behind it that satisfies @p extend.
+     *
+     * The run leaves the FIFO in one splice. When it spans the whole level the
+     * aggregates are reset instead of adjusted, so clearing a level costs one walk over
+     * its orders to mark them and nothing per link.
+     *
+     * @return Number of orders removed.
+     */
+    template <typename Pred>
+    std::size_t remove_run(Order& first, Pred&& extend) noexcept {
+        OrderNode* last = &first.node;
+        types::Quantity quantity = first.quantity;
+        types::Quantity hidden = first.hidden;
+        std::size_t removed = 1;
+        first.resting = false;
+        for (OrderNode* next = orders_.next(last); next && extend(static_cast<const Order&>(*next->order));
+             next = orders_.next(last)) {
+            last = next;
+            quantity += next->order->quantity;
+            hidden += next->order->hidden;
+            next->order->resting = false;
+            ++removed;
+        }
+        const bool at_head = orders_.front() == &first.node;
+        if (at_head && !orders_.next(last)) {
+            orders_.clear();
+            total_quantity_ = 0;
+            hidden_quantity_ = 0;
+            consumed_ = entered_;
+        } else {
+            if (at_head) consumed_ += quantity;
+            else entered_ -= quantity;
+            orders_.erase_run(&first.node, last);
+            total_quantity_ -= quantity;
+            hidden_quantity_ -= hidden;
+            if (total_quantity_ < 0) total_quantity_ = 0;
+        }
+#ifdef ENABLE_BOOK_STATS
+        depth_ -= static_cast<std::uint32_t>(removed);
+#endif
+        return removed;
+    }
+
 private:
     types::Price price_{0};
     types::Quantity total_quantity_{0};
+    types::Quantity hidden_quantity_{0};
+    types::Quantity entered_{0};  ///< Visible quantity that joined the tail, less what left mid-queue.
+    types::Quantity consumed_{0}; ///< Visible quantity that left from the head.
     IntrusiveFifo<OrderNode> orders_{};
+#ifdef ENABLE_BOOK_STATS
+    std::uint32_t depth_{0};
+#endif
 };
 
 } // namespace ob
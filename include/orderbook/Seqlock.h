@@ -0,0 +1,63 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace ob {
+
+/**
+ * @brief Single-writer sequence lock publishing a trivially copyable value.
+ *
+ * @tparam T Payload type; copied in and out as whole 64-bit words.
+ *
+ * The writer never waits: it makes the sequence odd, stores the words and makes it
+ * even again. Readers copy the words and retry if the sequence was odd or moved,
+ * so they never block the writer and never see a torn value. The payload is held
+ * in relaxed atomics, which keeps concurrent reads free of data races.
+ */
+template <typename T>
+class alignas(64) Seqlock {
+    static_assert(std::is_trivially_copyable_v<T>, "Seqlock payloads are copied bytewise");
+    static_assert(std::is_default_constructible_v<T>, "load() needs somewhere to copy into");
+
+public:
+    Seqlock() noexcept { store(T{}); }
+
+    /// Publish @p value. Only one thread may call this.
+    void store(const T& value) noexcept {
+        std::uint64_t words[kWords]{};
+        std::memcpy(words, &value, sizeof(T));
+        const auto seq = seq_.load(std::memory_order_relaxed);
+        seq_.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (std::size_t i = 0; i < kWords; ++i) data_[i].store(words[i], std::memory_order_relaxed);
+        seq_.store(seq + 2, std::memory_order_release);
+    }
+
+    /// @return The latest published value (default-constructed before the first @ref store).
+    T load() const noexcept {
+        std::uint64_t words[kWords];
+        for (;;) {
+            const auto before = seq_.load(std::memory_order_acquire);
+            if (before & 1) continue; // a store is in progress
+            for (std::size_t i = 0; i < kWords; ++i) words[i] = data_[i].load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (seq_.load(std::memory_order_relaxed) == before) break;
+        }
+        T value;
+        std::memcpy(&value, words, sizeof(T));
+        return value;
+    }
+
+private:
+    static constexpr std::size_t kWords = (sizeof(T) + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t);
+
+    std::atomic<std::uint64_t>                     seq_{0};
+    std::array<std::atomic<std::uint64_t>, kWords> data_{};
+};
+
+} // namespace ob
@@ -4,6 +4,7 @@
 #include "orderbook/PriceLevel.h"
 #include "orderbook/Types.h"
 
+#include <array>
 #include <optional>
 #include <vector>
 
@@ -15,6 +16,14 @@ namespace ob {
  * Maintains a dense ladder of @ref PriceLevel instances indexed by integerised price.
  * The ladder can grow in either direction and tracks the current best level to allow
  * constant-time access to the top of book.
+ *
+ * Pegged orders rest in the ladder like limit orders, but each peg type forms a group
+ * kept as one contiguous run of a single level's FIFO. Repricing a group splices the
+ * whole run to the tail of the new level, so its cost does not depend on the group's
+ * size and members keep their relative priority. A new member is queued the same way:
+ * the group moves to its level's tail first, so it never gets ahead of an order that
+ * arrived after the group. Members' `price` fields are only
+ * refreshed when they reach the top of their level; @ref price_of is authoritative.
  */
 class SideBook {
 public:
@@ -27,21 +36,165 @@ public:
      */
     SideBook(types::Side side, types::Price min_price, types::Price max_price);
 
+    /// Construct an empty side book whose ladder starts at the first price it has to address.
+    explicit SideBook(types::Side side) : side_(side), min_price_(1), max_price_(0) {}
+
     /// Insert an order into the appropriate price level, expanding the ladder if needed.
     void add(Order& order);
 
+    /**
+     * @brief Queue @p order in its `peg` group.
+     *
+     * It joins at the tail of the group's level, after the group has been spliced
+     * there, or at the tail of @p price when the group is empty.
+     */
+    void add_pegged(Order& order, types::Price price);
+
+    /// Move the @p peg group to @p price as one FIFO splice (no-op when empty or already there).
+    void reprice(types::PegType peg, types::Price price);
+
+    /// @return Level of the @p peg group, or nullopt when it has no members.
+    std::optional<types::Price> peg_price(types::PegType peg) const noexcept {
+        const auto& group = pegs_[peg_slot(peg)];
+        if (group.count == 0) return std::nullopt;
+        return price_at(group.index);
+    }
+
+    /// @return True when any peg group has members.
+    bool has_pegged() const noexcept {
+        return pegs_[0].count + pegs_[1].count + pegs_[2].count > 0;
+    }
+
+    /// @return Current price of resting @p order, following its peg group if it has one.
+    types::Price price_of(const Order& order) const noexcept {
+        return order.peg == types::PegType::None ? order.price : price_at(pegs_[peg_slot(order.peg)].index);
+    }
+
+    /// @return Best price held by a limit order, skipping levels that hold only pegged orders.
+    std::optional<types::Price> best_limit_price() const noexcept;
+
+    /// Grow the ladder so every price in [@p low, @p high] is addressable.
+    void ensure_range(types::Price low, types::Price high);
+
     /// Remove an order from the ladder if it is currently resting.
     void remove(Order& order);
 
+    /**
+     * @brief Unlink @p first plus the orders queued behind it that satisfy @p extend.
+     *
+     * See @ref PriceLevel::remove_run. An emptied level is deactivated, but when it was
+     * the best level the recomputation is left to @ref settle so a batch of removals
+     * pays for it once.
+     *
+     * @return Number of orders removed.
+     */
+    template <typename Pred>
+    std::size_t remove_run(Order& first, Pred&& extend) {
+        const auto idx = level_index(first);
+        auto& level = levels_[idx];
+        if (first.peg != types::PegType::None) unpeg(first);
+        // Peg group members leave one at a time so their group can follow.
+        const std::size_t removed = level.remove_run(first, [&](const Order& next) {
+            return next.peg == types::PegType::None && extend(next);
+        });
+        if (level.empty() && active_[idx]) {
+            active_[idx] = false;
+            --active_count_;
+            if (best_index_ && *best_index_ == idx) best_index_.reset();
+        }
+        return removed;
+    }
+
+    /// Restore the best level after a batch of @ref remove_run calls.
+    void settle() {
+        if (!best_index_ && active_count_ > 0) recompute_best();
+    }
+
+    /**
+     * @brief Execute @p volume against this side for an auction uncross.
+     *
+     * Walks levels from the best outward and each level in FIFO order; see
+     * @ref PriceLevel::execute for how fills are reported. The caller guarantees enough quantity rests at acceptable prices.
+     * The new best level is where the walk stopped, so no ladder rescan is needed.
+     */
+    template <typename Fn>
+    void execute(types::Quantity volume, Fn&& on_fill) {
+        if (volume == 0) return;
+        if (!best_index_) recompute_best();
+        auto idx = *best_index_;
+        for (;;) {
+            if (active_[idx]) {
+                volume = levels_[idx].execute(volume, [&](Order& order, types::Quantity qty, bool complete) {
+                    if (order.peg != types::PegType::None) {
+                        if (complete) unpeg(order);
+                        else pegs_[peg_slot(order.peg)].quantity -= qty;
+                    }
+                    on_fill(order, qty, complete);
+                });
+                if (levels_[idx].empty()) {
+                    active_[idx] = false;
+                    --active_count_;
+                }
+            }
+            if (volume == 0) break;
+            idx = side_ == types::Side::Buy ? idx - 1 : idx + 1;
+        }
+        best_index_.reset();
+        if (active_[idx]) best_index_ = idx;
+        else if (active_count_ > 0) {
+            const auto next = side_ == types::Side::Buy ? prev_active_before(idx) : next_active_after(idx);
+            if (next != levels_.size()) best_index_ = next;
+        }
+    }
+
+    /**
+     * @brief Write the quantity resting at each price of [@p low, @p high] to @p out.
+     *
+     * `out[i]` receives the visible plus hidden quantity at `low + i`, zero where no
+     * level is active or the price is outside the ladder.
+     */
+    void depth_between(types::Price low, types::Price high, types::Quantity* out) const noexcept;
+
     /// @return Pointer to the best order (highest bid or lowest ask), or nullptr when empty.
     Order* best();
 
+    /// @return Best non-empty level, or nullptr when the side is empty.
+    PriceLevel* best_level() { return best() ? &levels_[*best_index_] : nullptr; }
+
     /// Apply a fill delta to an order and update aggregates for its price level.
    void on_fill(Order& order, types::Quantity delta);
 
+    /// Refill a fully filled iceberg @p order from its reserve and requeue it at the tail.
+    void replenish(Order& order) noexcept { levels_[level_index(order)].replenish(order); }
+
+    /// @return Visible quantity queued ahead of resting @p order; see @ref PriceLevel::ahead_of.
+    types::Quantity queue_ahead(const Order& order) const noexcept { return levels_[level_index(order)].ahead_of(order); }
+
+#ifdef ENABLE_BOOK_STATS
+    /// @return Orders queued at @p price (stats builds only).
+    std::uint32_t depth_at(types::Price price) const noexcept {
+        return price < min_price_ || price > max_price_ ? 0 : levels_[index_of(price)].depth();
+    }
+#endif
+
+    /// @return Price of the best level, or nullopt when the side is empty.
+    std::optional<types::Price> best_price() const noexcept {
+        if (!best_index_) return std::nullopt;
+        return price_at(*best_index_);
+    }
+
+    /// @return Visible quantity at the best level, or 0 when the side is empty.
+    types::Quantity best_quantity() const noexcept { return best_index_ ? levels_[*best_index_].total() : 0; }
+
     /// @return True when no active price levels remain.
     bool empty() const noexcept { return active_count_ == 0; }
 
+    /// @return Lowest price currently addressable by the ladder.
+    types::Price min_price() const noexcept { return min_price_; }
+
+    /// @return Highest price currently addressable by the ladder.
+    types::Price max_price() const noexcept { return max_price_; }
+
     template <typename Fn>
     void for_each_level(Fn&& fn) const {
         for (std::size_t idx = 0; idx < levels_.size(); ++idx) {
@@ -50,6 +203,37 @@ public:
         }
     }
 
+    /**
+     * @brief Remove every order matching @p pred in a single sweep of the ladder.
+     *
+     * Emptied levels are deactivated as the sweep passes them and the best level is
+     * fixed up once at the end, so a bulk purge costs one walk instead of one
+     * cancel per order.
+     *
+     * @param on_removed Callable receiving each unlinked `Order&`; may release it.
+     * @return Number of orders removed.
+     */
+    template <typename Pred, typename Fn>
+    std::size_t remove_if(Pred&& pred, Fn&& on_removed) {
+        std::size_t removed = 0;
+        // Group bookkeeping has to see a member while it is still queued.
+        const auto doomed = [&](const Order& order) {
+            if (!pred(order)) return false;
+            if (order.peg != types::PegType::None) unpeg(order);
+            return true;
+        };
+        for (std::size_t idx = 0; idx < levels_.size(); ++idx) {
+            if (!active_[idx]) continue;
+            removed += levels_[idx].remove_if(doomed, on_removed);
+            if (levels_[idx].empty()) {
+                active_[idx] = false;
+                --active_count_;
+            }
+        }
+        if (removed > 0 && (!best_index_ || !active_[*best_index_])) recompute_best();
+        return removed;
+    }
+
     /**
      * @brief Aggregate the quantity available at or better than @p limit_price.
      *
@@ -57,7 +241,7 @@ public:
      *
      * @param limit_price Price constraint supplied by the incoming order.
      * @param incoming_side Side of the incoming order (Buy or Sell).
-     * @return Total quantity resting within the acceptable price window.
+     * @return Total quantity, iceberg reserve included, resting within the acceptable price window.
      */
     types::Quantity available_to(types::Price limit_price, types::Side incoming_side) const;
 
@@ -67,6 +251,15 @@ private:
     std::size_t index_of(types::Price price) const noexcept { return static_cast<std::size_t>(price - min_price_); }
     types::Price price_at(std::size_t index) const noexcept { return static_cast<types::Price>(min_price_ + static_cast<types::Price>(index)); }
     void update_best_on_insert(std::size_t idx);
+    /// Ladder index of resting @p order, through its peg group when it has one.
+    std::size_t level_index(const Order& order) const noexcept {
+        return order.peg == types::PegType::None ? index_of(order.price) : pegs_[peg_slot(order.peg)].index;
+    }
+    static std::size_t peg_slot(types::PegType peg) noexcept { return static_cast<std::size_t>(peg) - 1; }
+    /// Drop @p order, still queued, from its peg group.
+    void unpeg(const Order& order) noexcept;
+    /// Visible quantity of the peg groups sitting at @p idx.
+    types::Quantity pegged_at(std::size_t idx) const noexcept;
     void recompute_best();
     std::size_t next_active_after(std::size_t idx) const noexcept;
     std::size_t prev_active_before(std::size_t idx) const noexcept;
@@ -78,6 +271,16 @@ private:
     std::vector<bool>       active_;
     std::size_t             active_count_{0};
     std::optional<std::size_t> best_index_{};
+
+    /// Pegged orders of one type: the run [first, last] of the FIFO at `index`.
+    struct PegGroup {
+        Order*          first{nullptr};
+        Order*          last{nullptr};
+        std::size_t     count{0};
+        types::Quantity quantity{0};
+        std::size_t     index{0};
+    };
+    std::array<PegGroup, 3> pegs_{}; ///< Indexed by `PegType` minus one.
 };
 
 } // namespace ob
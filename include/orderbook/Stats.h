@@ -0,0 +1,79 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <ostream>
+
+namespace ob {
+
+/**
+ * @brief Power-of-two histogram: bucket @c k counts values in [2^(k-1), 2^k).
+ *
+ * Coarse on purpose: recording is one `bit_width` and an increment, cheap enough for
+ * the matching path, and the shape is what matters when hunting pathological books.
+ */
+struct Log2Histogram {
+    std::array<std::uint64_t, 65> buckets{};
+    std::uint64_t count{0};
+    std::uint64_t sum{0};
+    std::uint64_t max{0};
+
+    void record(std::uint64_t value) noexcept {
+        ++buckets[static_cast<std::size_t>(std::bit_width(value))];
+        ++count;
+        sum += value;
+        if (value > max) max = value;
+    }
+
+    /// @return Upper bound of the bucket holding the @p pct percentile.
+    std::uint64_t percentile_bound(double pct) const noexcept;
+};
+
+/**
+ * @brief Hot-path counters for the books driven by one thread.
+ *
+ * Only populated when the library is built with `-DENABLE_BOOK_STATS=ON`; otherwise
+ * every hook compiles to nothing and the counters stay zero.
+ */
+struct BookStats {
+    std::uint64_t recompute_best_calls{0};
+    Log2Histogram recompute_best_scan;     ///< Ladder slots inspected per recompute.
+    std::uint64_t available_to_calls{0};
+    Log2Histogram available_to_levels;     ///< Levels visited per liquidity check.
+    std::uint64_t pool_exhausted{0};       ///< Orders rejected because the pool was full.
+    std::uint64_t ladder_growths{0};       ///< `ensure_price` calls that resized a ladder.
+    Log2Histogram fifo_depth_at_match;     ///< Orders queued at a level when it is hit.
+
+    void reset() noexcept { *this = BookStats{}; }
+
+    /// Write one line per counter in a stable `key=value` format.
+    void print(std::ostream& os) const;
+};
+
+namespace stats {
+
+#ifdef ENABLE_BOOK_STATS
+inline constexpr bool enabled = true;
+#else
+inline constexpr bool enabled = false;
+#endif
+
+/**
+ * @brief Counters for the calling thread.
+ *
+ * Thread-local and non-atomic: each engine worker owns exactly one book, so the
+ * worker's counters are that symbol's counters and recording never shares a line.
+ */
+BookStats& local() noexcept;
+
+} // namespace stats
+
+} // namespace ob
+
+/// Evaluate @p expr only in stats-enabled builds.
+#ifdef ENABLE_BOOK_STATS
+#define OB_STAT(expr) do { expr; } while (0)
+#else
+#define OB_STAT(expr) do { } while (0)
+#endif
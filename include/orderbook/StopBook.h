@@ -0,0 +1,120 @@
+#pragma once
+
+#include "orderbook/Order.h"
+#include "orderbook/PriceLevel.h"
+#include "orderbook/Types.h"
+
+#include <optional>
+#include <vector>
+
+namespace ob {
+
+/**
+ * @brief Pending stop orders for one side, laddered by stop price.
+ *
+ * Organised like @ref SideBook: a dense vector of @ref PriceLevel FIFOs indexed by
+ * integerised stop price plus an occupancy bitmap. Instead of a best index it keeps
+ * a frontier: no armed level lies nearer the market than it (below it for buy stops,
+ * above it for sell stops). @ref trigger walks from the frontier only across the levels
+ * the last trade price has crossed, so a trade that fires nothing costs one compare.
+ */
+class StopBook {
+public:
+    /**
+     * @brief Construct a trigger ladder covering @p [min_price, max_price].
+     * @param side Side of the stop orders held (buy stops fire on rising prices).
+     */
+    StopBook(types::Side side, types::Price min_price, types::Price max_price);
+
+    /// Construct an empty trigger ladder that starts at the first stop price armed.
+    explicit StopBook(types::Side side) : side_(side), min_price_(1), max_price_(0) {}
+
+    /// Arm @p order at its `stop_price`, expanding the ladder if needed.
+    void add(Order& order);
+
+    /// Disarm @p order (cancel before it fires).
+    void remove(Order& order);
+
+    /// Disarm @p first plus the orders queued behind it that satisfy @p extend; see @ref PriceLevel::remove_run.
+    template <typename Pred>
+    std::size_t remove_run(Order& first, Pred&& extend) {
+        const auto idx = index_of(first.stop_price);
+        auto& level = levels_[idx];
+        const std::size_t removed = level.remove_run(first, extend);
+        if (level.empty() && active_[idx]) {
+            active_[idx] = false;
+            if (--active_count_ == 0) frontier_.reset();
+        }
+        return removed;
+    }
+
+    /// Grow the ladder so every price in [@p low, @p high] is addressable.
+    void ensure_range(types::Price low, types::Price high);
+
+    /**
+     * @brief Disarm every order whose stop price @p last_trade has reached.
+     *
+     * Fired orders are appended to @p out nearest-to-market level first and in FIFO
+     * order within a level, which is the order they must re-enter the book in.
+     */
+    void trigger(types::Price last_trade, std::vector<Order*>& out);
+
+    /// @return True when no stop orders are armed.
+    bool empty() const noexcept { return active_count_ == 0; }
+
+    /// @return Lowest price currently addressable by the ladder.
+    types::Price min_price() const noexcept { return min_price_; }
+
+    /// @return Highest price currently addressable by the ladder.
+    types::Price max_price() const noexcept { return max_price_; }
+
+    template <typename Fn>
+    void for_each_level(Fn&& fn) const {
+        for (std::size_t idx = 0; idx < levels_.size(); ++idx) {
+            if (!active_[idx]) continue;
+            fn(levels_[idx]);
+        }
+    }
+
+    /**
+     * @brief Remove every order matching @p pred in a single sweep of the ladder.
+     *
+     * Emptied levels are deactivated as the sweep passes them and the frontier is
+     * fixed up once at the end, so a bulk purge costs one walk instead of one
+     * cancel per order.
+     *
+     * @param on_removed Callable receiving each unlinked `Order&`; may release it.
+     * @return Number of orders removed.
+     */
+    template <typename Pred, typename Fn>
+    std::size_t remove_if(Pred&& pred, Fn&& on_removed) {
+        std::size_t removed = 0;
+        for (std::size_t idx = 0; idx < levels_.size(); ++idx) {
+            if (!active_[idx]) continue;
+            removed += levels_[idx].remove_if(pred, on_removed);
+            if (levels_[idx].empty()) {
+                active_[idx] = false;
+                --active_count_;
+            }
+        }
+        if (active_count_ == 0) frontier_.reset();
+        return removed;
+    }
+
+private:
+    void ensure_price(types::Price price);
+    std::size_t index_of(types::Price price) const noexcept { return static_cast<std::size_t>(price - min_price_); }
+    types::Price price_at(std::size_t index) const noexcept { return static_cast<types::Price>(min_price_ + static_cast<types::Price>(index)); }
+    /// Fire every order queued at @p idx.
+    void drain(std::size_t idx, std::vector<Order*>& out);
+
+    types::Side side_;
+    types::Price min_price_;
+    types::Price max_price_;
+    std::vector<PriceLevel> levels_;
+    std::vector<bool>       active_;
+    std::size_t             active_count_{0};
+    std::optional<std::size_t> frontier_{};
+};
+
+} // namespace ob
@@ -0,0 +1,109 @@
+#pragma once
+
+#include "orderbook/Order.h"
+#include "orderbook/Types.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+namespace ob {
+
+/**
+ * @brief Hierarchical timing wheel holding order expiries.
+ *
+ * Four levels of 256 slots each cover 2^32 ticks; deadlines further out wait in an
+ * overflow list until the top level wraps. A node is filed at the level of the most
+ * significant byte in which its tick differs from the current one, so insert and
+ * remove are O(1) list operations and each node is cascaded at most once per level
+ * on its way down to level 0.
+ *
+ * The wheel has no clock of its own: @ref advance is driven by the caller with
+ * timestamps taken from the command stream, which keeps replays deterministic.
+ * Expiry is honoured at wheel resolution: a deadline is rounded up to the next tick.
+ */
+class TimingWheel {
+public:
+    /// @param resolution Nanoseconds per tick; the default is one millisecond.
+    explicit TimingWheel(types::Timestamp resolution = 1'000'000);
+
+    /**
+     * @brief File @p node to expire at @p expire_at (stored into its order's `expire_at`).
+     *
+     * A deadline already reached fires on the next @ref advance.
+     */
+    void insert(TimerNode& node, types::Timestamp expire_at) noexcept;
+
+    /// Unlink @p node (no-op when it is not scheduled).
+    void remove(TimerNode& node) noexcept {
+        if (node.slot == TimerNode::unlinked) return;
+        unlink(node);
+        --count_;
+    }
+
+    /**
+     * @brief Move the wheel to @p now, unlinking every node whose deadline has passed.
+     *
+     * @param on_expire Callable invoked as `on_expire(Order&)` for each expired node,
+     *        already unlinked, one tick at a time. It may insert or remove other nodes.
+     */
+    template <typename Fn>
+    void advance(types::Timestamp now, Fn&& on_expire) {
+        const std::uint64_t target = now / resolution_;
+        for (;;) {
+            while (TimerNode* node = heads_[kDue]) {
+                unlink(*node);
+                --count_;
+                on_expire(*node->order);
+            }
+            if (now_tick_ >= target) break;
+            const auto event = next_event();
+            if (!event || *event > target) {
+                now_tick_ = target;
+                break;
+            }
+            now_tick_ = *event;
+            cascade();
+        }
+        if (now > clock_) clock_ = now;
+    }
+
+    /// @return Latest timestamp passed to @ref advance.
+    types::Timestamp now() const noexcept { return clock_; }
+
+    /// Reset the clock to @p now without expiring anything (restore into an empty wheel).
+    void set_now(types::Timestamp now) noexcept;
+
+    /// @return Number of scheduled nodes.
+    std::size_t size() const noexcept { return count_; }
+
+private:
+    static constexpr unsigned      kLevelBits = 8;
+    static constexpr std::size_t   kSlots     = std::size_t{1} << kLevelBits;
+    static constexpr std::size_t   kLevels    = 4;
+    static constexpr std::uint16_t kOverflow  = kLevels * kSlots; ///< Deadlines beyond the top level.
+    static constexpr std::uint16_t kDue       = kOverflow + 1;     ///< Deadlines already reached.
+
+    /// Deadline of @p node in ticks, rounded up.
+    std::uint64_t tick_of(const TimerNode& node) const noexcept;
+    /// Link @p node into the bucket matching its tick relative to the current one.
+    void place(TimerNode& node) noexcept;
+    /// Tick of the earliest bucket that needs attention, or nullopt when the wheel is empty.
+    std::optional<std::uint64_t> next_event() const noexcept;
+    /// Re-file every bucket whose range starts at the current tick, moving reached deadlines to @ref kDue.
+    void cascade() noexcept;
+    /// Re-file the whole list in bucket @p bucket.
+    void refile(std::uint16_t bucket) noexcept;
+    void link(TimerNode& node, std::uint16_t bucket) noexcept;
+    void unlink(TimerNode& node) noexcept;
+
+    types::Timestamp resolution_;
+    types::Timestamp clock_{0};
+    std::uint64_t    now_tick_{0};
+    std::size_t      count_{0};
+    std::array<TimerNode*, kDue + 1> heads_{};
+    std::array<std::array<std::uint64_t, kSlots / 64>, kLevels> occupied_{};
+};
+
+} // namespace ob
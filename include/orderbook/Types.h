@@ -26,11 +26,56 @@ using Quantity = std::int64_t;
 /// Compact internal identifier assigned by the engine.
 using OrderId = std::uint64_t;
 
+/// Owner (client session) tag; orders sharing one can be pulled together. 0 = untagged.
+using OwnerId = std::uint32_t;
+
 /// Order side selection.
 enum class Side : std::uint8_t { Buy, Sell };
 
-/// Time-in-force semantics attached to an order.
-enum class TimeInForce : std::uint8_t { GFD, IOC, FOK };
+/// Book clock reading in nanoseconds, supplied by the command stream.
+using Timestamp = std::uint64_t;
+
+/**
+ * @brief Time-in-force semantics attached to an order.
+ *
+ * `GFD` orders live until cancelled or purged at end of day. `GTT` (good-till-time,
+ * also used for good-till-date) orders rest like `GFD` but expire once the book clock
+ * reaches their expiry time, and survive the end-of-day purge.
+ */
+enum class TimeInForce : std::uint8_t { GFD, IOC, FOK, GTT };
+
+/**
+ * @brief Order kind.
+ *
+ * `Market` orders carry no price and sweep the opposite side until filled or out of
+ * liquidity. `ProtectedMarket` orders stop at the best opposite price on entry plus
+ * the book's protection in ticks. Neither ever rests: the remainder is cancelled.
+ *
+ * `Stop` and `StopLimit` orders wait off-book until the last trade price reaches their
+ * stop price: buy stops fire when it trades at or above, sell stops at or below. A
+ * fired `Stop` enters as a `Market` order, a fired `StopLimit` as a `Limit` order with
+ * its own price and TIF.
+ */
+enum class OrderType : std::uint8_t { Limit, Stop, StopLimit, Market, ProtectedMarket };
+
+/**
+ * @brief Reference a pegged order's price follows.
+ *
+ * `Primary` tracks the best limit price on the order's own side, `Mid` the midpoint
+ * of the best limit bid and ask (rounded down for buys, up for sells) and `Market`
+ * the far touch, held one tick inside it so the order stays passive.
+ */
+enum class PegType : std::uint8_t { None, Primary, Mid, Market };
+
+/**
+ * @brief Self-trade prevention policy of a book.
+ *
+ * Applies when an incoming order would trade against a resting order carrying the
+ * same non-zero owner tag. `CancelResting` cancels the resting order and keeps
+ * matching, `CancelIncoming` cancels what is left of the incoming order, and
+ * `DecrementBoth` reduces both by the smaller quantity without printing a trade.
+ */
+enum class StpMode : std::uint8_t { None, CancelResting, CancelIncoming, DecrementBoth };
 
 /// Sentinel used when an order identifier is invalid or absent.
 inline constexpr OrderId invalid_order_id = static_cast<OrderId>(-1);
@@ -0,0 +1,134 @@
+#pragma once
+
+#include "orderbook/Types.h"
+
+#include <cstdint>
+#include <ostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace ob {
+class OrderBook;
+}
+
+namespace workload {
+
+/// Kind of request produced by @ref OrderFlow.
+enum class Action : std::uint8_t { New, Cancel, Amend };
+
+/// Arrival process driving event timestamps.
+enum class Arrivals : std::uint8_t { Poisson, Hawkes };
+
+/**
+ * @brief One generated request.
+ *
+ * `order` is the generator-assigned order ID: a fresh ID for `New`, the target for
+ * `Cancel`/`Amend`. IDs are unique across symbols so a stream can be replayed into
+ * one book per symbol or translated to client IDs verbatim.
+ */
+struct Event {
+    std::uint64_t              timestamp_ns{0};
+    std::uint32_t              symbol{0};
+    Action                     action{Action::New};
+    ob::types::Side            side{ob::types::Side::Buy};
+    ob::types::TimeInForce     tif{ob::types::TimeInForce::GFD};
+    ob::types::Price           price{0};
+    ob::types::Quantity        quantity{0};
+    ob::types::OrderId         order{0};
+};
+
+/**
+ * @brief Tunables for @ref OrderFlow; defaults approximate cancel-heavy market-maker flow.
+ *
+ * Ratios are per-event probabilities; whatever remains after cancel, amend and
+ * aggress is a passive GFD order. Cancels and amends fall back to a passive order when
+ * the chosen symbol has nothing live.
+ */
+struct Config {
+    std::uint64_t seed{1};
+    std::uint32_t symbols{1};
+    double        zipf_exponent{1.1};    ///< Symbol popularity: P(rank k) ∝ 1 / k^s.
+
+    Arrivals      arrivals{Arrivals::Poisson};
+    double        rate{1'000'000.0};     ///< Baseline events per second (Hawkes: background rate).
+    double        hawkes_alpha{600'000.0}; ///< Intensity jump per event (events/s).
+    double        hawkes_beta{1'000'000.0}; ///< Excitation decay rate (1/s); keep alpha < beta.
+
+    double        cancel_ratio{0.55};
+    double        amend_ratio{0.15};
+    double        aggress_ratio{0.05};
+    double        fok_share{0.2};        ///< Fraction of aggressive orders sent as FOK instead of IOC.
+
+    double        distance_exponent{1.6}; ///< Pareto tail of the passive distance from the touch.
+    ob::types::Price max_distance{1'000};
+    ob::types::Price start_mid{10'000};
+    double        drift_ticks{0.05};     ///< Per-event standard deviation of the mid random walk.
+    ob::types::Quantity max_quantity{100};
+};
+
+/**
+ * @brief Deterministic synthetic order-flow generator.
+ *
+ * Models the features uniform fuzzing hides: bursty arrivals (Poisson or a Hawkes
+ * self-exciting process simulated by Ogata thinning), passive prices at a power-law
+ * distance from a drifting mid so books are sparse and deep, cancel/amend traffic
+ * against the generator's own live orders, and Zipf-skewed symbol popularity. Two
+ * generators built from the same @ref Config emit identical streams.
+ *
+ * The generator does not simulate matching; a cancel may therefore target an order
+ * that has already traded, which the book and engine treat as a no-op, exactly as for
+ * a real client racing a fill.
+ */
+class OrderFlow {
+public:
+    explicit OrderFlow(const Config& config);
+
+    /// Produce the next event.
+    Event next();
+
+    /// Produce @p count events.
+    std::vector<Event> generate(std::size_t count);
+
+    /// @return Current integer mid of @p symbol.
+    ob::types::Price mid(std::uint32_t symbol) const noexcept;
+
+    /// @return Lowest price any event can carry; useful for sizing a book.
+    ob::types::Price min_price() const noexcept;
+    ob::types::Price max_price() const noexcept;
+
+    const Config& config() const noexcept { return config_; }
+
+    /// Stable symbol name for index @p symbol ("S0", "S1", ...).
+    static std::string symbol_name(std::uint32_t symbol);
+
+    /// Write @p event as one `engine` text command line.
+    static void write_text(std::ostream& os, const Event& event);
+
+    /// Apply @p event to @p book using the generator's IDs as internal order IDs.
+    static void apply(ob::OrderBook& book, const Event& event);
+
+private:
+    struct SymbolState {
+        double                          mid{0.0};
+        std::vector<ob::types::OrderId> live;
+        std::vector<ob::types::Side>    live_side;
+    };
+
+    std::uint64_t    next_arrival();
+    std::uint32_t    pick_symbol();
+    ob::types::Price passive_price(const SymbolState& state, ob::types::Side side);
+    void             fill_new(Event& event, SymbolState& state);
+
+    Config                                 config_;
+    std::mt19937_64                        rng_;
+    std::uniform_real_distribution<double> unit_{0.0, 1.0};
+    std::normal_distribution<double>       drift_{0.0, 1.0};
+    std::vector<double>                    zipf_cdf_;
+    std::vector<SymbolState>               symbols_;
+    double                                 now_s_{0.0};
+    double                                 excitation_{0.0};
+    ob::types::OrderId                     next_id_{0};
+};
+
+} // namespace workload
@@ -0,0 +1,171 @@
+#include "engine/BinaryProtocol.h"
+
+#include <cstring>
+
+namespace engine::wire {
+
+namespace {
+
+/// @return Fixed wire size for @p type, or 0 when the type is unknown.
+std::size_t expected_length(MessageType type) noexcept {
+    switch (type) {
+        case MessageType::SymbolDefinition: return sizeof(SymbolDefinition);
+        case MessageType::NewOrder:         return sizeof(NewOrder);
+        case MessageType::Cancel:           return sizeof(Cancel);
+        case MessageType::Modify:           return sizeof(Modify);
+        case MessageType::Print:            return sizeof(Print);
+        case MessageType::MassCancel:       return sizeof(MassCancel);
+    }
+    return 0;
+}
+
+bool valid_payload(const MessageHeader& header) noexcept {
+    constexpr auto max_side = static_cast<std::uint8_t>(ob::types::Side::Sell);
+    constexpr auto max_tif  = static_cast<std::uint8_t>(ob::types::TimeInForce::FOK);
+    switch (header.type) {
+        case MessageType::SymbolDefinition: {
+            const auto& msg = reinterpret_cast<const SymbolDefinition&>(header);
+            return header.symbol < max_symbols && msg.name_length > 0 && msg.name_length <= sizeof(msg.name);
+        }
+        case MessageType::NewOrder: {
+            const auto& msg = reinterpret_cast<const NewOrder&>(header);
+            return msg.side <= max_side && msg.tif <= max_tif && msg.quantity > 0;
+        }
+        case MessageType::Modify: {
+            const auto& msg = reinterpret_cast<const Modify&>(header);
+            return msg.side <= max_side && msg.quantity > 0;
+        }
+        case MessageType::MassCancel: {
+            const auto& msg = reinterpret_cast<const MassCancel&>(header);
+            return msg.owner != 0 && (!(msg.flags & HasSide) || msg.side <= max_side);
+        }
+        case MessageType::Cancel:
+        case MessageType::Print:
+            return true;
+    }
+    return false;
+}
+
+template <typename Msg>
+void append(std::vector<char>& out, const Msg& msg) {
+    const auto* bytes = reinterpret_cast<const char*>(&msg);
+    out.insert(out.end(), bytes, bytes + sizeof(msg));
+}
+
+} // namespace
+
+const MessageHeader* decode(const char* data, std::size_t available, DecodeStatus& status) noexcept {
+    if (available < sizeof(MessageHeader)) {
+        status = DecodeStatus::NeedMore;
+        return nullptr;
+    }
+    if (reinterpret_cast<std::uintptr_t>(data) % alignment != 0) {
+        status = DecodeStatus::Invalid;
+        return nullptr;
+    }
+    const auto* header = reinterpret_cast<const MessageHeader*>(data);
+    const auto expected = expected_length(header->type);
+    if (header->version != wire::version || expected == 0 || header->length != expected) {
+        status = DecodeStatus::Invalid;
+        return nullptr;
+    }
+    if (available < header->length) {
+        status = DecodeStatus::NeedMore;
+        return nullptr;
+    }
+    status = valid_payload(*header) ? DecodeStatus::Ok : DecodeStatus::Rejected;
+    return header;
+}
+
+bool BinaryEncoder::encode(std::uint32_t symbol, const CommandRef& cmd, std::uint64_t client_id, std::vector<char>& out) {
+    if (symbol >= max_symbols) return false;
+    while (defined_ <= symbol) {
+        const auto& name = symbols_.name(static_cast<std::uint32_t>(defined_));
+        SymbolDefinition def{};
+        if (name.empty() || name.size() > sizeof(def.name)) return false;
+        def.header      = make_header<SymbolDefinition>(MessageType::SymbolDefinition, static_cast<std::uint32_t>(defined_));
+        def.name_length = static_cast<std::uint8_t>(name.size());
+        std::memcpy(def.name, name.data(), name.size());
+        append(out, def);
+        ++defined_;
+    }
+
+    switch (cmd.type) {
+        case Command::Type::Buy:
+        case Command::Type::Sell: {
+            // No wire form for stops, icebergs, GTT or pegged orders yet.
+            if (cmd.order_type != ob::types::OrderType::Limit || cmd.display > 0
+                || cmd.tif == ob::types::TimeInForce::GTT || cmd.peg != ob::types::PegType::None) {
+                return false;
+            }
+            NewOrder msg{};
+            msg.header    = make_header<NewOrder>(MessageType::NewOrder, symbol);
+            msg.client_id = client_id;
+            msg.price     = cmd.price;
+            msg.quantity  = cmd.qty;
+            msg.side      = static_cast<std::uint8_t>(cmd.side);
+            msg.tif       = static_cast<std::uint8_t>(cmd.tif);
+            msg.owner     = cmd.owner;
+            if (cmd.min_qty) {
+                msg.flags  |= HasMinQty;
+                msg.min_qty = *cmd.min_qty;
+            }
+            append(out, msg);
+            return true;
+        }
+        case Command::Type::Cancel: {
+            Cancel msg{};
+            msg.header    = make_header<Cancel>(MessageType::Cancel, symbol);
+            msg.client_id = client_id;
+            append(out, msg);
+            return true;
+        }
+        case Command::Type::Modify: {
+            Modify msg{};
+            msg.header    = make_header<Modify>(MessageType::Modify, symbol);
+            msg.client_id = client_id;
+            msg.price     = cmd.price;
+            msg.quantity  = cmd.qty;
+            msg.side      = static_cast<std::uint8_t>(cmd.side);
+            if (cmd.min_qty) {
+                msg.flags  |= HasMinQty;
+                msg.min_qty = *cmd.min_qty;
+            }
+            append(out, msg);
+            return true;
+        }
+        case Command::Type::Print: {
+            Print msg{};
+            msg.header = make_header<Print>(MessageType::Print, symbol);
+            append(out, msg);
+            return true;
+        }
+        case Command::Type::MassCancel: {
+            MassCancel msg{};
+            msg.header = make_header<MassCancel>(MessageType::MassCancel, symbol);
+            msg.owner  = cmd.owner;
+            if (cmd.cancel_side) {
+                msg.flags |= HasSide;
+                msg.side   = static_cast<std::uint8_t>(*cmd.cancel_side);
+            }
+            if (cmd.cancel_range) {
+                msg.flags |= HasRange;
+                msg.low    = cmd.cancel_range->low;
+                msg.high   = cmd.cancel_range->high;
+            }
+            append(out, msg);
+            return true;
+        }
+        default:
+            return false;
+    }
+}
+
+void BinaryParser::define(const SymbolDefinition& msg) {
+    if (msg.header.symbol >= remap_.size()) {
+        remap_.resize(static_cast<std::size_t>(msg.header.symbol) + 1, SymbolTable::npos);
+    }
+    remap_[msg.header.symbol] = symbols_.intern(std::string_view(msg.name, msg.name_length));
+}
+
+} // namespace engine::wire
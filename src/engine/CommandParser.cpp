@@ -0,0 +1,170 @@
+#include "engine/CommandParser.h"
+
+#include <charconv>
+#include <cstdint>
+
+namespace engine {
+
+namespace {
+
+/// Cursor over a single line that yields whitespace-separated tokens.
+class Tokenizer {
+public:
+    explicit Tokenizer(std::string_view line) noexcept
+        : cur_(line.data()), end_(line.data() + line.size()) {}
+
+    /// @return Next token, or an empty view once the line is exhausted.
+    std::string_view next() noexcept {
+        while (cur_ < end_ && is_space(*cur_)) ++cur_;
+        const char* start = cur_;
+        while (cur_ < end_ && !is_space(*cur_)) ++cur_;
+        return std::string_view(start, static_cast<std::size_t>(cur_ - start));
+    }
+
+    /// Decode the next token as a signed integer; fails on trailing garbage.
+    bool next_int(std::int64_t& value) noexcept {
+        auto token = next();
+        if (token.empty()) return false;
+        const char* first = token.data();
+        if (*first == '+') ++first;
+        auto [ptr, ec] = std::from_chars(first, token.data() + token.size(), value);
+        return ec == std::errc{} && ptr == token.data() + token.size();
+    }
+
+private:
+    static bool is_space(char c) noexcept { return c == ' ' || c == '\t' || c == '\r'; }
+
+    const char* cur_;
+    const char* end_;
+};
+
+/// Consume trailing `MIN`, `DISPLAY`, `UNTIL`, `OWNER`, `PEG`, `STOP`, `STOPLIMIT`, `MARKET` and `PROTECTED` options, mirroring the permissive legacy parser.
+void parse_options(Tokenizer& tokens, CommandRef& out) noexcept {
+    for (auto token = tokens.next(); !token.empty(); token = tokens.next()) {
+        if (token == "MIN") {
+            std::int64_t value = 0;
+            if (tokens.next_int(value)) out.min_qty = value;
+        } else if (token == "DISPLAY") {
+            std::int64_t value = 0;
+            if (tokens.next_int(value)) out.display = value;
+        } else if (token == "OWNER") {
+            std::int64_t value = 0;
+            if (tokens.next_int(value) && value > 0 && value <= UINT32_MAX) out.owner = static_cast<ob::types::OwnerId>(value);
+        } else if (token == "UNTIL") {
+            std::int64_t value = 0;
+            if (tokens.next_int(value) && value > 0) out.timestamp = static_cast<ob::types::Timestamp>(value);
+        } else if (token == "PEG") {
+            const auto kind = tokens.next();
+            if (kind == "PRIMARY") out.peg = ob::types::PegType::Primary;
+            else if (kind == "MID") out.peg = ob::types::PegType::Mid;
+            else if (kind == "MARKET") out.peg = ob::types::PegType::Market;
+        } else if (token == "STOP" || token == "STOPLIMIT") {
+            std::int64_t value = 0;
+            if (!tokens.next_int(value)) continue;
+            out.order_type = token == "STOP" ? ob::types::OrderType::Stop : ob::types::OrderType::StopLimit;
+            out.stop_price = value;
+        } else if (token == "MARKET") {
+            out.order_type = ob::types::OrderType::Market;
+        } else if (token == "PROTECTED") {
+            out.order_type = ob::types::OrderType::ProtectedMarket;
+        }
+    }
+}
+
+} // namespace
+
+std::uint32_t SymbolTable::intern(std::string_view name) {
+    if (auto it = index_.find(name); it != index_.end()) return it->second;
+    const auto index = static_cast<std::uint32_t>(names_.size());
+    names_.emplace_back(name);
+    index_.emplace(names_.back(), index);
+    return index;
+}
+
+std::uint32_t SymbolTable::find(std::string_view name) const noexcept {
+    auto it = index_.find(name);
+    return it == index_.end() ? npos : it->second;
+}
+
+bool CommandParser::parse_line(std::string_view line, std::uint32_t& symbol, CommandRef& out) {
+    Tokenizer tokens(line);
+    const auto symbol_text = tokens.next();
+    const auto verb = tokens.next();
+    if (verb.empty()) return false;
+
+    out = CommandRef{};
+    if (verb == "BUY" || verb == "SELL") {
+        const auto tif_text = tokens.next();
+        if (tif_text.empty()) return false;
+        if (!tokens.next_int(out.price) || !tokens.next_int(out.qty)) return false;
+        out.id = tokens.next();
+        if (out.id.empty()) return false;
+
+        out.tif = ob::types::TimeInForce::GFD;
+        if (tif_text == "IOC") out.tif = ob::types::TimeInForce::IOC;
+        else if (tif_text == "FOK") out.tif = ob::types::TimeInForce::FOK;
+        else if (tif_text == "GTT") out.tif = ob::types::TimeInForce::GTT;
+        const bool buy = verb == "BUY";
+        out.type = buy ? Command::Type::Buy : Command::Type::Sell;
+        out.side = buy ? ob::types::Side::Buy : ob::types::Side::Sell;
+        parse_options(tokens, out);
+    } else if (verb == "CANCEL") {
+        out.type = Command::Type::Cancel;
+        out.id = tokens.next();
+        if (out.id.empty()) return false;
+    } else if (verb == "MODIFY") {
+        out.type = Command::Type::Modify;
+        out.id = tokens.next();
+        const auto side_text = tokens.next();
+        if (out.id.empty() || side_text.empty()) return false;
+        if (!tokens.next_int(out.price) || !tokens.next_int(out.qty)) return false;
+        out.side = side_text == "BUY" ? ob::types::Side::Buy : ob::types::Side::Sell;
+        parse_options(tokens, out);
+    } else if (verb == "CHECKPOINT") {
+        out.type = Command::Type::Checkpoint;
+        out.id = tokens.next();
+        if (out.id.empty()) return false;
+    } else if (verb == "BARS") {
+        out.type = Command::Type::Bars;
+        out.id = tokens.next();
+        if (out.id.empty()) return false;
+    } else if (verb == "PRINT") {
+        out.type = Command::Type::Print;
+    } else if (verb == "STATS") {
+        out.type = Command::Type::Stats;
+    } else if (verb == "TIME") {
+        std::int64_t now = 0;
+        if (!tokens.next_int(now) || now < 0) return false;
+        out.type = Command::Type::Time;
+        out.timestamp = static_cast<ob::types::Timestamp>(now);
+    } else if (verb == "EOD") {
+        out.type = Command::Type::EndOfDay;
+    } else if (verb == "AUCTION") {
+        out.type = Command::Type::Auction;
+    } else if (verb == "UNCROSS") {
+        out.type = Command::Type::Uncross;
+    } else if (verb == "MASSCANCEL") {
+        std::int64_t owner = 0;
+        if (!tokens.next_int(owner) || owner <= 0 || owner > UINT32_MAX) return false;
+        out.type = Command::Type::MassCancel;
+        out.owner = static_cast<ob::types::OwnerId>(owner);
+        auto token = tokens.next();
+        if (token == "BUY" || token == "SELL") {
+            out.cancel_side = token == "BUY" ? ob::types::Side::Buy : ob::types::Side::Sell;
+            token = tokens.next();
+        }
+        if (!token.empty()) {
+            ob::PriceRange range;
+            Tokenizer low(token);
+            if (!low.next_int(range.low) || !tokens.next_int(range.high)) return false;
+            out.cancel_range = range;
+        }
+    } else {
+        return false;
+    }
+
+    symbol = symbols_.intern(symbol_text);
+    return true;
+}
+
+} // namespace engine
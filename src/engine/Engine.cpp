@@ -1,7 +1,11 @@
 #include "engine/Engine.h"
 #include "orderbook/Order.h"
 
+#include <algorithm>
+#include <cstdint>
 #include <cstdio>
+#include <cstring>
+#include <fstream>
 
 namespace engine {
 
@@ -9,130 +13,570 @@ EngineApp::EngineApp(std::string symbol,
                      ob::types::Price min_price,
                      ob::types::Price max_price,
                      std::size_t pool_capacity)
-    : symbol_(std::move(symbol))
-    , book_(min_price, max_price, pool_capacity)
+    : lanes_(1)
+    , book_(std::make_unique<ob::OrderBook>(min_price, max_price, pool_capacity))
     , ingress_(2048)
     , worker_([this] { process(); })
     , log_queue_(2048)
     , log_thread_([this] { run_logger(); })
 {
-    book_.set_trade_sink(&EngineApp::trade_sink, this);
+    lanes_[0].symbol = std::move(symbol);
+    lanes_[0].book   = book_.get();
+    book_->set_trade_sink(&EngineApp::trade_sink, this);
+}
+
+EngineApp::EngineApp(std::string symbol, const Instrument& instrument)
+    : EngineApp(std::move(symbol), instrument.min_tick(), instrument.max_tick(), instrument.open_interest) {
+    // The worker reads these only for commands, which are submitted after construction.
+    lanes_[0].tick_size = instrument.tick_size;
+    lanes_[0].band_low  = instrument.min_price;
+    lanes_[0].band_high = instrument.max_price;
+}
+
+EngineApp::EngineApp(std::uint32_t lanes, std::size_t pool_capacity)
+    : lanes_(lanes)
+    , books_(std::make_unique<ob::BookSet>(pool_capacity))
+    , ingress_(2048)
+    , worker_([this] { process(); })
+    , log_queue_(2048)
+    , log_thread_([this] { run_logger(); })
+{}
+
+bool EngineApp::add_symbol(std::uint32_t lane, std::string symbol, const Instrument* instrument) {
+    if (lane >= lanes_.size()) return false;
+    // Like the single-symbol fields, these are published to the worker by the lane's first command.
+    Lane& target  = lanes_[lane];
+    target.symbol = std::move(symbol);
+    if (instrument) {
+        target.tick_size = instrument->tick_size;
+        target.band_low  = instrument->min_price;
+        target.band_high = instrument->max_price;
+    }
+    return true;
 }
 
 EngineApp::~EngineApp() {
     running_.store(false, std::memory_order_release);
     if (worker_.joinable()) worker_.join();
+    // The writer finishes queued files first so the logger can report their failures.
+    if (checkpoint_writer_.joinable()) checkpoint_writer_.join();
+    worker_done_.store(true, std::memory_order_release);
     if (log_thread_.joinable()) log_thread_.join();
 }
 
 bool EngineApp::submit(Command cmd) {
-    switch (cmd.type) {
+    CommandRef ref;
+    ref.type    = cmd.type;
+    ref.id      = cmd.id;
+    ref.price   = cmd.price;
+    ref.qty     = cmd.qty;
+    ref.side    = cmd.side;
+    ref.tif     = cmd.tif;
+    ref.min_qty = cmd.min_qty;
+    ref.order_type = cmd.order_type;
+    ref.stop_price = cmd.stop_price;
+    ref.display    = cmd.display;
+    ref.timestamp  = cmd.timestamp;
+    ref.owner        = cmd.owner;
+    ref.peg          = cmd.peg;
+    ref.cancel_side  = cmd.cancel_side;
+    ref.cancel_range = cmd.cancel_range;
+    return submit(cmd.lane, ref);
+}
+
+bool EngineApp::submit(std::uint32_t lane_index, const CommandRef& ref) {
+    if (lane_index >= lanes_.size()) return false;
+    const Lane& lane = lanes_[lane_index];
+    Command cmd;
+    cmd.lane    = lane_index;
+    cmd.type    = ref.type;
+    cmd.price   = ref.price;
+    cmd.qty     = ref.qty;
+    cmd.side    = ref.side;
+    cmd.tif     = ref.tif;
+    cmd.min_qty = ref.min_qty;
+    cmd.order_type = ref.order_type;
+    cmd.stop_price = ref.stop_price;
+    cmd.display    = ref.display;
+    cmd.timestamp  = ref.timestamp;
+    cmd.owner        = ref.owner;
+    cmd.peg          = ref.peg;
+    cmd.cancel_side  = ref.cancel_side;
+    cmd.cancel_range = ref.cancel_range;
+
+    switch (ref.type) {
         case Command::Type::Buy:
         case Command::Type::Sell: {
-            cmd.internal_id = assign_order_id(cmd.id);
-            if (book_.has_order(cmd.internal_id)) {
+            // Pegged and market orders have no price to value until they reach the book.
+            const bool unpriced = ref.peg != ob::types::PegType::None
+                               || ref.order_type == ob::types::OrderType::Market
+                               || ref.order_type == ob::types::OrderType::ProtectedMarket;
+            const ob::types::Price valued_at = unpriced ? 0
+                                             : ref.order_type == ob::types::OrderType::Stop ? ref.stop_price
+                                             : ref.price;
+            auto reason = lane.risk.check_order(valued_at, ref.qty);
+            const bool limit_priced = ref.peg == ob::types::PegType::None
+                                   && (ref.order_type == ob::types::OrderType::Limit
+                                       || ref.order_type == ob::types::OrderType::StopLimit);
+            const bool stop_priced = ref.order_type == ob::types::OrderType::Stop
+                                  || ref.order_type == ob::types::OrderType::StopLimit;
+            if (reason == RejectReason::None && limit_priced) reason = to_ticks(lane, cmd.price);
+            if (reason == RejectReason::None && stop_priced) reason = to_ticks(lane, cmd.stop_price);
+            if (reason != RejectReason::None) {
+                cmd.type   = Command::Type::Reject;
+                cmd.reject = reason;
+                cmd.id.assign(ref.id);
+                enqueue(std::move(cmd));
                 return false;
             }
+            // Live-duplicate checks happen on the worker: the book belongs to that thread.
+            cmd.internal_id = assign_order_id(id_key(lane_index, ref.id), ref.id);
+            cmd.owner       = accounts_.intern(ref.owner);
             break;
         }
-        case Command::Type::Cancel: {
-            auto internal = find_order_id(cmd.id);
-            if (!internal || !book_.has_order(*internal)) return false;
-            cmd.internal_id = *internal;
-            break;
-        }
+        case Command::Type::Cancel:
         case Command::Type::Modify: {
-            auto internal = find_order_id(cmd.id);
-            if (!internal || !book_.has_order(*internal)) return false;
+            auto internal = find_order_id(id_key(lane_index, ref.id));
+            if (!internal) return false;
+            if (ref.type == Command::Type::Modify) {
+                auto reason = lane.risk.check_order(ref.price, ref.qty);
+                if (reason == RejectReason::None) reason = to_ticks(lane, cmd.price);
+                if (reason != RejectReason::None) {
+                    cmd.type   = Command::Type::Reject;
+                    cmd.reject = reason;
+                    cmd.id.assign(ref.id);
+                    enqueue(std::move(cmd));
+                    return false;
+                }
+            }
             cmd.internal_id = *internal;
             break;
         }
+        case Command::Type::Reject:
+            return false; // produced by the risk stage only
+        case Command::Type::MassCancel:
+            cmd.owner = accounts_.find(ref.owner);
+            if (cmd.owner == 0) return false; // no order was ever tagged with it
+            if (cmd.cancel_range) {
+                cmd.cancel_range->low  = ceil_ticks(cmd.cancel_range->low, lane.tick_size);
+                cmd.cancel_range->high = floor_ticks(cmd.cancel_range->high, lane.tick_size);
+            }
+            break;
         case Command::Type::Print:
+        case Command::Type::Stats:
+        case Command::Type::Time:
+        case Command::Type::EndOfDay:
+        case Command::Type::Auction:
+        case Command::Type::Uncross:
+            break;
+        case Command::Type::Checkpoint:
+            if (books_) return false; // the group's books share one pool and ID index
+            // Every ID assigned so far belongs to a command queued ahead of this one. The
+            // table is copied here because only this thread appends to it.
+            cmd.ids = serialise_ids(next_internal_id_);
+            cmd.id.assign(ref.id);
+            break;
+        case Command::Type::Bars:
+            cmd.id.assign(ref.id);
             break;
     }
 
-    while (!ingress_.push(cmd)) {
+    enqueue(std::move(cmd));
+    return true;
+}
+
+RejectReason EngineApp::to_ticks(const Lane& lane, ob::types::Price& price) noexcept {
+    if (price < lane.band_low || price > lane.band_high) return RejectReason::Band;
+    if (lane.tick_size == 1) return RejectReason::None;
+    if (price % lane.tick_size != 0) return RejectReason::Tick;
+    price /= lane.tick_size;
+    return RejectReason::None;
+}
+
+void EngineApp::enqueue(Command&& cmd) {
+    while (!ingress_.push(std::move(cmd))) {
         std::this_thread::yield();
     }
-    return true;
 }
 
 void EngineApp::process() {
-    while (running_.load(std::memory_order_acquire)) {
+    for (;;) {
         auto cmd = ingress_.pop();
         if (!cmd) {
-            std::this_thread::yield();
-            continue;
+            // Drain everything submitted before shutdown so trailing commands are not lost.
+            if (!running_.load(std::memory_order_acquire)) {
+                cmd = ingress_.pop();
+                if (!cmd) break;
+            } else {
+                std::this_thread::yield();
+                continue;
+            }
         }
+        Lane& lane = open_lane(cmd->lane);
+        ob::OrderBook& book = *lane.book;
+        current_ = &lane;
         switch (cmd->type) {
             case Command::Type::Buy:
             case Command::Type::Sell:
-                book_.create_order(cmd->internal_id,
-                                   cmd->price,
-                                   cmd->qty,
-                                   cmd->side,
-                                   cmd->tif,
-                                   cmd->min_qty);
+                if (const auto reason = check_live(lane, *cmd); reason != RejectReason::None) {
+                    publish_reject(lane, to_client_id(cmd->internal_id), reason);
+                    break;
+                }
+                book.create_order(ob::OrderSpec{cmd->internal_id,
+                                                 cmd->price,
+                                                 cmd->qty,
+                                                 cmd->side,
+                                                 cmd->tif,
+                                                 cmd->min_qty,
+                                                 cmd->order_type,
+                                                 cmd->stop_price,
+                                                 cmd->display,
+                                                 cmd->timestamp,
+                                                 cmd->owner,
+                                                 cmd->peg});
                 break;
             case Command::Type::Cancel:
-                book_.cancel(cmd->internal_id);
+                book.cancel(cmd->internal_id);
                 break;
             case Command::Type::Modify: {
-                const ob::Order* existing = book_.find(cmd->internal_id);
+                const ob::Order* existing = book.find(cmd->internal_id);
                 if (!existing) break;
+                if (const auto reason = check_live(lane, *cmd); reason != RejectReason::None) {
+                    publish_reject(lane, to_client_id(cmd->internal_id), reason);
+                    break;
+                }
                 auto tif = existing->tif;
                 std::optional<ob::types::Quantity> min_qty = cmd->min_qty;
                 if (!min_qty && existing->has_min_qty) {
                     min_qty = existing->min_qty;
                 }
-                book_.modify(cmd->internal_id,
-                             cmd->side,
-                             cmd->price,
-                             cmd->qty,
-                             tif,
-                             min_qty);
+                book.modify(cmd->internal_id,
+                            cmd->side,
+                            cmd->price,
+                            cmd->qty,
+                            tif,
+                            min_qty);
                 break;
             }
             case Command::Type::Print:
-                std::cout << "Symbol: " << symbol_ << '\n';
-                book_.snapshot(std::cout);
+                std::cout << "Symbol: " << lane.symbol << '\n';
+                book.snapshot(std::cout, lane.tick_size);
+                break;
+            case Command::Type::Checkpoint:
+                take_checkpoint(cmd->id, cmd->ids);
+                break;
+            case Command::Type::Stats:
+                // Counters are thread-local: a grouped worker reports them for all its lanes.
+                std::cout << "Symbol: " << lane.symbol << " STATS\n";
+                {
+                    const SymbolStats session = lane.market_stats.read();
+                    std::cout << "session open=" << session.open << " high=" << session.high
+                              << " low=" << session.low << " close=" << session.close
+                              << " volume=" << session.volume << " vwap=" << session.vwap()
+                              << " trades=" << session.trades << " imbalance=" << session.imbalance() << '\n';
+                }
+                ob::OrderBook::stats().print(std::cout);
+                break;
+            case Command::Type::Time:
+                book.advance_time(cmd->timestamp);
+                lane.market_stats.roll(book.now());
+                break;
+            case Command::Type::EndOfDay:
+                book.end_of_day();
+                break;
+            case Command::Type::MassCancel:
+                book.mass_cancel(cmd->owner, cmd->cancel_side, cmd->cancel_range);
                 break;
+            case Command::Type::Auction:
+                book.begin_auction();
+                break;
+            case Command::Type::Uncross:
+                book.uncross();
+                break;
+            case Command::Type::Reject:
+                publish_reject(lane, cmd->id, cmd->reject);
+                break;
+            case Command::Type::Bars:
+                export_bars(lane, cmd->id);
+                break;
+        }
+        if (lane.risk.collared()) refresh_collar(lane);
+        publish_stats(lane);
+    }
+}
+
+EngineApp::Lane& EngineApp::open_lane(std::uint32_t index) {
+    Lane& lane = lanes_[index];
+    if (!lane.book) {
+        // An empty book with no expiry wheel; it grows with the prices it sees.
+        lane.book = &books_->open(index);
+        lane.book->set_trade_sink(&EngineApp::trade_sink, this);
+        lane.book->set_stp_mode(lane.stp);
+        lane.book->set_market_protection(lane.market_protection);
+        refresh_collar(lane);
+    }
+    return lane;
+}
+
+void EngineApp::publish_stats(Lane& lane) noexcept {
+    const ob::OrderBook& book = *lane.book;
+    const auto bid = book.best_bid();
+    const auto ask = book.best_ask();
+    lane.market_stats.on_quote(bid.value_or(0) * lane.tick_size, book.best_bid_quantity(),
+                               ask.value_or(0) * lane.tick_size, book.best_ask_quantity());
+    lane.market_stats.publish(book.now());
+}
+
+void EngineApp::export_bars(Lane& lane, const std::string& path) {
+    const std::vector<Bar> bars = lane.market_stats.take_bars();
+    std::vector<char> image(bars.size() * sizeof(Bar));
+    if (!bars.empty()) std::memcpy(image.data(), bars.data(), image.size());
+    write_async(lane.symbol, path, std::move(image));
+}
+
+void EngineApp::set_risk_limits(const RiskLimits& limits) noexcept {
+    for (Lane& lane : lanes_) {
+        lane.risk = RiskGate(limits);
+        if (lane.book) refresh_collar(lane);
+    }
+}
+
+RejectReason EngineApp::check_live(const Lane& lane, const Command& cmd) noexcept {
+    // A modify replaces its order: the account's exposure is measured without it. Owners
+    // are dense account IDs by now, so the exposure lookup is one bounded array read.
+    ob::types::OwnerId owner = cmd.owner;
+    ob::types::Quantity replaced = 0;
+    bool collared = cmd.peg == ob::types::PegType::None
+                 && (cmd.order_type == ob::types::OrderType::Limit || cmd.order_type == ob::types::OrderType::StopLimit);
+    if (cmd.type == Command::Type::Modify) {
+        const ob::Order* existing = lane.book->find(cmd.internal_id);
+        owner    = existing->owner;
+        replaced = existing->quantity + existing->hidden;
+        collared = existing->type != ob::types::OrderType::Stop; // an armed stop-market has no price
+    }
+    const ob::types::Quantity open = owner != 0 ? lane.book->open_quantity(owner) - replaced : 0;
+    return lane.risk.check_live(cmd.price, collared, open, owner != 0 ? cmd.qty : 0);
+}
+
+void EngineApp::refresh_collar(Lane& lane) noexcept {
+    const ob::OrderBook& book = *lane.book;
+    std::optional<ob::types::Price> reference = book.last_trade_price();
+    if (!reference) {
+        const auto bid = book.best_bid();
+        const auto ask = book.best_ask();
+        if (bid && ask) reference = *bid + (*ask - *bid) / 2;
+    }
+    lane.risk.set_reference(reference);
+}
+
+void EngineApp::take_checkpoint(const std::string& path, const std::vector<char>& ids) {
+    // File layout: [u64 book bytes][book checkpoint][u64 id count]([u32 len][bytes])*
+    //              [u64 account count]([u32 owner tag])*
+    std::vector<char> book_bytes;
+    book_->checkpoint(book_bytes);
+
+    std::vector<char> image(sizeof(std::uint64_t) + book_bytes.size() + ids.size());
+    const std::uint64_t book_len = book_bytes.size();
+    std::memcpy(image.data(), &book_len, sizeof(book_len));
+    std::memcpy(image.data() + sizeof(book_len), book_bytes.data(), book_bytes.size());
+    std::memcpy(image.data() + sizeof(book_len) + book_bytes.size(), ids.data(), ids.size());
+
+    write_async(lanes_[0].symbol, path, std::move(image));
+}
+
+std::vector<char> EngineApp::serialise_ids(ob::types::OrderId id_watermark) const {
+    std::size_t size = 2 * sizeof(std::uint64_t) + accounts_.size() * sizeof(ob::types::OwnerId);
+    for (ob::types::OrderId id = 0; id < id_watermark; ++id) {
+        size += sizeof(std::uint32_t) + to_client_id(id).size();
+    }
+
+    std::vector<char> out(size);
+    char* cursor = out.data();
+    auto put = [&cursor](const void* src, std::size_t len) {
+        std::memcpy(cursor, src, len);
+        cursor += len;
+    };
+    const std::uint64_t id_count = id_watermark;
+    put(&id_count, sizeof(id_count));
+    for (ob::types::OrderId id = 0; id < id_watermark; ++id) {
+        const std::string& client = to_client_id(id);
+        const auto len = static_cast<std::uint32_t>(client.size());
+        put(&len, sizeof(len));
+        put(client.data(), client.size());
+    }
+    // Books store dense account IDs; the tags are listed in ID order, from 1.
+    const std::uint64_t account_count = accounts_.size();
+    put(&account_count, sizeof(account_count));
+    for (std::size_t account = 1; account <= accounts_.size(); ++account) {
+        const ob::types::OwnerId tag = accounts_.tag(static_cast<ob::types::OwnerId>(account));
+        put(&tag, sizeof(tag));
+    }
+    return out;
+}
+
+void EngineApp::write_async(const std::string& symbol, const std::string& path, std::vector<char> image) {
+    // Disk I/O happens off the matching thread; the worker only queues the bytes.
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    writes_.push_back(WriteJob{symbol, path, std::move(image)});
+    if (writer_running_) return;
+    // The previous writer, if any, has already left the queue and is only exiting.
+    if (checkpoint_writer_.joinable()) checkpoint_writer_.join();
+    writer_running_    = true;
+    checkpoint_writer_ = std::thread([this] { run_writer(); });
+}
+
+void EngineApp::run_writer() {
+    for (;;) {
+        std::optional<WriteJob> job;
+        {
+            std::lock_guard<std::mutex> lock(write_mutex_);
+            if (writes_.empty()) {
+                writer_running_ = false;
+                return;
+            }
+            job = std::move(writes_.front());
+            writes_.pop_front();
+        }
+        std::ofstream out(job->path, std::ios::binary | std::ios::trunc);
+        out.write(job->image.data(), static_cast<std::streamsize>(job->image.size()));
+        out.close();
+        if (!out) {
+            std::lock_guard<std::mutex> lock(write_mutex_);
+            write_errors_.push_back(job->symbol + " ERROR WRITE " + job->path);
+            write_failed_.store(true, std::memory_order_release);
         }
     }
 }
 
+void EngineApp::emit_write_errors() {
+    if (!write_failed_.load(std::memory_order_acquire)) return;
+    std::vector<std::string> lines;
+    {
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        lines.swap(write_errors_);
+        write_failed_.store(false, std::memory_order_relaxed);
+    }
+    for (const auto& line : lines) emit(line);
+}
+
+bool EngineApp::restore(const std::string& path) {
+    if (books_) return false;
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in) return false;
+    const auto size = static_cast<std::size_t>(in.tellg());
+    std::vector<char> image(size);
+    in.seekg(0);
+    if (!in.read(image.data(), static_cast<std::streamsize>(size))) return false;
+
+    const char* cursor = image.data();
+    const char* end    = cursor + size;
+    auto get = [&cursor, end](void* dst, std::size_t len) {
+        if (static_cast<std::size_t>(end - cursor) < len) return false;
+        std::memcpy(dst, cursor, len);
+        cursor += len;
+        return true;
+    };
+
+    std::uint64_t book_len = 0;
+    if (!get(&book_len, sizeof(book_len)) || static_cast<std::uint64_t>(end - cursor) < book_len) return false;
+    const char* book_bytes = cursor;
+    cursor += book_len;
+
+    std::uint64_t id_count = 0;
+    if (!get(&id_count, sizeof(id_count))) return false;
+    std::vector<std::string> names;
+    names.reserve(static_cast<std::size_t>(std::min<std::uint64_t>(id_count, size)));
+    for (std::uint64_t i = 0; i < id_count; ++i) {
+        std::uint32_t len = 0;
+        if (!get(&len, sizeof(len)) || static_cast<std::size_t>(end - cursor) < len) return false;
+        names.emplace_back(cursor, len);
+        cursor += len;
+    }
+
+    std::uint64_t account_count = 0;
+    if (!get(&account_count, sizeof(account_count))) return false;
+    const auto tail = static_cast<std::size_t>(end - cursor);
+    if (tail % sizeof(ob::types::OwnerId) != 0 || tail / sizeof(ob::types::OwnerId) != account_count) return false;
+    AccountTable accounts;
+    for (std::uint64_t i = 0; i < account_count; ++i) {
+        ob::types::OwnerId tag = 0;
+        get(&tag, sizeof(tag));
+        if (tag == 0 || accounts.intern(tag) != i + 1) return false; // untagged or repeated
+    }
+
+    if (!book_->restore(book_bytes, static_cast<std::size_t>(book_len))) return false;
+
+    id_lookup_.clear();
+    id_lookup_.reserve(names.size());
+    for (std::size_t i = 0; i < names.size(); ++i) {
+        id_lookup_.emplace(names[i], static_cast<ob::types::OrderId>(i));
+    }
+    id_reverse_ = std::move(names);
+    next_internal_id_ = static_cast<ob::types::OrderId>(id_reverse_.size());
+    accounts_ = std::move(accounts);
+    refresh_collar(lanes_[0]);
+    return true;
+}
+
 void EngineApp::run_logger() {
     for (;;) {
         auto msg = log_queue_.pop();
         if (msg) {
-            std::cout << *msg << '\n';
+            emit(*msg);
             continue;
         }
-        if (!running_.load(std::memory_order_acquire)) {
+        if (worker_done_.load(std::memory_order_acquire)) {
             msg = log_queue_.pop();
             if (!msg) break;
-            std::cout << *msg << '\n';
+            emit(*msg);
             continue;
         }
+        emit_write_errors();
         std::this_thread::yield();
     }
+    emit_write_errors(); // the writer has been joined by now
+}
+
+void EngineApp::emit(const std::string& line) {
+    if (output_sink_) {
+        output_sink_(line, output_ctx_);
+        return;
+    }
+    std::cout << line << '\n';
 }
 
 void EngineApp::on_trade(const ob::Trade& trade) {
+    const Lane& lane = *current_;
+    const ob::types::Price price = trade.resting_px * lane.tick_size;
+    current_->market_stats.on_trade(price, trade.traded_qty, lane.book->now());
     const std::string& resting = to_client_id(trade.resting_id);
     const std::string& incoming = to_client_id(trade.incoming_id);
     char buffer[160];
     int written = std::snprintf(buffer, sizeof(buffer),
                                 "%s TRADE %s %lld %lld %s %lld %lld",
-                                symbol_.c_str(),
+                                lane.symbol.c_str(),
                                 resting.c_str(),
-                                static_cast<long long>(trade.resting_px),
+                                static_cast<long long>(price),
                                 static_cast<long long>(trade.traded_qty),
                                 incoming.c_str(),
-                                static_cast<long long>(trade.incoming_px),
+                                static_cast<long long>(trade.incoming_px * lane.tick_size),
                                 static_cast<long long>(trade.traded_qty));
     if (written <= 0) return;
-    std::string line(buffer, static_cast<std::size_t>(written));
+    publish(std::string(buffer, static_cast<std::size_t>(written)));
+}
+
+void EngineApp::publish_reject(const Lane& lane, std::string_view client_id, RejectReason reason) {
+    char buffer[160];
+    int written = std::snprintf(buffer, sizeof(buffer), "%s REJECT %.*s %s",
+                                lane.symbol.c_str(),
+                                static_cast<int>(client_id.size()),
+                                client_id.data(),
+                                to_string(reason));
+    if (written <= 0) return;
+    publish(std::string(buffer, std::min(static_cast<std::size_t>(written), sizeof(buffer) - 1)));
+}
+
+void EngineApp::publish(std::string line) {
     while (!log_queue_.push(line)) {
         std::this_thread::yield();
     }
@@ -142,17 +586,25 @@ void EngineApp::trade_sink(const ob::Trade& trade, void* ctx) {
     static_cast<EngineApp*>(ctx)->on_trade(trade);
 }
 
-ob::types::OrderId EngineApp::assign_order_id(const std::string& client_id) {
-    auto [it, inserted] = id_lookup_.try_emplace(client_id, next_internal_id_);
-    if (inserted) {
-        id_reverse_.push_back(client_id);
-        return next_internal_id_++;
+std::string_view EngineApp::id_key(std::uint32_t lane, std::string_view client_id) {
+    // Grouped books share one ID space, so each lane's client IDs are kept apart by prefix.
+    if (!books_) return client_id;
+    id_key_.assign(reinterpret_cast<const char*>(&lane), sizeof(lane));
+    id_key_.append(client_id);
+    return id_key_;
+}
+
+ob::types::OrderId EngineApp::assign_order_id(std::string_view key, std::string_view client_id) {
+    if (auto it = id_lookup_.find(key); it != id_lookup_.end()) {
+        return it->second;
     }
-    return it->second;
+    id_lookup_.emplace(std::string(key), next_internal_id_);
+    id_reverse_.emplace_back(client_id);
+    return next_internal_id_++;
 }
 
-std::optional<ob::types::OrderId> EngineApp::find_order_id(const std::string& client_id) const {
-    auto it = id_lookup_.find(client_id);
+std::optional<ob::types::OrderId> EngineApp::find_order_id(std::string_view key) const {
+    auto it = id_lookup_.find(key);
     if (it == id_lookup_.end()) return std::nullopt;
     return it->second;
 }
@@ -0,0 +1,93 @@
+#include "engine/InputReader.h"
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+namespace engine::io {
+
+namespace {
+
+constexpr std::size_t kAlignment = 4096;
+
+#if defined(__linux__)
+constexpr auto kFallback = MultiSourceReader::Backend::Epoll;
+#else
+constexpr auto kFallback = MultiSourceReader::Backend::Blocking;
+#endif
+
+} // namespace
+
+MultiSourceReader::MultiSourceReader(std::vector<int> fds, std::size_t block_size, bool allow_uring)
+    : block_size_((std::max<std::size_t>(block_size, kAlignment) + kAlignment - 1) / kAlignment * kAlignment) {
+    sources_.reserve(fds.size());
+    for (int fd : fds) {
+        Source src;
+        src.fd = fd;
+        src.buffer = static_cast<char*>(std::aligned_alloc(kAlignment, block_size_));
+        if (!src.buffer) throw std::bad_alloc();
+        struct stat st {};
+        src.seekable = ::fstat(fd, &st) == 0 && S_ISREG(st.st_mode);
+        sources_.push_back(src);
+    }
+    backend_ = allow_uring && !sources_.empty() && setup_uring() ? Backend::IoUring : kFallback;
+}
+
+MultiSourceReader::~MultiSourceReader() {
+    uring_.reset();
+    for (auto& src : sources_) std::free(src.buffer);
+}
+
+void MultiSourceReader::run(consume_fn consume, void* ctx) {
+    switch (backend_) {
+        case Backend::IoUring:  run_uring(consume, ctx); break;
+        case Backend::Epoll:    run_epoll(consume, ctx); break;
+        case Backend::Blocking: run_blocking(consume, ctx); break;
+    }
+}
+
+void MultiSourceReader::deliver(Source& src, std::size_t source, std::size_t got, consume_fn consume, void* ctx) {
+    const std::size_t filled = src.pending + got;
+    const std::size_t used = consume(source, src.buffer, filled, /*final=*/false, ctx);
+    src.pending = filled - used;
+    if (src.pending == block_size_) {
+        // A single message larger than the buffer: flush it rather than wedge the source.
+        consume(source, src.buffer, src.pending, /*final=*/true, ctx);
+        src.pending = 0;
+    } else if (src.pending > 0 && used > 0) {
+        std::memmove(src.buffer, src.buffer + used, src.pending);
+    }
+}
+
+void MultiSourceReader::finish(Source& src, std::size_t source, consume_fn consume, void* ctx) {
+    if (src.pending > 0) consume(source, src.buffer, src.pending, /*final=*/true, ctx);
+    src.pending = 0;
+    src.done = true;
+}
+
+void MultiSourceReader::run_blocking(consume_fn consume, void* ctx) {
+    for (std::size_t i = 0; i < sources_.size(); ++i) {
+        Source& src = sources_[i];
+        while (!src.done) {
+            const auto got = ::read(src.fd, src.buffer + src.pending, block_size_ - src.pending);
+            if (got > 0) deliver(src, i, static_cast<std::size_t>(got), consume, ctx);
+            else if (got == 0 || errno != EINTR) finish(src, i, consume, ctx);
+        }
+    }
+}
+
+#if !defined(__linux__)
+// io_uring and epoll live in InputReaderLinux.cpp; elsewhere every source takes the blocking path.
+void MultiSourceReader::UringDeleter::operator()(Uring*) const noexcept {}
+
+bool MultiSourceReader::setup_uring() { return false; }
+void MultiSourceReader::run_uring(consume_fn consume, void* ctx) { run_blocking(consume, ctx); }
+void MultiSourceReader::run_epoll(consume_fn consume, void* ctx) { run_blocking(consume, ctx); }
+#endif
+
+} // namespace engine::io
@@ -0,0 +1,245 @@
+#include "engine/InputReader.h"
+
+#if defined(__linux__)
+
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/epoll.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace engine::io {
+
+namespace {
+
+int uring_setup(unsigned entries, io_uring_params* params) {
+    return static_cast<int>(::syscall(__NR_io_uring_setup, entries, params));
+}
+
+int uring_enter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags) {
+    return static_cast<int>(::syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, nullptr, 0));
+}
+
+int uring_register(int fd, unsigned opcode, const void* arg, unsigned nr_args) {
+    return static_cast<int>(::syscall(__NR_io_uring_register, fd, opcode, arg, nr_args));
+}
+
+unsigned load_acquire(const unsigned* p) noexcept {
+    return std::atomic_ref<const unsigned>(*p).load(std::memory_order_acquire);
+}
+
+void store_release(unsigned* p, unsigned value) noexcept {
+    std::atomic_ref<unsigned>(*p).store(value, std::memory_order_release);
+}
+
+} // namespace
+
+/// Raw io_uring instance: mapped submission/completion rings plus the SQE array.
+struct MultiSourceReader::Uring {
+    int           fd{-1};
+    void*         sq_ptr{MAP_FAILED};
+    std::size_t   sq_size{0};
+    void*         cq_ptr{MAP_FAILED};
+    std::size_t   cq_size{0};
+    io_uring_sqe* sqes{nullptr};
+    std::size_t   sqes_size{0};
+    unsigned*     sq_tail{nullptr};
+    unsigned*     sq_mask{nullptr};
+    unsigned*     sq_array{nullptr};
+    unsigned*     cq_head{nullptr};
+    unsigned*     cq_tail{nullptr};
+    unsigned*     cq_mask{nullptr};
+    io_uring_cqe* cqes{nullptr};
+    bool          fixed_buffers{false};
+
+    ~Uring() {
+        if (sqes) ::munmap(sqes, sqes_size);
+        if (cq_ptr != MAP_FAILED && cq_ptr != sq_ptr) ::munmap(cq_ptr, cq_size);
+        if (sq_ptr != MAP_FAILED) ::munmap(sq_ptr, sq_size);
+        if (fd >= 0) ::close(fd);
+    }
+};
+
+void MultiSourceReader::UringDeleter::operator()(Uring* ring) const noexcept {
+    delete ring;
+}
+
+bool MultiSourceReader::setup_uring() {
+    std::unique_ptr<Uring, UringDeleter> ring(new Uring);
+    unsigned entries = 4;
+    while (entries < sources_.size()) entries <<= 1;
+
+    io_uring_params params{};
+    ring->fd = uring_setup(entries, &params);
+    if (ring->fd < 0) return false;
+
+    ring->sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    ring->cq_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    const bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (single_mmap) ring->sq_size = ring->cq_size = std::max(ring->sq_size, ring->cq_size);
+
+    ring->sq_ptr = ::mmap(nullptr, ring->sq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                          ring->fd, IORING_OFF_SQ_RING);
+    if (ring->sq_ptr == MAP_FAILED) return false;
+    ring->cq_ptr = single_mmap ? ring->sq_ptr
+                               : ::mmap(nullptr, ring->cq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                        ring->fd, IORING_OFF_CQ_RING);
+    if (ring->cq_ptr == MAP_FAILED) return false;
+    ring->sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+    void* sqes = ::mmap(nullptr, ring->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                        ring->fd, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED) return false;
+    ring->sqes = static_cast<io_uring_sqe*>(sqes);
+
+    auto* sq = static_cast<char*>(ring->sq_ptr);
+    auto* cq = static_cast<char*>(ring->cq_ptr);
+    ring->sq_tail  = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+    ring->sq_mask  = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+    ring->sq_array = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+    ring->cq_head  = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+    ring->cq_tail  = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+    ring->cq_mask  = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+    ring->cqes     = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+
+    // Registered buffers skip per-read page pinning; plain reads still work when the
+    // memlock limit refuses the registration.
+    std::vector<iovec> iov(sources_.size());
+    for (std::size_t i = 0; i < sources_.size(); ++i) iov[i] = iovec{sources_[i].buffer, block_size_};
+    ring->fixed_buffers = uring_register(ring->fd, IORING_REGISTER_BUFFERS, iov.data(),
+                                         static_cast<unsigned>(iov.size())) == 0;
+    uring_ = std::move(ring);
+    return true;
+}
+
+void MultiSourceReader::run_uring(consume_fn consume, void* ctx) {
+    Uring& ring = *uring_;
+    unsigned queued = 0;
+    auto submit_read = [&](std::size_t i) {
+        Source& src = sources_[i];
+        const unsigned tail = *ring.sq_tail;
+        const unsigned idx = tail & *ring.sq_mask;
+        io_uring_sqe& sqe = ring.sqes[idx];
+        std::memset(&sqe, 0, sizeof(sqe));
+        sqe.opcode    = ring.fixed_buffers ? IORING_OP_READ_FIXED : IORING_OP_READ;
+        sqe.fd        = src.fd;
+        sqe.addr      = reinterpret_cast<std::uint64_t>(src.buffer + src.pending);
+        sqe.len       = static_cast<unsigned>(block_size_ - src.pending);
+        sqe.off       = src.seekable ? src.offset : static_cast<std::uint64_t>(-1);
+        sqe.buf_index = ring.fixed_buffers ? static_cast<std::uint16_t>(i) : 0;
+        sqe.user_data = i;
+        ring.sq_array[idx] = idx;
+        store_release(ring.sq_tail, tail + 1);
+        ++queued;
+    };
+
+    std::size_t in_flight = 0;
+    for (std::size_t i = 0; i < sources_.size(); ++i) {
+        submit_read(i);
+        ++in_flight;
+    }
+
+    while (in_flight > 0) {
+        const int rc = uring_enter(ring.fd, queued, 1, IORING_ENTER_GETEVENTS);
+        if (rc < 0) {
+            if (errno == EINTR || errno == EAGAIN || errno == EBUSY) continue;
+            throw std::runtime_error(std::string("io_uring_enter: ") + std::strerror(errno));
+        }
+        queued -= std::min<unsigned>(queued, static_cast<unsigned>(rc));
+
+        unsigned head = *ring.cq_head;
+        const unsigned tail = load_acquire(ring.cq_tail);
+        for (; head != tail; ++head) {
+            const io_uring_cqe& cqe = ring.cqes[head & *ring.cq_mask];
+            const auto i = static_cast<std::size_t>(cqe.user_data);
+            const int res = cqe.res;
+            --in_flight;
+            Source& src = sources_[i];
+            if (res == -EINTR || res == -EAGAIN) {
+                submit_read(i);
+                ++in_flight;
+            } else if (res <= 0) {
+                finish(src, i, consume, ctx);
+            } else {
+                src.offset += static_cast<std::uint64_t>(res);
+                deliver(src, i, static_cast<std::size_t>(res), consume, ctx);
+                submit_read(i);
+                ++in_flight;
+            }
+        }
+        store_release(ring.cq_head, head);
+    }
+}
+
+void MultiSourceReader::run_epoll(consume_fn consume, void* ctx) {
+    const int epfd = ::epoll_create1(EPOLL_CLOEXEC);
+    if (epfd < 0) throw std::runtime_error(std::string("epoll_create1: ") + std::strerror(errno));
+
+    std::vector<int> saved_flags(sources_.size(), -1);
+    std::size_t polled = 0;
+    std::size_t regular = 0;
+    for (std::size_t i = 0; i < sources_.size(); ++i) {
+        Source& src = sources_[i];
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.u64 = i;
+        if (!src.seekable && ::epoll_ctl(epfd, EPOLL_CTL_ADD, src.fd, &ev) == 0) {
+            saved_flags[i] = ::fcntl(src.fd, F_GETFL);
+            ::fcntl(src.fd, F_SETFL, saved_flags[i] | O_NONBLOCK);
+            ++polled;
+        } else {
+            src.seekable = true; // regular file (or unpollable): read round-robin
+            ++regular;
+        }
+    }
+
+    // Returns false once the source is exhausted or would block.
+    auto read_once = [&](std::size_t i) {
+        Source& src = sources_[i];
+        const auto got = ::read(src.fd, src.buffer + src.pending, block_size_ - src.pending);
+        if (got > 0) {
+            deliver(src, i, static_cast<std::size_t>(got), consume, ctx);
+            return true;
+        }
+        if (got < 0 && (errno == EAGAIN || errno == EINTR)) return false;
+        if (saved_flags[i] >= 0) ::epoll_ctl(epfd, EPOLL_CTL_DEL, src.fd, nullptr);
+        finish(src, i, consume, ctx);
+        return false;
+    };
+
+    epoll_event events[64];
+    while (polled + regular > 0) {
+        for (std::size_t i = 0; i < sources_.size(); ++i) {
+            if (sources_[i].done || saved_flags[i] >= 0) continue;
+            read_once(i);
+            if (sources_[i].done) --regular;
+        }
+        if (polled == 0) continue;
+
+        const int n = ::epoll_wait(epfd, events, 64, regular > 0 ? 0 : -1);
+        for (int e = 0; e < n; ++e) {
+            const auto i = static_cast<std::size_t>(events[e].data.u64);
+            // Bounded drain keeps one busy pipe from starving the others.
+            for (int burst = 0; burst < 16 && !sources_[i].done && read_once(i); ++burst) {}
+            if (sources_[i].done) --polled;
+        }
+    }
+
+    for (std::size_t i = 0; i < sources_.size(); ++i) {
+        if (saved_flags[i] >= 0) ::fcntl(sources_[i].fd, F_SETFL, saved_flags[i]);
+    }
+    ::close(epfd);
+}
+
+} // namespace engine::io
+
+#endif // __linux__
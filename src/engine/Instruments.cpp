@@ -0,0 +1,84 @@
+#include "engine/Instruments.h"
+
+#include <charconv>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace engine {
+
+namespace {
+
+template <typename T>
+bool parse_number(std::string_view text, T& out) {
+    const auto* end = text.data() + text.size();
+    const auto [ptr, ec] = std::from_chars(text.data(), end, out);
+    return ec == std::errc{} && ptr == end;
+}
+
+} // namespace
+
+std::optional<ob::types::StpMode> parse_stp_mode(std::string_view name) noexcept {
+    if (name == "none") return ob::types::StpMode::None;
+    if (name == "cancel-resting") return ob::types::StpMode::CancelResting;
+    if (name == "cancel-incoming") return ob::types::StpMode::CancelIncoming;
+    if (name == "decrement-both") return ob::types::StpMode::DecrementBoth;
+    return std::nullopt;
+}
+
+InstrumentTable InstrumentTable::load(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) throw std::runtime_error("cannot open instrument file " + path);
+
+    InstrumentTable table;
+    std::string line;
+    for (std::size_t number = 1; std::getline(in, line); ++number) {
+        const auto fail = [&](const std::string& what) {
+            throw std::runtime_error(path + ":" + std::to_string(number) + ": " + what);
+        };
+        if (const auto hash = line.find('#'); hash != std::string::npos) line.resize(hash);
+        std::istringstream fields(line);
+        std::string symbol;
+        if (!(fields >> symbol)) continue;
+
+        Instrument instrument;
+        std::string field;
+        while (fields >> field) {
+            const auto eq = field.find('=');
+            if (eq == std::string::npos) fail("expected key=value, got " + field);
+            const std::string_view key(field.data(), eq);
+            const std::string_view value(field.data() + eq + 1, field.size() - eq - 1);
+            bool ok = true;
+            if (key == "tick") {
+                ok = parse_number(value, instrument.tick_size) && instrument.tick_size > 0;
+            } else if (key == "band") {
+                const auto colon = value.find(':');
+                ok = colon != std::string_view::npos
+                  && parse_number(value.substr(0, colon), instrument.min_price)
+                  && parse_number(value.substr(colon + 1), instrument.max_price)
+                  && instrument.min_price <= instrument.max_price;
+            } else if (key == "open-interest") {
+                ok = parse_number(value, instrument.open_interest) && instrument.open_interest > 0;
+            } else if (key == "stp") {
+                instrument.stp = parse_stp_mode(value);
+                ok = instrument.stp.has_value();
+            } else if (key == "market-protection") {
+                ob::types::Price ticks = 0;
+                ok = parse_number(value, ticks) && ticks >= 0;
+                instrument.market_protection = ticks;
+            } else {
+                fail("unknown field " + std::string(key));
+            }
+            if (!ok) fail("invalid " + std::string(key) + ": " + std::string(value));
+        }
+        if (instrument.min_tick() > instrument.max_tick()) fail("band holds no multiple of the tick size");
+        const __int128 span = static_cast<__int128>(instrument.max_tick()) - instrument.min_tick() + 1;
+        if (span > max_band_ticks) {
+            fail("band spans more than " + std::to_string(max_band_ticks) + " ticks");
+        }
+        if (!table.instruments_.emplace(symbol, instrument).second) fail("duplicate symbol " + symbol);
+    }
+    return table;
+}
+
+} // namespace engine
@@ -0,0 +1,199 @@
+#include "engine/ShmRing.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <utility>
+
+namespace engine::shm {
+
+namespace {
+
+[[noreturn]] void fail(const std::string& what, const std::string& name) {
+    throw std::runtime_error(what + " " + name + ": " + std::strerror(errno));
+}
+
+} // namespace
+
+RingSegment RingSegment::create(const std::string& name, std::uint32_t rings, std::uint32_t slot_count) {
+    if (rings == 0) throw std::invalid_argument("segment needs at least one ring");
+    if (slot_count < 2 || (slot_count & (slot_count - 1)) != 0) {
+        throw std::invalid_argument("slot_count must be a power of two >= 2");
+    }
+    const std::size_t stride = sizeof(RingControl) + static_cast<std::size_t>(slot_count) * shm::slot_size;
+    const std::size_t size = sizeof(SegmentHeader) + rings * stride;
+
+    ::shm_unlink(name.c_str()); // replace a stale segment left by a crashed engine
+    const int fd = ::shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) fail("shm_open", name);
+    if (::ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        ::close(fd);
+        ::shm_unlink(name.c_str());
+        fail("ftruncate", name);
+    }
+    void* base = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (base == MAP_FAILED) {
+        ::shm_unlink(name.c_str());
+        fail("mmap", name);
+    }
+
+    auto* header = new (base) SegmentHeader{};
+    header->ring_count  = rings;
+    header->slot_count  = slot_count;
+    header->ring_stride = stride;
+    for (std::uint32_t i = 0; i < rings; ++i) {
+        new (static_cast<char*>(base) + sizeof(SegmentHeader) + i * stride) RingControl{};
+    }
+    return RingSegment(name, base, size, /*owner=*/true);
+}
+
+RingSegment RingSegment::open(const std::string& name) {
+    const int fd = ::shm_open(name.c_str(), O_RDWR, 0);
+    if (fd < 0) fail("shm_open", name);
+    struct stat st {};
+    if (::fstat(fd, &st) != 0 || static_cast<std::size_t>(st.st_size) < sizeof(SegmentHeader)) {
+        ::close(fd);
+        throw std::runtime_error("shared-memory segment " + name + " is truncated");
+    }
+    const auto size = static_cast<std::size_t>(st.st_size);
+    void* base = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (base == MAP_FAILED) fail("mmap", name);
+
+    const auto* header = static_cast<const SegmentHeader*>(base);
+    const bool valid = header->magic == shm::magic
+                    && header->version == shm::version
+                    && header->slot_size == shm::slot_size
+                    && sizeof(SegmentHeader) + header->ring_count * header->ring_stride <= size;
+    if (!valid) {
+        ::munmap(base, size);
+        throw std::runtime_error("shared-memory segment " + name + " has an incompatible layout");
+    }
+    return RingSegment(name, base, size, /*owner=*/false);
+}
+
+RingSegment::RingSegment(std::string name, void* base, std::size_t size, bool owner) noexcept
+    : name_(std::move(name))
+    , base_(static_cast<char*>(base))
+    , header_(static_cast<SegmentHeader*>(base))
+    , size_(size)
+    , owner_(owner) {}
+
+RingSegment::RingSegment(RingSegment&& other) noexcept
+    : name_(std::move(other.name_))
+    , base_(std::exchange(other.base_, nullptr))
+    , header_(std::exchange(other.header_, nullptr))
+    , size_(std::exchange(other.size_, 0))
+    , owner_(std::exchange(other.owner_, false)) {}
+
+RingSegment::~RingSegment() {
+    if (base_) ::munmap(base_, size_);
+    if (owner_) ::shm_unlink(name_.c_str());
+}
+
+bool RingSegment::try_push(std::uint32_t ring, const void* msg, std::size_t len) noexcept {
+    if (ring >= header_->ring_count || len > shm::slot_size) return false;
+    RingControl& ctl = control(ring);
+    const auto head = ctl.head.load(std::memory_order_relaxed);
+    if (head - ctl.tail.load(std::memory_order_acquire) >= header_->slot_count) {
+        return false; // full
+    }
+    std::memcpy(slot(ring, head), msg, len);
+    ctl.head.store(head + 1, std::memory_order_release);
+    return true;
+}
+
+bool IngressClient::define_symbol(std::uint32_t ring, std::uint32_t symbol, std::string_view name) noexcept {
+    wire::SymbolDefinition msg{};
+    if (name.empty() || name.size() > sizeof(msg.name)) return false;
+    msg.header      = wire::make_header<wire::SymbolDefinition>(wire::MessageType::SymbolDefinition, symbol);
+    msg.name_length = static_cast<std::uint8_t>(name.size());
+    std::memcpy(msg.name, name.data(), name.size());
+    return segment_.try_push(ring, msg);
+}
+
+bool IngressClient::new_order(std::uint32_t ring,
+                              std::uint32_t symbol,
+                              std::uint64_t client_id,
+                              ob::types::Side side,
+                              ob::types::TimeInForce tif,
+                              ob::types::Price price,
+                              ob::types::Quantity qty,
+                              std::optional<ob::types::Quantity> min_qty,
+                              ob::types::OwnerId owner) noexcept {
+    wire::NewOrder msg{};
+    msg.header    = wire::make_header<wire::NewOrder>(wire::MessageType::NewOrder, symbol);
+    msg.client_id = client_id;
+    msg.price     = price;
+    msg.quantity  = qty;
+    msg.side      = static_cast<std::uint8_t>(side);
+    msg.tif       = static_cast<std::uint8_t>(tif);
+    msg.owner     = owner;
+    if (min_qty) {
+        msg.flags  |= wire::HasMinQty;
+        msg.min_qty = *min_qty;
+    }
+    return segment_.try_push(ring, msg);
+}
+
+bool IngressClient::cancel(std::uint32_t ring, std::uint32_t symbol, std::uint64_t client_id) noexcept {
+    wire::Cancel msg{};
+    msg.header    = wire::make_header<wire::Cancel>(wire::MessageType::Cancel, symbol);
+    msg.client_id = client_id;
+    return segment_.try_push(ring, msg);
+}
+
+bool IngressClient::modify(std::uint32_t ring,
+                           std::uint32_t symbol,
+                           std::uint64_t client_id,
+                           ob::types::Side side,
+                           ob::types::Price price,
+                           ob::types::Quantity qty,
+                           std::optional<ob::types::Quantity> min_qty) noexcept {
+    wire::Modify msg{};
+    msg.header    = wire::make_header<wire::Modify>(wire::MessageType::Modify, symbol);
+    msg.client_id = client_id;
+    msg.price     = price;
+    msg.quantity  = qty;
+    msg.side      = static_cast<std::uint8_t>(side);
+    if (min_qty) {
+        msg.flags  |= wire::HasMinQty;
+        msg.min_qty = *min_qty;
+    }
+    return segment_.try_push(ring, msg);
+}
+
+bool IngressClient::print(std::uint32_t ring, std::uint32_t symbol) noexcept {
+    wire::Print msg{};
+    msg.header = wire::make_header<wire::Print>(wire::MessageType::Print, symbol);
+    return segment_.try_push(ring, msg);
+}
+
+bool IngressClient::mass_cancel(std::uint32_t ring,
+                                std::uint32_t symbol,
+                                ob::types::OwnerId owner,
+                                std::optional<ob::types::Side> side,
+                                std::optional<ob::PriceRange> range) noexcept {
+    wire::MassCancel msg{};
+    msg.header = wire::make_header<wire::MassCancel>(wire::MessageType::MassCancel, symbol);
+    msg.owner  = owner;
+    if (side) {
+        msg.flags |= wire::HasSide;
+        msg.side   = static_cast<std::uint8_t>(*side);
+    }
+    if (range) {
+        msg.flags |= wire::HasRange;
+        msg.low    = range->low;
+        msg.high   = range->high;
+    }
+    return segment_.try_push(ring, msg);
+}
+
+} // namespace engine::shm
@@ -0,0 +1,64 @@
+#include "engine/SymbolStats.h"
+
+#include <algorithm>
+
+namespace engine {
+
+namespace {
+
+constexpr std::uint64_t kNsPerMs = 1'000'000;
+
+} // namespace
+
+SymbolStatsTracker::SymbolStatsTracker() noexcept {
+    for (std::size_t slot = 0; slot < open_bars_.size(); ++slot) open_bars_[slot].interval_ms = kIntervalsMs[slot];
+}
+
+void SymbolStatsTracker::on_trade(ob::types::Price price, ob::types::Quantity qty, ob::types::Timestamp now) {
+    roll(now);
+    const double notional = static_cast<double>(price) * static_cast<double>(qty);
+
+    if (current_.trades == 0) current_.open = current_.high = current_.low = price;
+    current_.high = std::max(current_.high, price);
+    current_.low  = std::min(current_.low, price);
+    current_.close = price;
+    current_.volume += qty;
+    current_.notional += notional;
+    ++current_.trades;
+
+    for (std::size_t slot = 0; slot < open_bars_.size(); ++slot) {
+        Bar& bar = open_bars_[slot];
+        if (bar.trades == 0) {
+            const std::uint64_t length = std::uint64_t{bar.interval_ms} * kNsPerMs;
+            bar.start = now - now % length;
+            bar.open = bar.high = bar.low = price;
+        }
+        bar.high  = std::max(bar.high, price);
+        bar.low   = std::min(bar.low, price);
+        bar.close = price;
+        bar.volume += qty;
+        bar.notional += notional;
+        ++bar.trades;
+    }
+}
+
+void SymbolStatsTracker::roll(ob::types::Timestamp now) {
+    for (std::size_t slot = 0; slot < open_bars_.size(); ++slot) {
+        const Bar& bar = open_bars_[slot];
+        if (bar.trades > 0 && now >= bar.start + std::uint64_t{bar.interval_ms} * kNsPerMs) close(slot);
+    }
+}
+
+void SymbolStatsTracker::close(std::size_t slot) {
+    closed_.push_back(open_bars_[slot]);
+    open_bars_[slot] = Bar{};
+    open_bars_[slot].interval_ms = kIntervalsMs[slot];
+}
+
+std::vector<Bar> SymbolStatsTracker::take_bars() {
+    std::vector<Bar> out;
+    out.swap(closed_);
+    return out;
+}
+
+} // namespace engine
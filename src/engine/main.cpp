@@ -1,95 +1,295 @@
+#include "engine/BinaryProtocol.h"
+#include "engine/CommandParser.h"
 #include "engine/Engine.h"
+#include "engine/InputReader.h"
+#include "engine/ShmRing.h"
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <memory>
 #include <optional>
-#include <sstream>
 #include <string>
-#include <unordered_map>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t kReadBlock = 1 << 20;
+
+std::atomic<bool> g_stop{false};
+
+extern "C" void request_stop(int) { g_stop.store(true, std::memory_order_relaxed); }
+
+/**
+ * @brief Feed the contents of @p fd to @p consume in large blocks.
+ *
+ * Regular files are mapped and handed over in one piece; pipes and terminals are
+ * read into a reusable buffer. @p consume returns how many bytes it used and any
+ * unconsumed tail is carried to the front of the next block.
+ */
+template <typename Consume>
+void for_each_block(int fd, Consume&& consume) {
+    struct stat st {};
+    if (::fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+        const auto size = static_cast<std::size_t>(st.st_size);
+        void* mapped = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapped != MAP_FAILED) {
+            ::madvise(mapped, size, MADV_SEQUENTIAL);
+            consume(static_cast<const char*>(mapped), size, /*final=*/true);
+            ::munmap(mapped, size);
+            return;
+        }
+    }
 
-using engine::Command;
+    std::vector<char> buffer(kReadBlock);
+    std::size_t pending = 0;
+    for (;;) {
+        if (pending == buffer.size()) buffer.resize(buffer.size() * 2); // oversized line
+        const auto got = ::read(fd, buffer.data() + pending, buffer.size() - pending);
+        if (got < 0 && errno == EINTR) continue;
+        if (got <= 0) break;
+        const std::size_t filled = pending + static_cast<std::size_t>(got);
+        const std::size_t used = consume(buffer.data(), filled, /*final=*/false);
+        pending = filled - used;
+        if (pending > 0 && used > 0) std::memmove(buffer.data(), buffer.data() + used, pending);
+    }
+    if (pending > 0) consume(buffer.data(), pending, /*final=*/true);
+}
 
-int main() {
-    std::ios::sync_with_stdio(false);
-    std::cin.tie(nullptr);
+/// Where a symbol's commands go: its own engine, or one lane of a grouped engine.
+struct Route {
+    engine::EngineApp* app{nullptr};
+    std::uint32_t      lane{0};
+};
 
-    std::unordered_map<std::string, std::unique_ptr<engine::EngineApp>> engines;
+} // namespace
 
-    std::string line;
-    while (std::getline(std::cin, line)) {
-        if (line.empty()) continue;
-        std::istringstream iss(line);
-        std::string symbol;
-        std::string verb;
-        if (!(iss >> symbol >> verb)) continue;
+int main(int argc, char** argv) {
+    engine::SymbolTable symbols;
+    std::vector<std::unique_ptr<engine::EngineApp>> engines; // by symbol, or by group when grouped
+    std::vector<Route> routes;                               // by symbol
+    std::uint32_t per_worker = 0;                            // symbols per grouped engine; 0 = one engine each
+    std::size_t group_pool = 1'000'000;                      // live orders per grouped engine
+    engine::RiskLimits risk;
+    ob::types::StpMode stp = ob::types::StpMode::None;
+    ob::types::Price market_protection = 0;
+    engine::InstrumentTable instruments;
 
-        auto& engine_ptr = engines[symbol];
-        if (!engine_ptr) {
-            engine_ptr = std::make_unique<engine::EngineApp>(symbol);
+    // Command-line settings, overridden by the symbol's own policy from the instrument file.
+    auto configure = [&](std::uint32_t symbol, const Route& route) {
+        const engine::Instrument* instrument = instruments.find(symbols.name(symbol));
+        route.app->set_stp_mode(instrument && instrument->stp ? *instrument->stp : stp, route.lane);
+        route.app->set_market_protection(instrument && instrument->market_protection ? *instrument->market_protection
+                                                                                     : market_protection,
+                                         route.lane);
+    };
+    auto route_for = [&](std::uint32_t symbol) -> Route {
+        if (symbol >= routes.size()) routes.resize(symbol + 1);
+        if (routes[symbol].app) return routes[symbol];
+        const engine::Instrument* instrument = instruments.find(symbols.name(symbol));
+        const std::uint32_t slot = per_worker == 0 ? symbol : symbol / per_worker;
+        if (slot >= engines.size()) engines.resize(slot + 1);
+        auto& engine_ptr = engines[slot];
+        Route route;
+        if (per_worker == 0) {
+            engine_ptr = instrument ? std::make_unique<engine::EngineApp>(symbols.name(symbol), *instrument)
+                                    : std::make_unique<engine::EngineApp>(symbols.name(symbol));
+            engine_ptr->set_risk_limits(risk);
+        } else {
+            // Symbols are interned densely, so consecutive symbols fill one group's lanes.
+            if (!engine_ptr) {
+                // The group's symbols are not known yet, so their open interest cannot size it.
+                engine_ptr = std::make_unique<engine::EngineApp>(per_worker, group_pool);
+                engine_ptr->set_risk_limits(risk);
+            }
+            route.lane = symbol % per_worker;
+            engine_ptr->add_symbol(route.lane, symbols.name(symbol), instrument);
         }
-        auto& engine = *engine_ptr;
-
-        if (verb == "BUY" || verb == "SELL") {
-            std::string tif_text;
-            ob::types::Price price;
-            ob::types::Quantity qty;
-            std::string client_id;
-            if (!(iss >> tif_text >> price >> qty >> client_id)) continue;
-
-            auto tif = ob::types::TimeInForce::GFD;
-            if (tif_text == "IOC") tif = ob::types::TimeInForce::IOC;
-            else if (tif_text == "FOK") tif = ob::types::TimeInForce::FOK;
-
-            std::optional<ob::types::Quantity> min_qty;
-            std::string token;
-            while (iss >> token) {
-                if (token == "MIN") {
-                    ob::types::Quantity m;
-                    if (iss >> m) min_qty = m;
-                }
+        route.app = engine_ptr.get();
+        configure(symbol, route);
+        routes[symbol] = route;
+        return route;
+    };
+
+    bool binary = false;
+    bool allow_uring = true;
+    std::vector<int> input_fds;
+    std::string shm_name;
+    std::uint32_t shm_rings = 16;
+    std::uint32_t shm_slots = 4096;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--binary") {
+            binary = true;
+        } else if (arg == "--no-uring") {
+            allow_uring = false;
+        } else if (arg == "--input" && i + 1 < argc) {
+            // A single regular file is mmapped; several inputs are read concurrently.
+            const int fd = ::open(argv[++i], O_RDONLY);
+            if (fd < 0) {
+                std::cerr << "cannot open " << argv[i] << ": " << std::strerror(errno) << '\n';
+                return 1;
+            }
+            input_fds.push_back(fd);
+        } else if (arg == "--shm" && i + 1 < argc) {
+            shm_name = argv[++i];
+        } else if (arg == "--shm-rings" && i + 1 < argc) {
+            shm_rings = static_cast<std::uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--shm-slots" && i + 1 < argc) {
+            shm_slots = static_cast<std::uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--max-order-qty" && i + 1 < argc) {
+            risk.max_order_qty = std::strtoll(argv[++i], nullptr, 10);
+        } else if (arg == "--max-notional" && i + 1 < argc) {
+            risk.max_notional = std::strtoll(argv[++i], nullptr, 10);
+        } else if (arg == "--collar-bps" && i + 1 < argc) {
+            risk.collar_bps = static_cast<std::uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--max-open-qty" && i + 1 < argc) {
+            risk.max_open_qty = std::strtoll(argv[++i], nullptr, 10);
+        } else if (arg == "--stp" && i + 1 < argc) {
+            const std::string mode = argv[++i];
+            const auto parsed = engine::parse_stp_mode(mode);
+            if (!parsed) {
+                std::cerr << "invalid --stp mode: " << mode << '\n';
+                return 1;
+            }
+            stp = *parsed;
+        } else if (arg == "--market-protection" && i + 1 < argc) {
+            market_protection = std::strtoll(argv[++i], nullptr, 10);
+        } else if (arg == "--symbols-per-worker" && i + 1 < argc) {
+            // Grouped books share a pool and ID index, which a per-symbol checkpoint cannot rebuild.
+            if (!engines.empty()) {
+                std::cerr << "--symbols-per-worker cannot be combined with --restore\n";
+                return 1;
             }
+            per_worker = static_cast<std::uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--group-pool" && i + 1 < argc) {
+            group_pool = static_cast<std::size_t>(std::strtoull(argv[++i], nullptr, 10));
+        } else if (arg == "--instruments" && i + 1 < argc) {
+            // Books are sized when created, so the file has to come before any --restore.
+            if (!engines.empty()) {
+                std::cerr << "--instruments must precede --restore\n";
+                return 1;
+            }
+            try {
+                instruments = engine::InstrumentTable::load(argv[++i]);
+            } catch (const std::exception& ex) {
+                std::cerr << ex.what() << '\n';
+                return 1;
+            }
+        } else if (arg == "--restore" && i + 1 < argc) {
+            // --restore <symbol>=<path> preloads a symbol from a checkpoint before reading input.
+            if (per_worker != 0) {
+                std::cerr << "--symbols-per-worker cannot be combined with --restore\n";
+                return 1;
+            }
+            std::string spec = argv[++i];
+            auto eq = spec.find('=');
+            if (eq == std::string::npos) {
+                std::cerr << "invalid --restore argument: " << spec << '\n';
+                return 1;
+            }
+            const auto symbol = symbols.intern(spec.substr(0, eq));
+            if (!route_for(symbol).app->restore(spec.substr(eq + 1))) {
+                std::cerr << "failed to restore " << symbols.name(symbol) << " from " << spec.substr(eq + 1) << '\n';
+                return 1;
+            }
+        } else {
+            std::cerr << "usage: " << argv[0] << " [--binary] [--input <path>]... [--no-uring] [--shm <name> [--shm-rings N] [--shm-slots N]]"
+                      << " [--max-order-qty N] [--max-notional N] [--collar-bps N] [--max-open-qty N]"
+                      << " [--stp none|cancel-resting|cancel-incoming|decrement-both] [--market-protection N]"
+                      << " [--instruments <path>] [--symbols-per-worker N [--group-pool N]] [--restore <symbol>=<path>]...\n";
+            return 1;
+        }
+    }
+    // Symbols restored above were created before every option had been parsed.
+    for (auto& engine_ptr : engines) {
+        if (engine_ptr) engine_ptr->set_risk_limits(risk);
+    }
+    for (std::uint32_t symbol = 0; symbol < routes.size(); ++symbol) {
+        if (routes[symbol].app) configure(symbol, routes[symbol]);
+    }
 
-            Command cmd;
-            cmd.type = (verb == "BUY") ? Command::Type::Buy : Command::Type::Sell;
-            cmd.id = client_id;
-            cmd.price = price;
-            cmd.qty = qty;
-            cmd.side = (verb == "BUY") ? ob::types::Side::Buy : ob::types::Side::Sell;
-            cmd.tif = tif;
-            cmd.min_qty = min_qty;
-            engine.submit(std::move(cmd));
-        } else if (verb == "CANCEL") {
-            std::string client_id;
-            if (!(iss >> client_id)) continue;
-            Command cmd;
-            cmd.type = Command::Type::Cancel;
-            cmd.id = client_id;
-            engine.submit(std::move(cmd));
-        } else if (verb == "MODIFY") {
-            std::string client_id;
-            std::string side_text;
-            ob::types::Price price;
-            ob::types::Quantity qty;
-            if (!(iss >> client_id >> side_text >> price >> qty)) continue;
-            Command cmd;
-            cmd.type = Command::Type::Modify;
-            cmd.id = client_id;
-            cmd.price = price;
-            cmd.qty = qty;
-            cmd.side = (side_text == "BUY") ? ob::types::Side::Buy : ob::types::Side::Sell;
-            std::string token;
-            while (iss >> token) {
-                if (token == "MIN") {
-                    ob::types::Quantity m;
-                    if (iss >> m) cmd.min_qty = m;
-                }
+    auto dispatch = [&](std::uint32_t symbol, const engine::CommandRef& cmd) {
+        const Route route = route_for(symbol);
+        route.app->submit(route.lane, cmd);
+    };
+
+    if (!shm_name.empty()) {
+        // Gateways write binary-protocol messages straight into the segment; each ring is
+        // its own stream with its own symbol definitions.
+        std::optional<engine::shm::RingSegment> segment;
+        try {
+            segment.emplace(engine::shm::RingSegment::create(shm_name, shm_rings, shm_slots));
+        } catch (const std::exception& ex) {
+            std::cerr << ex.what() << '\n';
+            return 1;
+        }
+        std::signal(SIGINT, request_stop);
+        std::signal(SIGTERM, request_stop);
+
+        std::vector<engine::wire::BinaryParser> parsers;
+        parsers.reserve(shm_rings);
+        for (std::uint32_t r = 0; r < shm_rings; ++r) parsers.emplace_back(symbols);
+        for (;;) {
+            std::size_t drained = 0;
+            for (std::uint32_t r = 0; r < shm_rings; ++r) {
+                drained += segment->drain(r, [&](const char* slot, std::size_t slot_size) {
+                    const auto* header = reinterpret_cast<const engine::wire::MessageHeader*>(slot);
+                    parsers[r].parse(slot, std::min<std::size_t>(header->length, slot_size), dispatch);
+                });
             }
-            engine.submit(std::move(cmd));
-        } else if (verb == "PRINT") {
-            Command cmd;
-            cmd.type = Command::Type::Print;
-            engine.submit(std::move(cmd));
+            if (drained > 0) continue;
+            if (g_stop.load(std::memory_order_relaxed) || segment->shutdown_requested()) break;
+            std::this_thread::yield();
+        }
+    } else if (input_fds.size() > 1) {
+        // Each source is its own stream: binary sources need their own symbol remap,
+        // text lines are self-describing so one parser serves them all.
+        engine::io::MultiSourceReader reader(input_fds, kReadBlock, allow_uring);
+        if (binary) {
+            std::vector<engine::wire::BinaryParser> parsers;
+            parsers.reserve(input_fds.size());
+            for (std::size_t s = 0; s < input_fds.size(); ++s) parsers.emplace_back(symbols);
+            auto consume = [&](std::size_t source, const char* data, std::size_t size, bool) {
+                return parsers[source].parse(data, size, dispatch);
+            };
+            reader.run(consume);
+            std::size_t errors = 0;
+            for (const auto& parser : parsers) errors += parser.errors();
+            if (errors > 0) std::cerr << "skipped " << errors << " malformed binary messages\n";
+        } else {
+            engine::CommandParser parser(symbols);
+            auto consume = [&](std::size_t, const char* data, std::size_t size, bool final) {
+                return parser.parse(data, size, dispatch, final);
+            };
+            reader.run(consume);
+        }
+    } else if (binary) {
+        const int input_fd = input_fds.empty() ? STDIN_FILENO : input_fds.front();
+        engine::wire::BinaryParser parser(symbols);
+        for_each_block(input_fd, [&](const char* data, std::size_t size, bool) {
+            return parser.parse(data, size, dispatch);
+        });
+        if (parser.errors() > 0) {
+            std::cerr << "skipped " << parser.errors() << " malformed binary messages\n";
         }
+    } else {
+        const int input_fd = input_fds.empty() ? STDIN_FILENO : input_fds.front();
+        engine::CommandParser parser(symbols);
+        for_each_block(input_fd, [&](const char* data, std::size_t size, bool final) {
+            return parser.parse(data, size, dispatch, final);
+        });
     }
+    for (int fd : input_fds) ::close(fd);
     return 0;
 }
@@ -0,0 +1,15 @@
+#include "orderbook/BookSet.h"
+
+namespace ob {
+
+OrderBook& BookSet::open(std::uint32_t symbol) {
+    if (symbol >= books_.size()) books_.resize(static_cast<std::size_t>(symbol) + 1);
+    auto& slot = books_[symbol];
+    if (!slot) {
+        slot = std::make_unique<OrderBook>(store_, symbol);
+        ++open_;
+    }
+    return *slot;
+}
+
+} // namespace ob
@@ -0,0 +1,173 @@
+#include "orderbook/Checkpoint.h"
+#include "orderbook/OrderBook.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace ob {
+
+namespace {
+
+checkpoint::OrderRecord to_record(const Order& order) noexcept {
+    checkpoint::OrderRecord record{};
+    record.id          = order.id;
+    record.price       = order.price;
+    record.quantity    = order.quantity;
+    record.min_qty     = order.min_qty;
+    record.side        = static_cast<std::uint8_t>(order.side);
+    record.tif         = static_cast<std::uint8_t>(order.tif);
+    record.has_min_qty = order.has_min_qty ? 1 : 0;
+    record.type        = static_cast<std::uint8_t>(order.type);
+    record.owner       = order.owner;
+    record.stop_price  = order.stop_price;
+    record.hidden      = order.hidden;
+    record.display     = order.display;
+    record.expire_at   = order.expire_at;
+    record.peg         = static_cast<std::uint8_t>(order.peg);
+    return record;
+}
+
+bool valid_record(const checkpoint::OrderRecord& record, std::uint64_t index_size) noexcept {
+    return record.id < index_size
+        && record.quantity > 0
+        && record.hidden >= 0
+        && record.side <= static_cast<std::uint8_t>(types::Side::Sell)
+        && record.tif <= static_cast<std::uint8_t>(types::TimeInForce::GTT)
+        && record.type <= static_cast<std::uint8_t>(types::OrderType::StopLimit)
+        && record.peg <= static_cast<std::uint8_t>(types::PegType::Market)
+        && (record.peg == 0 || record.type == static_cast<std::uint8_t>(types::OrderType::Limit));
+}
+
+} // namespace
+
+void OrderBook::checkpoint(std::vector<char>& out) const {
+    checkpoint::Header header{};
+    header.record_size   = static_cast<std::uint16_t>(sizeof(checkpoint::OrderRecord));
+    header.bid_min_price = bids_.min_price();
+    header.bid_max_price = bids_.max_price();
+    header.ask_min_price = asks_.min_price();
+    header.ask_max_price = asks_.max_price();
+    header.pool_capacity = pool_.capacity();
+    header.index_size    = id_index_.size();
+    header.order_count   = live_orders();
+    header.last_trade_price = last_trade_price_.value_or(0);
+    header.has_last_trade   = last_trade_price_ ? 1 : 0;
+    header.clock            = clock_;
+    header.in_auction       = in_auction_ ? 1 : 0;
+
+    out.resize(sizeof(header) + header.order_count * sizeof(checkpoint::OrderRecord));
+    std::memcpy(out.data(), &header, sizeof(header));
+
+    char* cursor = out.data() + sizeof(header);
+    auto write_side = [&](const auto& book) {
+        book.for_each_level([&](const PriceLevel& level) {
+            level.for_each_order([&](const Order& order) {
+                auto record = to_record(order);
+                if (order.peg != types::PegType::None) record.price = level.price(); // may lag the group
+                std::memcpy(cursor, &record, sizeof(record));
+                cursor += sizeof(record);
+            });
+        });
+    };
+    write_side(bids_);
+    write_side(asks_);
+    write_side(buy_stops_);
+    write_side(sell_stops_);
+
+    // Only resting orders are live between commands; trim defensively otherwise.
+    out.resize(static_cast<std::size_t>(cursor - out.data()));
+    const auto written = (out.size() - sizeof(header)) / sizeof(checkpoint::OrderRecord);
+    if (written != header.order_count) {
+        header.order_count = written;
+        std::memcpy(out.data(), &header, sizeof(header));
+    }
+}
+
+bool OrderBook::restore(const char* data, std::size_t size) {
+    if (live_orders() != 0 || !data || size < sizeof(checkpoint::Header)) return false;
+
+    checkpoint::Header header;
+    std::memcpy(&header, data, sizeof(header));
+    if (header.magic != checkpoint::magic
+        || header.version != checkpoint::version
+        || header.record_size != sizeof(checkpoint::OrderRecord)) {
+        return false;
+    }
+    const std::size_t body = size - sizeof(header);
+    if (body % sizeof(checkpoint::OrderRecord) != 0
+        || body / sizeof(checkpoint::OrderRecord) != header.order_count
+        || header.order_count > header.pool_capacity
+        || header.pool_capacity > pool_.capacity()
+        || header.order_count > pool_.available()) {
+        return false;
+    }
+
+    const char* records = data + sizeof(header);
+    types::OrderId max_id = 0;
+    for (std::uint64_t i = 0; i < header.order_count; ++i) {
+        checkpoint::OrderRecord record;
+        std::memcpy(&record, records + i * sizeof(record), sizeof(record));
+        if (!valid_record(record, header.index_size)) return false;
+        max_id = std::max(max_id, record.id);
+    }
+
+    if (header.order_count > 0) {
+        bids_.ensure_range(header.bid_min_price, header.bid_max_price);
+        asks_.ensure_range(header.ask_min_price, header.ask_max_price);
+    }
+    clock_ = header.clock;
+    if (expiries_) expiries_->set_now(header.clock);
+    // Size the index from the records rather than trusting index_size; later IDs grow it on demand.
+    if (header.order_count > 0 && max_id >= id_index_.size()) {
+        id_index_.resize(static_cast<std::size_t>(max_id) + 1, nullptr);
+    }
+
+    for (std::uint64_t i = 0; i < header.order_count; ++i) {
+        checkpoint::OrderRecord record;
+        std::memcpy(&record, records + i * sizeof(record), sizeof(record));
+        if (id_index_[record.id]) {
+            // Duplicate identifier: unwind everything restored so far.
+            for (std::uint64_t j = 0; j < i; ++j) {
+                checkpoint::OrderRecord undo;
+                std::memcpy(&undo, records + j * sizeof(undo), sizeof(undo));
+                erase(undo.id);
+            }
+            return false;
+        }
+
+        std::optional<types::Quantity> min_qty;
+        if (record.has_min_qty) min_qty = record.min_qty;
+        auto* order = pool_.create(record.id,
+                                   record.price,
+                                   record.quantity,
+                                   static_cast<types::Side>(record.side),
+                                   static_cast<types::TimeInForce>(record.tif),
+                                   min_qty);
+        order->node.order   = order;
+        order->book         = tag_;
+        order->type         = static_cast<types::OrderType>(record.type);
+        order->stop_price   = record.stop_price;
+        order->hidden       = record.hidden;
+        order->display      = record.display;
+        if (record.owner != 0) {
+            order->owner = record.owner;
+            link_owner(*order);
+        }
+        if (order->tif == types::TimeInForce::GTT) {
+            order->timer.order = order;
+            expiries().insert(order->timer, record.expire_at);
+        }
+        id_index_[record.id] = order;
+        ++live_;
+        const bool buy = order->side == types::Side::Buy;
+        order->peg = static_cast<types::PegType>(record.peg);
+        if (order->type != types::OrderType::Limit) (buy ? buy_stops_ : sell_stops_).add(*order);
+        else if (order->peg != types::PegType::None) (buy ? bids_ : asks_).add_pegged(*order, record.price);
+        else (buy ? bids_ : asks_).add(*order);
+    }
+    if (header.has_last_trade) last_trade_price_ = header.last_trade_price;
+    in_auction_ = header.in_auction != 0;
+    return true;
+}
+
+} // namespace ob
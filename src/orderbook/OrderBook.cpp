@@ -1,17 +1,68 @@
 #include "orderbook/OrderBook.h"
+#include "orderbook/Stats.h"
 
 #include <algorithm>
 #include <iostream>
+#include <limits>
+#include <numeric>
 #include <vector>
 
 namespace ob {
 
+namespace {
+
+/// Reference price for a @p peg order on @p side given the limit-order touch.
+std::optional<types::Price> peg_target(types::Side side,
+                                       types::PegType peg,
+                                       std::optional<types::Price> bid,
+                                       std::optional<types::Price> ask) noexcept {
+    const bool buy = side == types::Side::Buy;
+    switch (peg) {
+        case types::PegType::Primary:
+            return buy ? bid : ask;
+        case types::PegType::Mid:
+            if (!bid || !ask) return std::nullopt;
+            return buy ? *bid + (*ask - *bid) / 2 : *ask - (*ask - *bid) / 2;
+        case types::PegType::Market:
+            if (buy) return ask ? std::optional<types::Price>{*ask - 1} : std::nullopt;
+            return bid ? std::optional<types::Price>{*bid + 1} : std::nullopt;
+        case types::PegType::None:
+            break;
+    }
+    return std::nullopt;
+}
+
+constexpr types::PegType kPegTypes[] = {types::PegType::Primary, types::PegType::Mid, types::PegType::Market};
+
+} // namespace
+
 OrderBook::OrderBook(types::Price min_price,
                      types::Price max_price,
                      std::size_t  pool_capacity)
-    : pool_(pool_capacity)
+    : own_store_(std::make_unique<OrderStore>(pool_capacity))
+    , pool_(own_store_->pool)
+    , id_index_(own_store_->index)
     , bids_(types::Side::Buy, min_price, max_price)
-    , asks_(types::Side::Sell, min_price, max_price) {}
+    , asks_(types::Side::Sell, min_price, max_price)
+    , buy_stops_(types::Side::Buy, min_price, max_price)
+    , sell_stops_(types::Side::Sell, min_price, max_price) {}
+
+OrderBook::OrderBook(OrderStore& store, std::uint32_t tag)
+    : pool_(store.pool)
+    , id_index_(store.index)
+    , tag_(tag)
+    , bids_(types::Side::Buy)
+    , asks_(types::Side::Sell)
+    , buy_stops_(types::Side::Buy)
+    , sell_stops_(types::Side::Sell) {}
+
+TimingWheel& OrderBook::expiries() {
+    if (!expiries_) {
+        expiries_ = std::make_unique<TimingWheel>();
+        expiries_->set_now(clock_);
+    }
+    return *expiries_;
+}
 
 void OrderBook::ensure_index_capacity(types::OrderId id) {
     if (id >= id_index_.size()) {
@@ -25,60 +76,238 @@ Order* OrderBook::create_order(types::OrderId id,
                                types::Side side,
                                types::TimeInForce tif,
                                std::optional<types::Quantity> min_qty) {
-    ensure_index_capacity(id);
-    if (id_index_[id]) {
+    return create_order(OrderSpec{id, price, qty, side, tif, min_qty});
+}
+
+Order* OrderBook::create_order(const OrderSpec& spec) {
+    ensure_index_capacity(spec.id);
+    if (id_index_[spec.id]) {
         return nullptr; // duplicate id
     }
+    if (spec.tif == types::TimeInForce::GTT && spec.expire_at <= clock_) {
+        return nullptr; // already expired
+    }
+    const bool market = spec.type == types::OrderType::Market || spec.type == types::OrderType::ProtectedMarket;
+    if (market && in_auction_) return nullptr;
+    std::optional<types::Price> peg_price;
+    if (spec.peg != types::PegType::None) {
+        const bool rests = spec.tif == types::TimeInForce::GFD || spec.tif == types::TimeInForce::GTT;
+        const bool iceberg = spec.display > 0 && spec.display < spec.quantity;
+        if (!rests || iceberg || spec.min_qty || spec.type != types::OrderType::Limit || in_auction_) return nullptr;
+        peg_price = peg_entry_price(spec.side, spec.peg);
+        if (!peg_price) return nullptr; // nothing to peg to
+    }
 
-    auto* order = pool_.create(id, price, qty, side, tif, min_qty);
-    if (!order) return nullptr;
+    auto* order = pool_.create(spec.id, spec.price, spec.quantity, spec.side, spec.tif, spec.min_qty);
+    if (!order) {
+        OB_STAT(++stats::local().pool_exhausted);
+        return nullptr;
+    }
 
-    order->node.order = order;
-    id_index_[id]     = order;
-    process(*order);
-    if (!has_order(id)) {
+    order->node.order  = order;
+    order->book        = tag_;
+    id_index_[spec.id] = order;
+    ++live_;
+    if (spec.display > 0 && spec.display < spec.quantity) order->display = spec.display;
+    if (spec.owner != 0) {
+        order->owner = spec.owner;
+        link_owner(*order);
+    }
+    if (spec.tif == types::TimeInForce::GTT) {
+        order->timer.order = order;
+        expiries().insert(order->timer, spec.expire_at);
+    }
+    if (peg_price) {
+        order->peg = spec.peg;
+        (order->side == types::Side::Buy ? bids_ : asks_).add_pegged(*order, *peg_price);
+    } else if (spec.type == types::OrderType::Limit) {
+        process(*order);
+    } else if (market) {
+        order->type = spec.type;
+        if (order->tif != types::TimeInForce::FOK) order->tif = types::TimeInForce::IOC;
+        process(*order);
+    } else {
+        order->type       = spec.type;
+        order->stop_price = spec.stop_price;
+        if (order->side == types::Side::Buy) buy_stops_.add(*order);
+        else sell_stops_.add(*order);
+    }
+    run_triggers();
+    reprice_pegs();
+    if (!has_order(spec.id)) {
         return nullptr;
     }
-    return id_index_[id];
+    return id_index_[spec.id];
 }
 
 void OrderBook::cancel(types::OrderId id) {
-    if (id >= id_index_.size()) return;
-    Order* order = id_index_[id];
+    erase(id);
+    reprice_pegs();
+}
+
+void OrderBook::erase(types::OrderId id) {
+    Order* order = lookup(id);
     if (!order) return;
 
     if (order->resting) {
-        if (order->side == types::Side::Buy) bids_.remove(*order);
-        else asks_.remove(*order);
+        if (order->type != types::OrderType::Limit) {
+            if (order->side == types::Side::Buy) buy_stops_.remove(*order);
+            else sell_stops_.remove(*order);
+        } else if (order->side == types::Side::Buy) {
+            bids_.remove(*order);
+        } else {
+            asks_.remove(*order);
+        }
     }
 
+    // A fired GTT stop turns IOC but keeps its timer until it leaves the book.
+    unschedule(*order);
+    if (order->owner != 0) unlink_owner(*order);
     id_index_[id] = nullptr;
+    --live_;
     pool_.destroy(order);
 }
 
+void OrderBook::link_owner(Order& order) {
+    if (order.owner >= owner_heads_.size()) {
+        owner_heads_.resize(static_cast<std::size_t>(order.owner) + 1, nullptr);
+        owner_open_.resize(owner_heads_.size(), 0);
+    }
+    owner_open_[order.owner] += order.quantity + order.hidden;
+    // Push at the head: list order does not matter, runs are found through the FIFOs.
+    Order*& head = owner_heads_[order.owner];
+    order.owner_prev = nullptr;
+    order.owner_next = head;
+    if (head) head->owner_prev = &order;
+    head = &order;
+}
+
+void OrderBook::unlink_owner(Order& order) noexcept {
+    owner_open_[order.owner] -= order.quantity + order.hidden;
+    if (order.owner_prev) order.owner_prev->owner_next = order.owner_next;
+    else owner_heads_[order.owner] = order.owner_next;
+    if (order.owner_next) order.owner_next->owner_prev = order.owner_prev;
+    order.owner_next = order.owner_prev = nullptr;
+}
+
+std::size_t OrderBook::mass_cancel(types::OwnerId owner,
+                                   std::optional<types::Side> side,
+                                   std::optional<PriceRange> range) {
+    if (owner == 0 || owner >= owner_heads_.size()) return 0;
+
+    // Orders queued behind a match at the same level share its side and price, so
+    // they match too; only the owner needs checking to extend the run.
+    const auto same_owner = [owner](const Order& next) { return next.owner == owner; };
+    doomed_.clear();
+    for (Order* order = owner_heads_[owner]; order;) {
+        // The list is a chain of dependent misses: start on the next hop before working on this one.
+        Order* next = order->owner_next;
+        if (next) {
+            __builtin_prefetch(next);
+            __builtin_prefetch(&next->node);
+            __builtin_prefetch(&next->timer);
+        }
+        if (side && order->side != *side) {
+            order = next;
+            continue;
+        }
+        const bool limit = order->type == types::OrderType::Limit;
+        const bool buy = order->side == types::Side::Buy;
+        const types::Price key = limit ? (buy ? bids_ : asks_).price_of(*order) : order->stop_price;
+        if (range && (key < range->low || key > range->high)) {
+            order = next;
+            continue;
+        }
+        // Run members further down the list are only marked by remove_run; every slot is
+        // released after the walk, so the list stays intact while it is followed.
+        if (order->resting) {
+            if (!limit) (buy ? buy_stops_ : sell_stops_).remove_run(*order, same_owner);
+            else (buy ? bids_ : asks_).remove_run(*order, same_owner);
+        }
+        unschedule(*order);
+        unlink_owner(*order);
+        id_index_[order->id] = nullptr;
+        doomed_.push_back(order);
+        order = next;
+    }
+    bids_.settle();
+    asks_.settle();
+    live_ -= doomed_.size();
+    pool_.destroy(doomed_.data(), doomed_.size());
+    reprice_pegs();
+    return doomed_.size();
+}
+
+void OrderBook::advance_time(types::Timestamp now) {
+    if (expiries_) expiries_->advance(now, [this](Order& order) { erase(order.id); });
+    if (now > clock_) clock_ = now;
+    reprice_pegs();
+}
+
+std::size_t OrderBook::end_of_day() {
+    const auto day_order = [](const Order& order) { return order.tif != types::TimeInForce::GTT; };
+    const auto release = [this](Order& order) {
+        unschedule(order);
+        if (order.owner != 0) unlink_owner(order);
+        id_index_[order.id] = nullptr;
+        --live_;
+        pool_.destroy(&order);
+    };
+    const std::size_t removed = bids_.remove_if(day_order, release)
+                              + asks_.remove_if(day_order, release)
+                              + buy_stops_.remove_if(day_order, release)
+                              + sell_stops_.remove_if(day_order, release);
+    reprice_pegs();
+    return removed;
+}
+
 void OrderBook::modify(types::OrderId id,
                        types::Side side,
                        types::Price price,
                        types::Quantity qty,
                        types::TimeInForce tif,
                        std::optional<types::Quantity> min_qty) {
-    if (id >= id_index_.size()) return;
-    Order* existing = id_index_[id];
+    Order* existing = lookup(id);
     if (!existing) return;
-    cancel(id);
-    create_order(id, price, qty, side, tif, min_qty);
+    const types::Timestamp expire_at = existing->expire_at;
+    const types::OwnerId owner = existing->owner;
+    const types::Quantity display = existing->display;
+    // Only armed stops still carry a stop type; a fired one was turned into a market or limit order.
+    const types::OrderType type = existing->type;
+    const types::Price stop_price = existing->stop_price;
+    erase(id);
+    OrderSpec spec{id, price, qty, side, tif, min_qty};
+    spec.expire_at = expire_at;
+    spec.owner     = owner;
+    spec.display   = display;
+    if (type == types::OrderType::Stop || type == types::OrderType::StopLimit) {
+        spec.type       = type;
+        spec.stop_price = stop_price;
+    }
+    if (!create_order(spec)) reprice_pegs(); // a rejected replacement still moved the book
 }
 
 bool OrderBook::has_order(types::OrderId id) const {
-    return id < id_index_.size() && id_index_[id] != nullptr;
+    return lookup(id) != nullptr;
 }
 
 const Order* OrderBook::find(types::OrderId id) const noexcept {
-    if (id >= id_index_.size()) return nullptr;
-    return id_index_[id];
+    return lookup(id);
+}
+
+std::optional<types::Quantity> OrderBook::queue_ahead(types::OrderId id) const noexcept {
+    const Order* order = find(id);
+    if (!order || !order->resting || order->type != types::OrderType::Limit || order->peg != types::PegType::None) {
+        return std::nullopt;
+    }
+    return (order->side == types::Side::Buy ? bids_ : asks_).queue_ahead(*order);
 }
 
 void OrderBook::process(Order& order) {
+    if (in_auction_) {
+        rest(order, order.side == types::Side::Buy ? bids_ : asks_);
+        return;
+    }
     if (order.side == types::Side::Buy) {
         match(order, asks_, bids_);
     } else {
@@ -86,53 +315,278 @@ void OrderBook::process(Order& order) {
     }
 }
 
+std::optional<types::Price> OrderBook::peg_entry_price(types::Side side, types::PegType peg) const {
+    if (auto joined = (side == types::Side::Buy ? bids_ : asks_).peg_price(peg)) return joined;
+    return peg_target(side, peg, bids_.best_limit_price(), asks_.best_limit_price());
+}
+
+void OrderBook::reprice_pegs() {
+    if (in_auction_ || (!bids_.has_pegged() && !asks_.has_pegged())) return;
+    const auto bid = bids_.best_limit_price();
+    const auto ask = asks_.best_limit_price();
+
+    std::optional<types::Price> lowest_sell;
+    for (const auto peg : kPegTypes) {
+        if (const auto target = peg_target(types::Side::Sell, peg, bid, ask)) asks_.reprice(peg, *target);
+        if (const auto at = asks_.peg_price(peg); at && (!lowest_sell || *at < *lowest_sell)) lowest_sell = at;
+    }
+    for (const auto peg : kPegTypes) {
+        auto target = peg_target(types::Side::Buy, peg, bid, ask);
+        if (!target) target = bids_.peg_price(peg);
+        if (!target) continue;
+        if (lowest_sell && *target >= *lowest_sell) target = *lowest_sell - 1;
+        bids_.reprice(peg, *target);
+    }
+}
+
+void OrderBook::run_triggers() {
+    if (in_auction_ || !last_trade_price_ || (buy_stops_.empty() && sell_stops_.empty())) return;
+    buy_stops_.trigger(*last_trade_price_, triggered_);
+    sell_stops_.trigger(*last_trade_price_, triggered_);
+
+    // Cascades are iterative: stops fired by a triggered order's trades queue up behind
+    // the ones already pending instead of recursing into process().
+    for (std::size_t i = 0; i < triggered_.size(); ++i) {
+        Order& order = *triggered_[i];
+        if (order.type == types::OrderType::Stop) {
+            order.type = types::OrderType::Market;
+            order.tif  = types::TimeInForce::IOC;
+        } else {
+            order.type = types::OrderType::Limit;
+        }
+        process(order);
+        buy_stops_.trigger(*last_trade_price_, triggered_);
+        sell_stops_.trigger(*last_trade_price_, triggered_);
+    }
+    triggered_.clear();
+}
+
 void OrderBook::match(Order& incoming, SideBook& opposite, SideBook& same) {
-    const auto available = opposite.available_to(incoming.price, incoming.side);
-    if (incoming.tif == types::TimeInForce::FOK && available < incoming.quantity) {
-        cancel(incoming.id);
-        return;
+    // An untagged order cannot self-trade, so it takes the unchecked loop whatever the policy.
+    switch (incoming.owner != 0 ? stp_mode_ : types::StpMode::None) {
+        case types::StpMode::None:           return match_with<types::StpMode::None>(incoming, opposite, same);
+        case types::StpMode::CancelResting:  return match_with<types::StpMode::CancelResting>(incoming, opposite, same);
+        case types::StpMode::CancelIncoming: return match_with<types::StpMode::CancelIncoming>(incoming, opposite, same);
+        case types::StpMode::DecrementBoth:  return match_with<types::StpMode::DecrementBoth>(incoming, opposite, same);
     }
-    if (incoming.has_min_qty && available < incoming.min_qty) {
-        cancel(incoming.id);
-        return;
+}
+
+template <types::StpMode Mode>
+void OrderBook::match_with(Order& incoming, SideBook& opposite, SideBook& same) {
+    const bool buy = incoming.side == types::Side::Buy;
+    const bool market = incoming.type != types::OrderType::Limit;
+    if (market) {
+        // The sweep bound is fixed on entry: the end of the ladder, or the touch plus the protection.
+        const auto touch = opposite.best_price();
+        if (!touch) {
+            erase(incoming.id);
+            return;
+        }
+        if (incoming.type == types::OrderType::Market) incoming.price = buy ? opposite.max_price() : opposite.min_price();
+        else incoming.price = buy ? *touch + market_protection_ : *touch - market_protection_;
+    }
+    if (incoming.tif == types::TimeInForce::FOK || incoming.has_min_qty) {
+        const auto available = opposite.available_to(incoming.price, incoming.side);
+        const bool fok_short = incoming.tif == types::TimeInForce::FOK && available < incoming.quantity;
+        const bool min_short = incoming.has_min_qty && available < incoming.min_qty;
+        if (fok_short || min_short) {
+            erase(incoming.id);
+            return;
+        }
     }
 
     while (incoming.quantity > 0) {
-        Order* resting = opposite.best();
-        if (!resting) break;
-        bool price_cross = incoming.side == types::Side::Buy
-                                ? incoming.price >= resting->price
-                                : incoming.price <= resting->price;
-        if (!price_cross) break;
-
-        auto traded = std::min(incoming.quantity, resting->quantity);
-        incoming.quantity -= traded;
-        resting->quantity -= traded;
-        opposite.on_fill(*resting, traded);
-
-        if (trade_sink_) {
-            trade_sink_(Trade{resting->id, resting->price, traded, incoming.id, incoming.price}, trade_ctx_);
+        PriceLevel* level = opposite.best_level();
+        if (!level) break;
+        // The bound is checked once per level: every order queued in a crossing level crosses.
+        const types::Price price = level->price();
+        if (buy ? price > incoming.price : price < incoming.price) break;
+        // Market orders print the price they traded at rather than their sweep bound.
+        const types::Price incoming_px = market ? price : incoming.price;
+
+        while (incoming.quantity > 0) {
+            Order* resting = level->top();
+            if (!resting) break;
+            if (resting->peg != types::PegType::None) resting->price = price; // a peg lags its group's moves
+            if constexpr (Mode != types::StpMode::None) {
+                if (resting->owner == incoming.owner) {
+                    if constexpr (Mode == types::StpMode::CancelIncoming) {
+                        erase(incoming.id);
+                        return;
+                    } else if constexpr (Mode == types::StpMode::CancelResting) {
+                        erase(resting->id);
+                        continue;
+                    } else {
+                        // Both sides shrink as if they had traded, but nothing prints and the last price holds.
+                        const auto prevented = std::min(incoming.quantity, resting->quantity);
+                        incoming.quantity -= prevented;
+                        resting->quantity -= prevented;
+                        opposite.on_fill(*resting, prevented);
+                        owner_open_[incoming.owner] -= 2 * prevented;
+                        if (resting->quantity == 0) {
+                            if (resting->hidden > 0) opposite.replenish(*resting);
+                            else erase(resting->id);
+                        }
+                        continue;
+                    }
+                }
+            }
+            OB_STAT(stats::local().fifo_depth_at_match.record(opposite.depth_at(price)));
+
+            auto traded = std::min(incoming.quantity, resting->quantity);
+            incoming.quantity -= traded;
+            resting->quantity -= traded;
+            opposite.on_fill(*resting, traded);
+            if (resting->owner != 0) owner_open_[resting->owner] -= traded;
+            if (incoming.owner != 0) owner_open_[incoming.owner] -= traded;
+            last_trade_price_ = price;
+
+            if (trade_sink_) {
+                trade_sink_(Trade{resting->id, price, traded, incoming.id, incoming_px}, trade_ctx_);
+            }
+
+            if (resting->quantity == 0) {
+                if (resting->hidden > 0) opposite.replenish(*resting);
+                else erase(resting->id);
+            }
+
+            if (incoming.tif == types::TimeInForce::IOC && !market) {
+                erase(incoming.id);
+                return;
+            }
         }
+    }
+
+    rest(incoming, same);
+}
 
-        if (resting->quantity == 0) {
-            cancel(resting->id);
+void OrderBook::rest(Order& order, SideBook& same) {
+    const bool rests = order.tif == types::TimeInForce::GFD || order.tif == types::TimeInForce::GTT;
+    if (order.quantity > 0 && rests) {
+        if (order.display > 0 && order.quantity > order.display) {
+            order.hidden   = order.quantity - order.display;
+            order.quantity = order.display;
         }
+        same.add(order);
+        order.resting = true;
+    } else {
+        erase(order.id);
+    }
+}
 
-        if (incoming.tif == types::TimeInForce::IOC) {
-            cancel(incoming.id);
-            return;
+AuctionResult OrderBook::indicative_uncross() const {
+    AuctionResult result;
+    const auto bid = bids_.best_price();
+    const auto ask = asks_.best_price();
+    if (!bid || !ask || *bid < *ask) return result;
+
+    // Only [best ask, best bid] can trade: below it there is no supply, above it no demand.
+    const types::Price low = *ask;
+    const auto span = static_cast<std::size_t>(*bid - low + 1);
+    demand_.resize(span);
+    supply_.resize(span);
+    bids_.depth_between(low, *bid, demand_.data());
+    asks_.depth_between(low, *bid, supply_.data());
+    std::inclusive_scan(demand_.rbegin(), demand_.rend(), demand_.rbegin());
+    std::inclusive_scan(supply_.begin(), supply_.end(), supply_.begin());
+
+    // Two branch-free reductions over the curves: the best volume, then the smallest
+    // imbalance among the prices reaching it. Only the tie-break below is scalar.
+    const types::Quantity* demand = demand_.data();
+    const types::Quantity* supply = supply_.data();
+    types::Quantity volume = 0;
+    for (std::size_t i = 0; i < span; ++i) volume = std::max(volume, std::min(demand[i], supply[i]));
+    if (volume == 0) return result;
+    types::Quantity imbalance = std::numeric_limits<types::Quantity>::max();
+    for (std::size_t i = 0; i < span; ++i) {
+        const types::Quantity gap = demand[i] > supply[i] ? demand[i] - supply[i] : supply[i] - demand[i];
+        imbalance = std::min(imbalance, std::min(demand[i], supply[i]) == volume ? gap : imbalance);
+    }
+
+    std::size_t first = span;
+    std::size_t last  = 0;
+    bool buyers = true;
+    bool sellers = true;
+    const auto candidate = [&](std::size_t i) {
+        const types::Quantity gap = demand[i] > supply[i] ? demand[i] - supply[i] : supply[i] - demand[i];
+        return std::min(demand[i], supply[i]) == volume && gap == imbalance;
+    };
+    for (std::size_t i = 0; i < span; ++i) {
+        if (!candidate(i)) continue;
+        if (first == span) first = i;
+        last = i;
+        buyers  = buyers && demand[i] > supply[i];
+        sellers = sellers && demand[i] < supply[i];
+    }
+    std::size_t pick = first;
+    if (buyers) {
+        pick = last;
+    } else if (!sellers && first != last) {
+        const types::Price reference = last_trade_price_.value_or(low + static_cast<types::Price>((first + last) / 2));
+        types::Price distance = std::numeric_limits<types::Price>::max();
+        for (std::size_t i = first; i <= last; ++i) {
+            if (!candidate(i)) continue;
+            const types::Price px = low + static_cast<types::Price>(i);
+            const types::Price d = px > reference ? px - reference : reference - px;
+            if (d < distance) {
+                distance = d;
+                pick = i;
+            }
         }
     }
+    result.price     = low + static_cast<types::Price>(pick);
+    result.volume    = volume;
+    result.imbalance = demand[pick] - supply[pick];
+    return result;
+}
 
-    if (incoming.quantity > 0 && incoming.tif == types::TimeInForce::GFD) {
-        same.add(incoming);
-        incoming.resting = true;
-    } else {
-        cancel(incoming.id);
+AuctionResult OrderBook::uncross() {
+    const auto result = indicative_uncross();
+    in_auction_ = false;
+    if (result.volume > 0) {
+        const types::Price price = *result.price;
+        auction_fills_.clear();
+        doomed_.clear();
+        const auto record = [this](Order& order, types::Quantity qty, bool complete) {
+            auction_fills_.push_back(AuctionFill{order.id, qty});
+            if (!complete) {
+                if (order.owner != 0) owner_open_[order.owner] -= qty;
+                return;
+            }
+            unschedule(order);
+            if (order.owner != 0) unlink_owner(order);
+            id_index_[order.id] = nullptr;
+            doomed_.push_back(&order);
+        };
+        bids_.execute(result.volume, record);
+        const std::size_t asks_begin = auction_fills_.size();
+        asks_.execute(result.volume, record);
+        live_ -= doomed_.size();
+        pool_.destroy(doomed_.data(), doomed_.size());
+
+        // Both fill lists sum to the volume; pair them off in priority order.
+        std::size_t b = 0;
+        std::size_t a = asks_begin;
+        types::Quantity bid_left = auction_fills_[b].quantity;
+        types::Quantity ask_left = auction_fills_[a].quantity;
+        while (b < asks_begin && a < auction_fills_.size()) {
+            const types::Quantity traded = std::min(bid_left, ask_left);
+            if (trade_sink_) {
+                trade_sink_(Trade{auction_fills_[a].id, price, traded, auction_fills_[b].id, price}, trade_ctx_);
+            }
+            bid_left -= traded;
+            ask_left -= traded;
+            if (bid_left == 0 && ++b < asks_begin) bid_left = auction_fills_[b].quantity;
+            if (ask_left == 0 && ++a < auction_fills_.size()) ask_left = auction_fills_[a].quantity;
+        }
+        last_trade_price_ = price;
     }
+    run_triggers();
+    reprice_pegs();
+    return result;
 }
 
-void OrderBook::snapshot(std::ostream& os) const {
+void OrderBook::snapshot(std::ostream& os, types::Price tick_size) const {
     os << "SELL:\n";
     std::vector<const PriceLevel*> asks;
     asks.reserve(64);
@@ -143,7 +597,7 @@ void OrderBook::snapshot(std::ostream& os) const {
         return lhs->price() < rhs->price();
     });
     for (const auto* level : asks) {
-        os << level->price() << ' ' << level->total() << '\n';
+        os << level->price() * tick_size << ' ' << level->total() << '\n';
     }
 
     os << "BUY:\n";
@@ -156,7 +610,7 @@ void OrderBook::snapshot(std::ostream& os) const {
         return lhs->price() > rhs->price();
     });
     for (const auto* level : bids) {
-        os << level->price() << ' ' << level->total() << '\n';
+        os << level->price() * tick_size << ' ' << level->total() << '\n';
     }
 }
 
@@ -4,9 +4,15 @@ namespace ob {
 
 void PriceLevel::add(Order& order) noexcept {
     total_quantity_ += order.quantity;
+    hidden_quantity_ += order.hidden;
+    order.node.entered = entered_;
+    entered_ += order.quantity;
     orders_.push_back(&order.node);
     order.node.order = &order;
     order.resting = true;
+#ifdef ENABLE_BOOK_STATS
+    ++depth_;
+#endif
 }
 
 Order* PriceLevel::top() noexcept {
@@ -17,14 +23,49 @@ Order* PriceLevel::top() noexcept {
 void PriceLevel::remove(Order& order) noexcept {
     total_quantity_ -= order.quantity;
     if (total_quantity_ < 0) total_quantity_ = 0;
+    hidden_quantity_ -= order.hidden;
+    if (orders_.front() == &order.node) consumed_ += order.quantity;
+    else entered_ -= order.quantity;
     orders_.erase(&order.node);
     order.resting = false;
     order.node.order = nullptr;
+#ifdef ENABLE_BOOK_STATS
+    --depth_;
+#endif
 }
 
 void PriceLevel::on_fill(types::Quantity delta) noexcept {
     total_quantity_ -= delta;
     if (total_quantity_ < 0) total_quantity_ = 0;
+    consumed_ += delta;
+}
+
+void PriceLevel::replenish(Order& order) noexcept {
+    const types::Quantity slice = order.hidden < order.display ? order.hidden : order.display;
+    order.hidden -= slice;
+    order.quantity += slice;
+    hidden_quantity_ -= slice;
+    total_quantity_ += slice;
+    order.node.entered = entered_;
+    entered_ += slice;
+    orders_.erase(&order.node);
+    orders_.push_back(&order.node);
+    order.node.order = &order; // the Boost-backed FIFO clears it on erase
+}
+
+void PriceLevel::splice_run(PriceLevel& from, Order& first, Order& last, types::Quantity quantity,
+                            [[maybe_unused]] std::size_t count) noexcept {
+    if (from.orders_.front() == &first.node) from.consumed_ += quantity;
+    else from.entered_ -= quantity;
+    entered_ += quantity;
+    orders_.splice_back(from.orders_, &first.node, &last.node);
+    from.total_quantity_ -= quantity;
+    if (from.total_quantity_ < 0) from.total_quantity_ = 0;
+    total_quantity_ += quantity;
+#ifdef ENABLE_BOOK_STATS
+    from.depth_ -= static_cast<std::uint32_t>(count);
+    depth_ += static_cast<std::uint32_t>(count);
+#endif
 }
 
 } // namespace ob
@@ -1,4 +1,5 @@
 #include "orderbook/SideBook.h"
+#include "orderbook/Stats.h"
 
 #include <algorithm>
 
@@ -20,6 +21,9 @@ SideBook::SideBook(types::Side side, types::Price min_price, types::Price max_pr
 }
 
 void SideBook::ensure_price(types::Price price) {
+    if (levels_.empty() || price < min_price_ || price > max_price_) {
+        OB_STAT(++stats::local().ladder_growths);
+    }
     if (levels_.empty()) {
         min_price_ = max_price_ = price;
         levels_.emplace_back(price);
@@ -37,6 +41,7 @@ void SideBook::ensure_price(types::Price price) {
         }
         min_price_ = price;
         if (best_index_) *best_index_ += add;
+        for (auto& group : pegs_) group.index += add;
         return;
     }
 
@@ -53,6 +58,12 @@ void SideBook::ensure_price(types::Price price) {
     }
 }
 
+void SideBook::ensure_range(types::Price low, types::Price high) {
+    if (low > high) std::swap(low, high);
+    ensure_price(low);
+    ensure_price(high);
+}
+
 void SideBook::update_best_on_insert(std::size_t idx) {
     if (!best_index_) {
         best_index_ = idx;
@@ -69,21 +80,28 @@ void SideBook::update_best_on_insert(std::size_t idx) {
 
 void SideBook::recompute_best() {
     best_index_.reset();
-    if (active_count_ == 0) return;
+    OB_STAT(++stats::local().recompute_best_calls);
+    if (active_count_ == 0) {
+        OB_STAT(stats::local().recompute_best_scan.record(0));
+        return;
+    }
 
     if (side_ == types::Side::Buy) {
         for (std::size_t idx = levels_.size(); idx-- > 0;) {
             if (!active_[idx]) continue;
             best_index_ = idx;
+            OB_STAT(stats::local().recompute_best_scan.record(levels_.size() - idx));
             return;
         }
     } else {
         for (std::size_t idx = 0; idx < levels_.size(); ++idx) {
             if (!active_[idx]) continue;
             best_index_ = idx;
+            OB_STAT(stats::local().recompute_best_scan.record(idx + 1));
             return;
         }
     }
+    OB_STAT(stats::local().recompute_best_scan.record(levels_.size()));
 }
 
 std::size_t SideBook::next_active_after(std::size_t idx) const noexcept {
@@ -114,9 +132,10 @@ void SideBook::add(Order& order) {
 }
 
 void SideBook::remove(Order& order) {
-    if (order.price < min_price_ || order.price > max_price_) return;
-    const auto idx = index_of(order.price);
+    if (order.peg == types::PegType::None && (order.price < min_price_ || order.price > max_price_)) return;
+    const auto idx = level_index(order);
     auto& level = levels_[idx];
+    if (order.peg != types::PegType::None) unpeg(order);
     level.remove(order);
     if (level.empty()) {
         if (active_[idx]) {
@@ -137,7 +156,11 @@ Order* SideBook::best() {
 
     auto& level = levels_[*best_index_];
     auto* top_order = level.top();
-    if (top_order) return top_order;
+    if (top_order) {
+        // A pegged order's price lags its group's moves until it reaches the front.
+        if (top_order->peg != types::PegType::None) top_order->price = level.price();
+        return top_order;
+    }
 
     // best level is empty due to partial fills; mark inactive and retry
     if (active_[*best_index_]) {
@@ -149,8 +172,9 @@ Order* SideBook::best() {
 }
 
 void SideBook::on_fill(Order& order, types::Quantity delta) {
-    if (order.price < min_price_ || order.price > max_price_) return;
-    const auto idx = index_of(order.price);
+    if (order.peg != types::PegType::None) pegs_[peg_slot(order.peg)].quantity -= delta;
+    else if (order.price < min_price_ || order.price > max_price_) return;
+    const auto idx = level_index(order);
     auto& level = levels_[idx];
     level.on_fill(delta);
     if (level.total() == 0 && level.empty() && active_[idx]) {
@@ -162,26 +186,122 @@ void SideBook::on_fill(Order& order, types::Quantity delta) {
     }
 }
 
+void SideBook::add_pegged(Order& order, types::Price price) {
+    auto& group = pegs_[peg_slot(order.peg)];
+    if (group.count == 0) {
+        order.price = price;
+        add(order);
+        group.first = &order;
+        group.index = index_of(price);
+    } else {
+        // Inserting after the group's last member would jump orders queued behind it.
+        auto& level = levels_[group.index];
+        if (level.after(*group.last)) level.splice_run(level, *group.first, *group.last, group.quantity, group.count);
+        order.price = price_at(group.index);
+        level.add(order);
+    }
+    group.last = &order;
+    ++group.count;
+    group.quantity += order.quantity;
+}
+
+void SideBook::reprice(types::PegType peg, types::Price price) {
+    auto& group = pegs_[peg_slot(peg)];
+    if (group.count == 0) return;
+    ensure_price(price);
+    const auto from = group.index;
+    const auto to = index_of(price);
+    if (from == to) return;
+
+    auto& source = levels_[from];
+    auto& target = levels_[to];
+    target.splice_run(source, *group.first, *group.last, group.quantity, group.count);
+    group.index = to;
+    if (source.empty()) {
+        active_[from] = false;
+        --active_count_;
+        if (best_index_ && *best_index_ == from) {
+            // The next best is the nearest level behind the one just vacated.
+            best_index_.reset();
+            const auto next = side_ == types::Side::Buy ? prev_active_before(from) : next_active_after(from);
+            if (next != levels_.size()) best_index_ = next;
+        }
+    }
+    if (!active_[to]) {
+        active_[to] = true;
+        ++active_count_;
+    }
+    update_best_on_insert(to);
+}
+
+std::optional<types::Price> SideBook::best_limit_price() const noexcept {
+    if (!best_index_) return std::nullopt;
+    // Only levels holding nothing but peg groups are skipped, and there are at most three.
+    for (auto idx = *best_index_; idx != levels_.size();
+         idx = side_ == types::Side::Buy ? prev_active_before(idx) : next_active_after(idx)) {
+        if (levels_[idx].total() + levels_[idx].hidden() > pegged_at(idx)) return price_at(idx);
+    }
+    return std::nullopt;
+}
+
+types::Quantity SideBook::pegged_at(std::size_t idx) const noexcept {
+    types::Quantity quantity = 0;
+    for (const auto& group : pegs_) {
+        if (group.count > 0 && group.index == idx) quantity += group.quantity;
+    }
+    return quantity;
+}
+
+void SideBook::unpeg(const Order& order) noexcept {
+    auto& group = pegs_[peg_slot(order.peg)];
+    group.quantity -= order.quantity;
+    if (--group.count == 0) {
+        group.first = group.last = nullptr;
+        return;
+    }
+    const auto& level = levels_[group.index];
+    if (&order == group.first) group.first = level.after(order);
+    else if (&order == group.last) group.last = level.before(order);
+}
+
+void SideBook::depth_between(types::Price low, types::Price high, types::Quantity* out) const noexcept {
+    for (types::Price px = low; px <= high; ++px) {
+        types::Quantity qty = 0;
+        if (px >= min_price_ && px <= max_price_) {
+            const auto idx = index_of(px);
+            if (active_[idx]) qty = levels_[idx].total() + levels_[idx].hidden();
+        }
+        *out++ = qty;
+    }
+}
+
 types::Quantity SideBook::available_to(types::Price limit_price, types::Side incoming_side) const {
+    OB_STAT(++stats::local().available_to_calls);
     if (levels_.empty() || active_count_ == 0 || !best_index_) return 0;
     types::Quantity total = 0;
+#ifdef ENABLE_BOOK_STATS
+    std::uint64_t visited = 0;
+    struct Record {
+        std::uint64_t& visited;
+        ~Record() { stats::local().available_to_levels.record(visited); }
+    } record{visited};
+#endif
+    // Bounded by the limit's index: a walk never scans the ladder beyond it.
     if (incoming_side == types::Side::Buy) {
-        auto idx = *best_index_;
-        if (price_at(idx) > limit_price) return 0;
-        while (idx < levels_.size() && price_at(idx) <= limit_price) {
-            if (active_[idx]) total += levels_[idx].total();
-            auto next = next_active_after(idx);
-            if (next == levels_.size()) break;
-            idx = next;
+        if (price_at(*best_index_) > limit_price) return 0;
+        const std::size_t end = limit_price >= max_price_ ? levels_.size() : index_of(limit_price) + 1;
+        for (std::size_t idx = *best_index_; idx < end; ++idx) {
+            if (!active_[idx]) continue;
+            OB_STAT(++visited);
+            total += levels_[idx].total() + levels_[idx].hidden();
         }
     } else {
-        auto idx = *best_index_;
-        if (price_at(idx) < limit_price) return 0;
-        while (idx < levels_.size() && price_at(idx) >= limit_price) {
-            if (active_[idx]) total += levels_[idx].total();
-            auto prev = prev_active_before(idx);
-            if (prev == levels_.size()) break;
-            idx = prev;
+        if (price_at(*best_index_) < limit_price) return 0;
+        const std::size_t stop = limit_price <= min_price_ ? 0 : index_of(limit_price);
+        for (std::size_t idx = *best_index_ + 1; idx-- > stop;) {
+            if (!active_[idx]) continue;
+            OB_STAT(++visited);
+            total += levels_[idx].total() + levels_[idx].hidden();
         }
     }
     return total;
@@ -0,0 +1,47 @@
+#include "orderbook/Stats.h"
+
+namespace ob {
+
+namespace {
+
+thread_local BookStats t_stats;
+
+void print_histogram(std::ostream& os, const char* name, std::uint64_t calls, const Log2Histogram& h) {
+    os << name << " calls=" << calls;
+    if (h.count) {
+        os << " mean=" << static_cast<double>(h.sum) / static_cast<double>(h.count)
+           << " p50<=" << h.percentile_bound(50.0)
+           << " p99<=" << h.percentile_bound(99.0)
+           << " max=" << h.max;
+    }
+    os << '\n';
+}
+
+} // namespace
+
+std::uint64_t Log2Histogram::percentile_bound(double pct) const noexcept {
+    if (count == 0) return 0;
+    const auto rank = static_cast<std::uint64_t>(pct / 100.0 * static_cast<double>(count));
+    std::uint64_t seen = 0;
+    for (std::size_t k = 0; k < buckets.size(); ++k) {
+        seen += buckets[k];
+        if (seen > rank) return k == 0 ? 0 : (k >= 64 ? max : (std::uint64_t{1} << k) - 1);
+    }
+    return max;
+}
+
+void BookStats::print(std::ostream& os) const {
+    if (!stats::enabled) {
+        os << "stats disabled (rebuild with -DENABLE_BOOK_STATS=ON)\n";
+        return;
+    }
+    print_histogram(os, "recompute_best", recompute_best_calls, recompute_best_scan);
+    print_histogram(os, "available_to", available_to_calls, available_to_levels);
+    print_histogram(os, "fifo_depth_at_match", fifo_depth_at_match.count, fifo_depth_at_match);
+    os << "pool_exhausted=" << pool_exhausted << '\n';
+    os << "ladder_growths=" << ladder_growths << '\n';
+}
+
+BookStats& stats::local() noexcept { return t_stats; }
+
+} // namespace ob
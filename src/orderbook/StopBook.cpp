@@ -0,0 +1,100 @@
+#include "orderbook/StopBook.h"
+
+#include <algorithm>
+
+namespace ob {
+
+StopBook::StopBook(types::Side side, types::Price min_price, types::Price max_price)
+    : side_(side)
+    , min_price_(min_price)
+    , max_price_(max_price) {
+    if (min_price_ > max_price_) std::swap(min_price_, max_price_);
+    const auto span = static_cast<std::size_t>(max_price_ - min_price_ + 1);
+    levels_.reserve(span);
+    active_.assign(span, false);
+    for (std::size_t i = 0; i < span; ++i) levels_.emplace_back(price_at(i));
+}
+
+void StopBook::ensure_price(types::Price price) {
+    if (levels_.empty()) {
+        min_price_ = max_price_ = price;
+        levels_.emplace_back(price);
+        active_.push_back(false);
+        return;
+    }
+    if (price < min_price_) {
+        const auto add = static_cast<std::size_t>(min_price_ - price);
+        levels_.insert(levels_.begin(), add, PriceLevel{});
+        active_.insert(active_.begin(), add, false);
+        min_price_ = price;
+        for (std::size_t i = 0; i < add; ++i) levels_[i].set_price(price_at(i));
+        if (frontier_) *frontier_ += add;
+    } else if (price > max_price_) {
+        const auto current = levels_.size();
+        const auto add = static_cast<std::size_t>(price - max_price_);
+        levels_.resize(current + add);
+        active_.resize(current + add, false);
+        max_price_ = price;
+        for (std::size_t i = current; i < levels_.size(); ++i) levels_[i].set_price(price_at(i));
+    }
+}
+
+void StopBook::ensure_range(types::Price low, types::Price high) {
+    if (low > high) std::swap(low, high);
+    ensure_price(low);
+    ensure_price(high);
+}
+
+void StopBook::add(Order& order) {
+    ensure_price(order.stop_price);
+    const auto idx = index_of(order.stop_price);
+    if (!active_[idx]) {
+        active_[idx] = true;
+        ++active_count_;
+    }
+    levels_[idx].add(order);
+    if (!frontier_ || (side_ == types::Side::Buy ? idx < *frontier_ : idx > *frontier_)) frontier_ = idx;
+}
+
+void StopBook::remove(Order& order) {
+    if (order.stop_price < min_price_ || order.stop_price > max_price_) return;
+    const auto idx = index_of(order.stop_price);
+    auto& level = levels_[idx];
+    level.remove(order);
+    // The frontier stays put: it only has to bound the armed levels, not touch one.
+    if (level.empty() && active_[idx]) {
+        active_[idx] = false;
+        if (--active_count_ == 0) frontier_.reset();
+    }
+}
+
+void StopBook::drain(std::size_t idx, std::vector<Order*>& out) {
+    auto& level = levels_[idx];
+    while (Order* order = level.top()) {
+        level.remove(*order);
+        out.push_back(order);
+    }
+    active_[idx] = false;
+    --active_count_;
+}
+
+void StopBook::trigger(types::Price last_trade, std::vector<Order*>& out) {
+    if (!frontier_) return;
+    auto idx = *frontier_;
+    if (side_ == types::Side::Buy) {
+        // Buy stops fire at or below the last trade: walk upwards to it.
+        for (; idx < levels_.size() && price_at(idx) <= last_trade; ++idx) {
+            if (active_[idx]) drain(idx, out);
+        }
+    } else {
+        // Sell stops fire at or above the last trade: walk downwards to it.
+        for (; price_at(idx) >= last_trade; --idx) {
+            if (active_[idx]) drain(idx, out);
+            if (idx == 0) break;
+        }
+    }
+    if (active_count_ == 0) frontier_.reset();
+    else frontier_ = idx;
+}
+
+} // namespace ob
@@ -0,0 +1,112 @@
+#include "orderbook/TimingWheel.h"
+
+#include <bit>
+
+namespace ob {
+
+TimingWheel::TimingWheel(types::Timestamp resolution)
+    : resolution_(resolution > 0 ? resolution : 1) {}
+
+void TimingWheel::set_now(types::Timestamp now) noexcept {
+    clock_    = now;
+    now_tick_ = now / resolution_;
+}
+
+void TimingWheel::insert(TimerNode& node, types::Timestamp expire_at) noexcept {
+    if (node.slot != TimerNode::unlinked) unlink(node);
+    else ++count_;
+    node.order->expire_at = expire_at;
+    place(node);
+}
+
+std::uint64_t TimingWheel::tick_of(const TimerNode& node) const noexcept {
+    // Round up so an order never expires before its deadline.
+    const types::Timestamp expire_at = node.order->expire_at;
+    return expire_at / resolution_ + (expire_at % resolution_ != 0 ? 1 : 0);
+}
+
+void TimingWheel::place(TimerNode& node) noexcept {
+    const std::uint64_t tick = tick_of(node);
+    if (tick <= now_tick_) {
+        link(node, kDue);
+        return;
+    }
+    const auto level = static_cast<std::size_t>(63 - std::countl_zero(tick ^ now_tick_)) / kLevelBits;
+    if (level >= kLevels) {
+        link(node, kOverflow);
+        return;
+    }
+    const auto slot = static_cast<std::size_t>(tick >> (level * kLevelBits)) & (kSlots - 1);
+    link(node, static_cast<std::uint16_t>(level * kSlots + slot));
+}
+
+void TimingWheel::link(TimerNode& node, std::uint16_t bucket) noexcept {
+    TimerNode*& head = heads_[bucket];
+    node.slot = bucket;
+    node.prev = nullptr;
+    node.next = head;
+    if (head) head->prev = &node;
+    head = &node;
+    if (bucket < kOverflow) occupied_[bucket / kSlots][(bucket % kSlots) / 64] |= std::uint64_t{1} << (bucket % 64);
+}
+
+void TimingWheel::unlink(TimerNode& node) noexcept {
+    const auto bucket = node.slot;
+    if (node.prev) node.prev->next = node.next;
+    else heads_[bucket] = node.next;
+    if (node.next) node.next->prev = node.prev;
+    node.next = node.prev = nullptr;
+    node.slot = TimerNode::unlinked;
+    if (bucket < kOverflow && !heads_[bucket]) {
+        occupied_[bucket / kSlots][(bucket % kSlots) / 64] &= ~(std::uint64_t{1} << (bucket % 64));
+    }
+}
+
+std::optional<std::uint64_t> TimingWheel::next_event() const noexcept {
+    // Every filed node sits strictly after the current slot of its level, and a lower
+    // level's range ends before the next slot of a higher one starts, so the first hit
+    // walking upwards is the earliest.
+    for (std::size_t level = 0; level < kLevels; ++level) {
+        const unsigned shift = static_cast<unsigned>(level * kLevelBits);
+        const auto current = static_cast<std::size_t>(now_tick_ >> shift) & (kSlots - 1);
+        for (std::size_t slot = current + 1; slot < kSlots;) {
+            const std::uint64_t word = occupied_[level][slot / 64] >> (slot % 64);
+            if (word == 0) {
+                slot = (slot / 64 + 1) * 64;
+                continue;
+            }
+            const auto hit = slot + static_cast<std::size_t>(std::countr_zero(word));
+            const unsigned span = shift + kLevelBits;
+            return ((now_tick_ >> span) << span) | (static_cast<std::uint64_t>(hit) << shift);
+        }
+    }
+    if (heads_[kOverflow]) {
+        constexpr unsigned span = kLevels * kLevelBits;
+        return ((now_tick_ >> span) + 1) << span;
+    }
+    return std::nullopt;
+}
+
+void TimingWheel::refile(std::uint16_t bucket) noexcept {
+    TimerNode* node = heads_[bucket];
+    heads_[bucket] = nullptr;
+    if (bucket < kOverflow) occupied_[bucket / kSlots][(bucket % kSlots) / 64] &= ~(std::uint64_t{1} << (bucket % 64));
+    while (node) {
+        TimerNode* next = node->next;
+        place(*node);
+        node = next;
+    }
+}
+
+void TimingWheel::cascade() noexcept {
+    constexpr unsigned top = kLevels * kLevelBits;
+    if ((now_tick_ & ((std::uint64_t{1} << top) - 1)) == 0) refile(kOverflow);
+    for (std::size_t level = kLevels; level-- > 0;) {
+        const unsigned shift = static_cast<unsigned>(level * kLevelBits);
+        if ((now_tick_ & ((std::uint64_t{1} << shift) - 1)) != 0) continue;
+        const auto slot = static_cast<std::size_t>(now_tick_ >> shift) & (kSlots - 1);
+        refile(static_cast<std::uint16_t>(level * kSlots + slot));
+    }
+}
+
+} // namespace ob
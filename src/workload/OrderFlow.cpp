@@ -0,0 +1,183 @@
+#include "workload/OrderFlow.h"
+
+#include "orderbook/OrderBook.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace workload {
+
+namespace {
+
+const char* side_text(ob::types::Side side) { return side == ob::types::Side::Buy ? "BUY" : "SELL"; }
+
+const char* tif_text(ob::types::TimeInForce tif) {
+    switch (tif) {
+    case ob::types::TimeInForce::IOC: return "IOC";
+    case ob::types::TimeInForce::FOK: return "FOK";
+    default: return "GFD";
+    }
+}
+
+} // namespace
+
+OrderFlow::OrderFlow(const Config& config)
+    : config_(config)
+    , rng_(config.seed) {
+    config_.symbols      = std::max<std::uint32_t>(config_.symbols, 1);
+    config_.max_distance = std::max<ob::types::Price>(config_.max_distance, 1);
+    config_.max_quantity = std::max<ob::types::Quantity>(config_.max_quantity, 1);
+    config_.rate         = std::max(config_.rate, 1.0);
+
+    zipf_cdf_.resize(config_.symbols);
+    double total = 0.0;
+    for (std::uint32_t k = 0; k < config_.symbols; ++k) {
+        total += 1.0 / std::pow(static_cast<double>(k + 1), config_.zipf_exponent);
+        zipf_cdf_[k] = total;
+    }
+    for (auto& c : zipf_cdf_) c /= total;
+
+    const auto start = std::clamp(config_.start_mid, min_price() + config_.max_distance + 8,
+                                  max_price() - config_.max_distance - 8);
+    symbols_.resize(config_.symbols);
+    for (auto& state : symbols_) state.mid = static_cast<double>(start);
+}
+
+ob::types::Price OrderFlow::min_price() const noexcept { return 0; }
+
+ob::types::Price OrderFlow::max_price() const noexcept {
+    return std::max(config_.start_mid * 2, 4 * config_.max_distance) + 2 * config_.max_distance + 16;
+}
+
+ob::types::Price OrderFlow::mid(std::uint32_t symbol) const noexcept {
+    return static_cast<ob::types::Price>(std::llround(symbols_[symbol].mid));
+}
+
+std::string OrderFlow::symbol_name(std::uint32_t symbol) { return "S" + std::to_string(symbol); }
+
+std::uint64_t OrderFlow::next_arrival() {
+    if (config_.arrivals == Arrivals::Poisson) {
+        now_s_ += -std::log1p(-unit_(rng_)) / config_.rate;
+    } else {
+        // Ogata thinning: propose from the current (upper-bound) intensity, accept with
+        // the ratio of the decayed intensity, and excite on acceptance.
+        for (;;) {
+            const double bound = config_.rate + excitation_;
+            const double dt = -std::log1p(-unit_(rng_)) / bound;
+            now_s_ += dt;
+            excitation_ *= std::exp(-config_.hawkes_beta * dt);
+            if (unit_(rng_) * bound <= config_.rate + excitation_) break;
+        }
+        excitation_ += config_.hawkes_alpha;
+    }
+    return static_cast<std::uint64_t>(now_s_ * 1e9);
+}
+
+std::uint32_t OrderFlow::pick_symbol() {
+    const auto it = std::upper_bound(zipf_cdf_.begin(), zipf_cdf_.end(), unit_(rng_));
+    return static_cast<std::uint32_t>(std::min<std::size_t>(it - zipf_cdf_.begin(), zipf_cdf_.size() - 1));
+}
+
+ob::types::Price OrderFlow::passive_price(const SymbolState& state, ob::types::Side side) {
+    // Discrete Pareto distance from the touch: most quotes sit near it, a heavy tail sits deep.
+    const double x = std::pow(1.0 - unit_(rng_), -1.0 / std::max(config_.distance_exponent - 1.0, 0.05));
+    const auto distance = std::min(static_cast<ob::types::Price>(x) - 1, config_.max_distance);
+    const auto m = static_cast<ob::types::Price>(std::llround(state.mid));
+    return side == ob::types::Side::Buy ? m - 1 - distance : m + 1 + distance;
+}
+
+void OrderFlow::fill_new(Event& event, SymbolState& state) {
+    event.action   = Action::New;
+    event.order    = next_id_++;
+    event.side     = (rng_() & 1) ? ob::types::Side::Sell : ob::types::Side::Buy;
+    const double q = unit_(rng_);
+    event.quantity = 1 + static_cast<ob::types::Quantity>(q * q * static_cast<double>(config_.max_quantity - 1));
+
+    const double roll = unit_(rng_);
+    if (roll < config_.aggress_ratio / std::max(1.0 - config_.cancel_ratio - config_.amend_ratio, 1e-9)) {
+        // Marketable: cross the touch by a few ticks.
+        event.tif = unit_(rng_) < config_.fok_share ? ob::types::TimeInForce::FOK : ob::types::TimeInForce::IOC;
+        const auto m = static_cast<ob::types::Price>(std::llround(state.mid));
+        const auto through = static_cast<ob::types::Price>(rng_() % 4);
+        event.price = event.side == ob::types::Side::Buy ? m + 1 + through : m - 1 - through;
+        return;
+    }
+    event.tif   = ob::types::TimeInForce::GFD;
+    event.price = passive_price(state, event.side);
+    state.live.push_back(event.order);
+    state.live_side.push_back(event.side);
+}
+
+Event OrderFlow::next() {
+    Event event;
+    event.timestamp_ns = next_arrival();
+    event.symbol       = pick_symbol();
+    SymbolState& state = symbols_[event.symbol];
+
+    const double low  = static_cast<double>(config_.max_distance + 8);
+    const double high = static_cast<double>(max_price() - config_.max_distance - 8);
+    state.mid = std::clamp(state.mid + config_.drift_ticks * drift_(rng_), low, high);
+
+    const double roll = unit_(rng_);
+    if (state.live.empty() || roll >= config_.cancel_ratio + config_.amend_ratio) {
+        fill_new(event, state);
+        return event;
+    }
+
+    const auto idx = static_cast<std::size_t>(rng_() % state.live.size());
+    event.order = state.live[idx];
+    event.side  = state.live_side[idx];
+    if (roll < config_.cancel_ratio) {
+        event.action = Action::Cancel;
+        state.live[idx]      = state.live.back();
+        state.live_side[idx] = state.live_side.back();
+        state.live.pop_back();
+        state.live_side.pop_back();
+    } else {
+        event.action   = Action::Amend;
+        event.tif      = ob::types::TimeInForce::GFD;
+        event.price    = passive_price(state, event.side);
+        event.quantity = 1 + static_cast<ob::types::Quantity>(rng_() % static_cast<std::uint64_t>(config_.max_quantity));
+    }
+    return event;
+}
+
+std::vector<Event> OrderFlow::generate(std::size_t count) {
+    std::vector<Event> events;
+    events.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) events.push_back(next());
+    return events;
+}
+
+void OrderFlow::write_text(std::ostream& os, const Event& event) {
+    os << symbol_name(event.symbol) << ' ';
+    switch (event.action) {
+    case Action::New:
+        os << side_text(event.side) << ' ' << tif_text(event.tif) << ' ' << event.price << ' ' << event.quantity
+           << " o" << event.order << '\n';
+        break;
+    case Action::Cancel:
+        os << "CANCEL o" << event.order << '\n';
+        break;
+    case Action::Amend:
+        os << "MODIFY o" << event.order << ' ' << side_text(event.side) << ' ' << event.price << ' '
+           << event.quantity << '\n';
+        break;
+    }
+}
+
+void OrderFlow::apply(ob::OrderBook& book, const Event& event) {
+    switch (event.action) {
+    case Action::New:
+        book.create_order(event.order, event.price, event.quantity, event.side, event.tif);
+        break;
+    case Action::Cancel:
+        book.cancel(event.order);
+        break;
+    case Action::Amend:
+        book.modify(event.order, event.side, event.price, event.quantity, ob::types::TimeInForce::GFD);
+        break;
+    }
+}
+
+} // namespace workload
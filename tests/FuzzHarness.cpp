@@ -1,14 +1,53 @@
 #include "orderbook/OrderBook.h"
+#include "workload/OrderFlow.h"
 
 #include <chrono>
 #include <cstdlib>
 #include <iostream>
+#include <memory>
 #include <random>
+#include <string>
 #include <vector>
 
+namespace {
+
+/// Replay realistic multi-symbol flow (sparse deep books, drifting touch, cancel-heavy).
+int run_workload(std::uint64_t seed, std::uint32_t symbols) {
+    workload::Config config;
+    config.seed    = seed;
+    config.symbols = symbols;
+    workload::OrderFlow flow(config);
+
+    constexpr std::size_t iterations = 1'000'000;
+    std::vector<std::unique_ptr<ob::OrderBook>> books;
+    for (std::uint32_t s = 0; s < symbols; ++s) {
+        books.push_back(std::make_unique<ob::OrderBook>(flow.min_price(), flow.max_price(), iterations));
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < iterations; ++i) {
+        const auto event = flow.next();
+        workload::OrderFlow::apply(*books[event.symbol], event);
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+    std::size_t live = 0;
+    for (const auto& book : books) live += book->live_orders();
+    std::cout << "Workload fuzz completed in " << elapsed.count() << " ms across " << symbols << " symbols with "
+              << live << " live orders remaining" << std::endl;
+    return 0;
+}
+
+} // namespace
+
+// Usage: orderbook_fuzz [seed] [--workload [symbols]]
 int main(int argc, char** argv) {
     std::uint64_t seed = 42;
     if (argc > 1) seed = std::strtoull(argv[1], nullptr, 10);
+    if (argc > 2 && std::string(argv[2]) == "--workload") {
+        const auto symbols = argc > 3 ? static_cast<std::uint32_t>(std::strtoul(argv[3], nullptr, 10)) : 16u;
+        return run_workload(seed, symbols == 0 ? 1 : symbols);
+    }
 
     std::mt19937_64 rng(seed);
     std::uniform_int_distribution<int> side_dist(0, 1);
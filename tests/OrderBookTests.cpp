@@ -2,13 +2,28 @@
 
 #include <chrono>
 #include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
 #include <iostream>
+#include <iterator>
+#include <memory>
+#include <random>
 #include <sstream>
+#include <stdexcept>
 #include <thread>
+#include <unistd.h>
 #include <vector>
 
+#include "engine/BinaryProtocol.h"
+#include "engine/CommandParser.h"
 #include "engine/Engine.h"
+#include "engine/InputReader.h"
+#include "engine/Instruments.h"
+#include "engine/ShmRing.h"
+#include "orderbook/BookSet.h"
 #include "orderbook/OrderBook.h"
+#include "workload/OrderFlow.h"
 
 namespace {
 
@@ -156,6 +171,827 @@ TEST(OrderBook, SnapshotDeterministicOutput) {
     EXPECT_EQ(oss.str(), expected);
 }
 
+TEST(OrderBook, CheckpointRestorePreservesPriority) {
+    ob::OrderBook book(/*min_price=*/95, /*max_price=*/105);
+    ASSERT_NE(book.create_order(1, 100, 4, ob::types::Side::Sell, ob::types::TimeInForce::GFD), nullptr);
+    ASSERT_NE(book.create_order(2, 100, 6, ob::types::Side::Sell, ob::types::TimeInForce::GFD), nullptr);
+    ASSERT_NE(book.create_order(3, 120, 2, ob::types::Side::Sell, ob::types::TimeInForce::GFD), nullptr);
+    ASSERT_NE(book.create_order(7, 90, 5, ob::types::Side::Buy, ob::types::TimeInForce::GFD), nullptr);
+
+    std::vector<char> image;
+    book.checkpoint(image);
+
+    ob::OrderBook restored(/*min_price=*/95, /*max_price=*/105);
+    ASSERT_TRUE(restored.restore(image.data(), image.size()));
+    EXPECT_EQ(restored.live_orders(), 4u);
+    ASSERT_NE(restored.find(7), nullptr);
+    EXPECT_EQ(restored.find(7)->price, 90);
+
+    std::ostringstream before;
+    std::ostringstream after;
+    book.snapshot(before);
+    restored.snapshot(after);
+    EXPECT_EQ(before.str(), after.str());
+
+    TradeCollector collector;
+    restored.set_trade_sink(&TradeCollector::sink, &collector);
+    restored.create_order(9, 100, 5, ob::types::Side::Buy, ob::types::TimeInForce::GFD);
+    ASSERT_EQ(collector.trades.size(), 2u);
+    EXPECT_EQ(collector.trades[0].resting_id, 1u);
+    EXPECT_EQ(collector.trades[1].resting_id, 2u);
+
+    EXPECT_FALSE(restored.restore(image.data(), image.size())); // not empty
+    ob::OrderBook truncated(/*min_price=*/95, /*max_price=*/105);
+    EXPECT_FALSE(truncated.restore(image.data(), image.size() - 1));
+    EXPECT_EQ(truncated.live_orders(), 0u);
+
+    // The header records the source pool: a smaller book refuses the image even when
+    // its free slots would cover the orders actually resting.
+    ob::OrderBook smaller(/*min_price=*/95, /*max_price=*/105, /*pool_capacity=*/500);
+    EXPECT_FALSE(smaller.restore(image.data(), image.size()));
+    EXPECT_EQ(smaller.live_orders(), 0u);
+}
+
+TEST(OrderBook, StopOrdersTriggerAndCascade) {
+    using ob::types::OrderType;
+    using ob::types::Side;
+    using ob::types::TimeInForce;
+    ob::OrderBook book(/*min_price=*/90, /*max_price=*/110);
+    TradeCollector collector;
+    book.set_trade_sink(&TradeCollector::sink, &collector);
+
+    ASSERT_NE(book.create_order(1, 101, 5, Side::Sell, TimeInForce::GFD), nullptr);
+    ASSERT_NE(book.create_order(2, 102, 5, Side::Sell, TimeInForce::GFD), nullptr);
+    ASSERT_NE(book.create_order(3, 104, 5, Side::Sell, TimeInForce::GFD), nullptr);
+    // Armed stops stay live but off-book.
+    ASSERT_NE(book.create_order(ob::OrderSpec{10, 102, 5, Side::Buy, TimeInForce::GFD, {}, OrderType::StopLimit, 101}), nullptr);
+    ASSERT_NE(book.create_order(ob::OrderSpec{11, 0, 3, Side::Buy, TimeInForce::GFD, {}, OrderType::Stop, 102}), nullptr);
+    ASSERT_NE(book.create_order(ob::OrderSpec{12, 0, 1, Side::Sell, TimeInForce::GFD, {}, OrderType::Stop, 95}), nullptr);
+    EXPECT_TRUE(collector.trades.empty());
+
+    // Trade at 101 fires stop 10, whose fill at 102 fires stop 11, which sweeps to 104.
+    EXPECT_EQ(book.create_order(20, 101, 5, Side::Buy, TimeInForce::GFD), nullptr);
+    ASSERT_EQ(collector.trades.size(), 3u);
+    EXPECT_EQ(collector.trades[0].incoming_id, 20u);
+    EXPECT_EQ(collector.trades[1].incoming_id, 10u);
+    EXPECT_EQ(collector.trades[1].resting_px, 102);
+    EXPECT_EQ(collector.trades[2].incoming_id, 11u);
+    EXPECT_EQ(collector.trades[2].resting_px, 104);
+    EXPECT_EQ(collector.trades[2].traded_qty, 3);
+    EXPECT_EQ(book.last_trade_price(), 104);
+    EXPECT_FALSE(book.has_order(10));
+    EXPECT_FALSE(book.has_order(11));
+    ASSERT_TRUE(book.has_order(12));
+    EXPECT_EQ(book.find(12)->type, OrderType::Stop);
+
+    // Armed stops survive a checkpoint together with the last trade price.
+    std::vector<char> image;
+    book.checkpoint(image);
+    ob::OrderBook restored(/*min_price=*/90, /*max_price=*/110);
+    ASSERT_TRUE(restored.restore(image.data(), image.size()));
+    ASSERT_NE(restored.find(12), nullptr);
+    EXPECT_EQ(restored.find(12)->stop_price, 95);
+    EXPECT_EQ(restored.last_trade_price(), 104);
+
+    // A stop already reached by the last trade fires immediately.
+    ASSERT_NE(book.create_order(4, 105, 2, Side::Sell, TimeInForce::GFD), nullptr);
+    EXPECT_EQ(book.create_order(ob::OrderSpec{13, 105, 2, Side::Buy, TimeInForce::GFD, {}, OrderType::StopLimit, 103}), nullptr);
+    EXPECT_EQ(collector.trades.back().incoming_id, 13u);
+    EXPECT_EQ(collector.trades.back().resting_id, 3u); // remainder of order 3 at 104
+    EXPECT_FALSE(book.has_order(3));
+
+    // A modify leaves a stop armed at its stop price: it neither trades nor fires.
+    book.modify(12, Side::Sell, 0, 2, TimeInForce::GFD);
+    ASSERT_NE(book.find(12), nullptr);
+    EXPECT_EQ(book.find(12)->type, OrderType::Stop);
+    EXPECT_EQ(book.find(12)->stop_price, 95);
+    EXPECT_EQ(book.find(12)->quantity, 2);
+    ASSERT_NE(book.create_order(ob::OrderSpec{14, 100, 1, Side::Sell, TimeInForce::GFD, {}, OrderType::StopLimit, 96}), nullptr);
+    ASSERT_NE(book.create_order(15, 100, 1, Side::Buy, TimeInForce::GFD), nullptr);
+    const auto trades = collector.trades.size();
+    book.modify(14, Side::Sell, 100, 1, TimeInForce::GFD); // would cross order 15 as a plain limit
+    EXPECT_EQ(collector.trades.size(), trades);
+    ASSERT_NE(book.find(14), nullptr);
+    EXPECT_EQ(book.find(14)->type, OrderType::StopLimit);
+    book.cancel(14);
+    book.cancel(15);
+
+    book.cancel(12);
+    EXPECT_FALSE(book.has_order(12));
+    EXPECT_EQ(book.live_orders(), 1u); // order 4
+
+    engine::SymbolTable symbols;
+    engine::CommandParser parser(symbols);
+    std::uint32_t symbol = 0;
+    engine::CommandRef cmd;
+    ASSERT_TRUE(parser.parse_line("AAPL BUY GFD 102 5 s1 STOPLIMIT 101", symbol, cmd));
+    EXPECT_EQ(cmd.order_type, OrderType::StopLimit);
+    EXPECT_EQ(cmd.stop_price, 101);
+    ASSERT_TRUE(parser.parse_line("AAPL SELL IOC 0 5 s2 STOP 95", symbol, cmd));
+    EXPECT_EQ(cmd.order_type, OrderType::Stop);
+}
+
+TEST(OrderBook, IcebergReplenishesAtTailOfLevel) {
+    using ob::types::Side;
+    using ob::types::TimeInForce;
+    ob::OrderBook book(/*min_price=*/90, /*max_price=*/110);
+    TradeCollector collector;
+    book.set_trade_sink(&TradeCollector::sink, &collector);
+
+    ob::OrderSpec iceberg{1, 100, 30, Side::Sell, TimeInForce::GFD};
+    iceberg.display = 10;
+    ASSERT_NE(book.create_order(iceberg), nullptr);
+    ASSERT_NE(book.create_order(2, 100, 5, Side::Sell, TimeInForce::GFD), nullptr);
+    std::ostringstream shown;
+    book.snapshot(shown);
+    EXPECT_EQ(shown.str(), "SELL:\n100 15\nBUY:\n"); // reserve is not displayed
+
+    // The first slice fills, the next one goes behind order 2.
+    book.create_order(3, 100, 12, Side::Buy, TimeInForce::GFD);
+    ASSERT_EQ(collector.trades.size(), 2u);
+    EXPECT_EQ(collector.trades[0].resting_id, 1u);
+    EXPECT_EQ(collector.trades[0].traded_qty, 10);
+    EXPECT_EQ(collector.trades[1].resting_id, 2u);
+    EXPECT_EQ(collector.trades[1].traded_qty, 2);
+    ASSERT_NE(book.find(1), nullptr);
+    EXPECT_EQ(book.find(1)->quantity, 10);
+    EXPECT_EQ(book.find(1)->hidden, 10);
+
+    // FOK counts the reserve: 3 + 10 visible + 10 hidden.
+    EXPECT_EQ(book.create_order(4, 100, 24, Side::Buy, TimeInForce::FOK), nullptr);
+    EXPECT_EQ(collector.trades.size(), 2u);
+    EXPECT_EQ(book.create_order(5, 100, 23, Side::Buy, TimeInForce::FOK), nullptr);
+    ASSERT_EQ(collector.trades.size(), 5u);
+    EXPECT_EQ(collector.trades[2].resting_id, 2u);
+    EXPECT_EQ(collector.trades[3].resting_id, 1u);
+    EXPECT_EQ(collector.trades[4].resting_id, 1u);
+    EXPECT_EQ(book.live_orders(), 0u);
+
+    // A modify keeps the slice size and hides the new reserve behind it.
+    iceberg.id = 6;
+    ASSERT_NE(book.create_order(iceberg), nullptr);
+    book.modify(6, Side::Sell, 101, 40, TimeInForce::GFD);
+    ASSERT_NE(book.find(6), nullptr);
+    EXPECT_EQ(book.find(6)->quantity, 10);
+    EXPECT_EQ(book.find(6)->hidden, 30);
+    shown.str("");
+    book.snapshot(shown);
+    EXPECT_EQ(shown.str(), "SELL:\n101 10\nBUY:\n");
+
+    engine::SymbolTable symbols;
+    engine::CommandParser parser(symbols);
+    std::uint32_t symbol = 0;
+    engine::CommandRef cmd;
+    ASSERT_TRUE(parser.parse_line("AAPL SELL GFD 100 30 i1 DISPLAY 10", symbol, cmd));
+    EXPECT_EQ(cmd.display, 10);
+}
+
+TEST(OrderBook, GoodTillTimeExpiresAndSurvivesEndOfDay) {
+    using ob::types::Side;
+    using ob::types::TimeInForce;
+    constexpr ob::types::Timestamp ms = 1'000'000;
+    constexpr ob::types::Timestamp hour = 3'600'000 * ms;
+    ob::OrderBook book(/*min_price=*/90, /*max_price=*/110);
+
+    auto gtt = [](ob::types::OrderId id, ob::types::Price px, Side side, ob::types::Timestamp until) {
+        ob::OrderSpec spec{id, px, 5, side, TimeInForce::GTT};
+        spec.expire_at = until;
+        return spec;
+    };
+    book.advance_time(10 * ms);
+    EXPECT_EQ(book.create_order(gtt(0, 100, Side::Sell, 10 * ms)), nullptr); // already expired
+    ASSERT_NE(book.create_order(gtt(1, 100, Side::Sell, 15 * ms + 1)), nullptr);
+    ASSERT_NE(book.create_order(gtt(2, 101, Side::Sell, 2 * hour)), nullptr);
+    ASSERT_NE(book.create_order(gtt(3, 102, Side::Sell, 40 * ms)), nullptr);
+    ASSERT_NE(book.create_order(gtt(4, 95, Side::Buy, 50 * 24 * hour)), nullptr); // past the wheel's span
+    ASSERT_NE(book.create_order(5, 96, 5, Side::Buy, TimeInForce::GFD), nullptr);
+    ob::OrderSpec stop{6, 0, 5, Side::Buy, TimeInForce::GFD, std::nullopt, ob::types::OrderType::Stop, 105};
+    ASSERT_NE(book.create_order(stop), nullptr);
+
+    book.cancel(3);
+    book.advance_time(15 * ms + 1); // expiry is rounded up to the next millisecond
+    EXPECT_TRUE(book.has_order(1));
+    book.advance_time(16 * ms);
+    EXPECT_FALSE(book.has_order(1));
+
+    // Modify keeps the expiry; the hour-long order cascades down the levels and fires on time.
+    book.modify(2, Side::Sell, 103, 5, TimeInForce::GTT);
+    ASSERT_NE(book.find(2), nullptr);
+    EXPECT_EQ(book.find(2)->expire_at, 2 * hour);
+    book.advance_time(2 * hour - 1);
+    EXPECT_TRUE(book.has_order(2));
+    book.advance_time(2 * hour);
+    EXPECT_FALSE(book.has_order(2));
+
+    // End of day removes day orders and armed stops in one sweep; GTT orders stay.
+    EXPECT_EQ(book.end_of_day(), 2u);
+    EXPECT_FALSE(book.has_order(5));
+    EXPECT_FALSE(book.has_order(6));
+    EXPECT_TRUE(book.has_order(4));
+    std::ostringstream shown;
+    book.snapshot(shown);
+    EXPECT_EQ(shown.str(), "SELL:\nBUY:\n95 5\n");
+
+    std::vector<char> bytes;
+    book.checkpoint(bytes);
+    ob::OrderBook restored(/*min_price=*/90, /*max_price=*/110);
+    ASSERT_TRUE(restored.restore(bytes.data(), bytes.size()));
+    EXPECT_EQ(restored.now(), 2 * hour);
+    restored.advance_time(50 * 24 * hour - 1);
+    EXPECT_TRUE(restored.has_order(4));
+    restored.advance_time(50 * 24 * hour);
+    EXPECT_EQ(restored.live_orders(), 0u);
+
+    engine::SymbolTable symbols;
+    engine::CommandParser parser(symbols);
+    std::uint32_t symbol = 0;
+    engine::CommandRef cmd;
+    ASSERT_TRUE(parser.parse_line("AAPL BUY GTT 100 5 g1 UNTIL 1700000000000000000", symbol, cmd));
+    EXPECT_EQ(cmd.tif, TimeInForce::GTT);
+    EXPECT_EQ(cmd.timestamp, 1'700'000'000'000'000'000u);
+    ASSERT_TRUE(parser.parse_line("AAPL TIME 42", symbol, cmd));
+    EXPECT_EQ(cmd.type, engine::Command::Type::Time);
+    EXPECT_EQ(cmd.timestamp, 42u);
+    ASSERT_TRUE(parser.parse_line("AAPL EOD", symbol, cmd));
+    EXPECT_EQ(cmd.type, engine::Command::Type::EndOfDay);
+}
+
+TEST(OrderBook, MassCancelByOwnerSideAndPrice) {
+    using ob::types::Side;
+    using ob::types::TimeInForce;
+    ob::OrderBook book(/*min_price=*/90, /*max_price=*/110);
+    TradeCollector collector;
+    book.set_trade_sink(&TradeCollector::sink, &collector);
+
+    auto tagged = [&](ob::types::OrderId id, ob::types::Price px, Side side, ob::types::OwnerId owner) {
+        ob::OrderSpec spec{id, px, 5, side, TimeInForce::GFD};
+        spec.owner = owner;
+        return book.create_order(spec);
+    };
+    // Owner 7 alone at 101 (whole-level clear), in runs around owner 8 at 102, and bidding.
+    ASSERT_NE(tagged(1, 101, Side::Sell, 7), nullptr);
+    ASSERT_NE(tagged(2, 101, Side::Sell, 7), nullptr);
+    ASSERT_NE(tagged(3, 102, Side::Sell, 7), nullptr);
+    ASSERT_NE(tagged(4, 102, Side::Sell, 8), nullptr);
+    ASSERT_NE(tagged(5, 102, Side::Sell, 7), nullptr);
+    ASSERT_NE(tagged(6, 102, Side::Sell, 7), nullptr);
+    ASSERT_NE(tagged(7, 99, Side::Buy, 7), nullptr);
+    ASSERT_NE(tagged(8, 95, Side::Buy, 7), nullptr);
+    ASSERT_NE(book.create_order(9, 98, 5, Side::Buy, TimeInForce::GFD), nullptr);
+    ob::OrderSpec stop{10, 0, 5, Side::Buy, TimeInForce::GFD, std::nullopt, ob::types::OrderType::Stop, 104};
+    stop.owner = 7;
+    ASSERT_NE(book.create_order(stop), nullptr);
+
+    EXPECT_EQ(book.mass_cancel(7, Side::Buy, ob::PriceRange{96, 100}), 1u);
+    EXPECT_FALSE(book.has_order(7));
+    EXPECT_TRUE(book.has_order(8));
+    EXPECT_EQ(book.mass_cancel(7, Side::Sell), 5u); // both ask levels
+    EXPECT_EQ(book.mass_cancel(7, Side::Sell), 0u);
+    EXPECT_TRUE(book.has_order(4));
+    std::ostringstream shown;
+    book.snapshot(shown);
+    EXPECT_EQ(shown.str(), "SELL:\n102 5\nBUY:\n98 5\n95 5\n");
+
+    // The best ask moved to 102 and the freed slots are reusable.
+    ASSERT_EQ(tagged(11, 102, Side::Buy, 7), nullptr);
+    ASSERT_EQ(collector.trades.size(), 1u);
+    EXPECT_EQ(collector.trades[0].resting_id, 4u);
+    EXPECT_EQ(book.mass_cancel(7), 2u); // the last bid and the armed buy stop
+    EXPECT_FALSE(book.has_order(10));
+    EXPECT_EQ(book.live_orders(), 1u);
+
+    engine::SymbolTable symbols;
+    engine::CommandParser parser(symbols);
+    std::uint32_t symbol = 0;
+    engine::CommandRef cmd;
+    ASSERT_TRUE(parser.parse_line("AAPL BUY GFD 100 5 o1 OWNER 7", symbol, cmd));
+    EXPECT_EQ(cmd.owner, 7u);
+    ASSERT_TRUE(parser.parse_line("AAPL MASSCANCEL 7 SELL 100 105", symbol, cmd));
+    EXPECT_EQ(cmd.type, engine::Command::Type::MassCancel);
+    EXPECT_EQ(cmd.cancel_side, Side::Sell);
+    ASSERT_TRUE(cmd.cancel_range.has_value());
+    EXPECT_EQ(cmd.cancel_range->high, 105);
+    ASSERT_TRUE(parser.parse_line("AAPL MASSCANCEL 7", symbol, cmd));
+    EXPECT_FALSE(cmd.cancel_side.has_value());
+    EXPECT_FALSE(cmd.cancel_range.has_value());
+}
+
+TEST(OrderBook, CallAuctionUncrossesAtEquilibrium) {
+    using ob::types::Side;
+    using ob::types::TimeInForce;
+    ob::OrderBook book(/*min_price=*/90, /*max_price=*/110);
+    TradeCollector collector;
+    book.set_trade_sink(&TradeCollector::sink, &collector);
+
+    book.begin_auction();
+    ASSERT_NE(book.create_order(1, 102, 5, Side::Buy, TimeInForce::GFD), nullptr);
+    ob::OrderSpec iceberg{2, 101, 10, Side::Buy, TimeInForce::GFD};
+    iceberg.display = 3; // the reserve counts towards the auction
+    ASSERT_NE(book.create_order(iceberg), nullptr);
+    ASSERT_NE(book.create_order(3, 100, 10, Side::Buy, TimeInForce::GFD), nullptr);
+    ASSERT_NE(book.create_order(4, 99, 5, Side::Buy, TimeInForce::GFD), nullptr);
+    ASSERT_NE(book.create_order(10, 99, 6, Side::Sell, TimeInForce::GFD), nullptr);
+    ASSERT_NE(book.create_order(11, 100, 8, Side::Sell, TimeInForce::GFD), nullptr);
+    ASSERT_NE(book.create_order(12, 101, 10, Side::Sell, TimeInForce::GFD), nullptr);
+    ASSERT_NE(book.create_order(13, 103, 5, Side::Sell, TimeInForce::GFD), nullptr);
+    EXPECT_EQ(book.create_order(14, 110, 5, Side::Buy, TimeInForce::IOC), nullptr);
+    EXPECT_TRUE(collector.trades.empty());
+
+    // Demand 30/25/15/5 and supply 6/14/24/24 over 99..102: 15 lots trade at 101.
+    const auto indicative = book.indicative_uncross();
+    ASSERT_TRUE(indicative.price.has_value());
+    EXPECT_EQ(*indicative.price, 101);
+    EXPECT_EQ(indicative.volume, 15);
+    EXPECT_EQ(indicative.imbalance, -9);
+
+    const auto result = book.uncross();
+    EXPECT_EQ(result.volume, 15);
+    EXPECT_FALSE(book.in_auction());
+    EXPECT_EQ(book.last_trade_price(), 101);
+    ASSERT_EQ(collector.trades.size(), 4u);
+    const std::pair<ob::types::OrderId, ob::types::OrderId> pairs[] = {{10, 1}, {10, 2}, {11, 2}, {12, 2}};
+    const ob::types::Quantity quantities[] = {5, 1, 8, 1};
+    for (std::size_t i = 0; i < 4; ++i) {
+        EXPECT_EQ(collector.trades[i].resting_id, pairs[i].first);
+        EXPECT_EQ(collector.trades[i].incoming_id, pairs[i].second);
+        EXPECT_EQ(collector.trades[i].traded_qty, quantities[i]);
+        EXPECT_EQ(collector.trades[i].resting_px, 101);
+        EXPECT_EQ(collector.trades[i].incoming_px, 101);
+    }
+    EXPECT_FALSE(book.has_order(2));
+    EXPECT_FALSE(book.has_order(11));
+    std::ostringstream shown;
+    book.snapshot(shown);
+    EXPECT_EQ(shown.str(), "SELL:\n101 9\n103 5\nBUY:\n100 10\n99 5\n");
+
+    // Continuous trading resumes against the uncrossed book.
+    collector.trades.clear();
+    EXPECT_EQ(book.create_order(15, 101, 3, Side::Buy, TimeInForce::IOC), nullptr);
+    ASSERT_EQ(collector.trades.size(), 1u);
+    EXPECT_EQ(collector.trades[0].resting_id, 12u);
+
+    // Equal volume and imbalance everywhere with buyers left over: the highest price wins.
+    // A stop reached during the call only fires once the auction has uncrossed.
+    ob::OrderBook pressure(/*min_price=*/90, /*max_price=*/110);
+    pressure.begin_auction();
+    ASSERT_NE(pressure.create_order(1, 101, 10, Side::Buy, TimeInForce::GFD), nullptr);
+    ASSERT_NE(pressure.create_order(2, 99, 5, Side::Sell, TimeInForce::GFD), nullptr);
+    ob::OrderSpec stop{3, 0, 2, Side::Buy, TimeInForce::GFD, std::nullopt, ob::types::OrderType::Stop, 100};
+    ASSERT_NE(pressure.create_order(stop), nullptr);
+    const auto pushed = pressure.uncross();
+    EXPECT_EQ(pushed.price, 101);
+    EXPECT_EQ(pushed.volume, 5);
+    EXPECT_FALSE(pressure.has_order(3));
+    EXPECT_EQ(pressure.live_orders(), 1u);
+    EXPECT_EQ(pressure.uncross().volume, 0);
+
+    engine::SymbolTable symbols;
+    engine::CommandParser parser(symbols);
+    std::uint32_t symbol = 0;
+    engine::CommandRef cmd;
+    ASSERT_TRUE(parser.parse_line("AAPL AUCTION", symbol, cmd));
+    EXPECT_EQ(cmd.type, engine::Command::Type::Auction);
+    ASSERT_TRUE(parser.parse_line("AAPL UNCROSS", symbol, cmd));
+    EXPECT_EQ(cmd.type, engine::Command::Type::Uncross);
+}
+
+TEST(OrderBook, PegGroupsFollowTheTouchAsOneBlock) {
+    using ob::types::PegType;
+    using ob::types::Side;
+    using ob::types::TimeInForce;
+    ob::OrderBook book(/*min_price=*/90, /*max_price=*/110);
+    TradeCollector collector;
+    book.set_trade_sink(&TradeCollector::sink, &collector);
+
+    auto pegged = [&](ob::types::OrderId id, Side side, ob::types::Quantity qty, PegType peg) {
+        ob::OrderSpec spec{id, 0, qty, side, TimeInForce::GFD};
+        spec.peg = peg;
+        return book.create_order(spec);
+    };
+    EXPECT_EQ(pegged(9, Side::Sell, 1, PegType::Primary), nullptr); // no ask to peg to
+    ASSERT_NE(book.create_order(1, 99, 5, Side::Buy, TimeInForce::GFD), nullptr);
+    ASSERT_NE(book.create_order(2, 103, 5, Side::Sell, TimeInForce::GFD), nullptr);
+    ASSERT_NE(pegged(10, Side::Buy, 2, PegType::Primary), nullptr);
+    ASSERT_NE(pegged(11, Side::Buy, 3, PegType::Primary), nullptr);
+    ASSERT_NE(book.create_order(12, 99, 1, Side::Buy, TimeInForce::GFD), nullptr);
+    ASSERT_NE(pegged(13, Side::Buy, 4, PegType::Primary), nullptr); // the group moves behind 12, then 13 joins it
+    ASSERT_NE(pegged(20, Side::Sell, 2, PegType::Mid), nullptr);     // mid 101 rounded up
+    ASSERT_NE(pegged(21, Side::Buy, 2, PegType::Mid), nullptr);      // 101 rounded down, held under the sell peg
+    ob::OrderSpec ioc{22, 0, 2, Side::Buy, TimeInForce::IOC};
+    ioc.peg = PegType::Market;
+    EXPECT_EQ(book.create_order(ioc), nullptr);
+    EXPECT_TRUE(collector.trades.empty());
+    std::ostringstream shown;
+    book.snapshot(shown);
+    EXPECT_EQ(shown.str(), "SELL:\n101 2\n103 5\nBUY:\n100 2\n99 15\n");
+
+    // A better limit bid drags the primary group up behind it and moves both mids.
+    ASSERT_NE(book.create_order(3, 100, 1, Side::Buy, TimeInForce::GFD), nullptr);
+    shown.str("");
+    book.snapshot(shown);
+    EXPECT_EQ(shown.str(), "SELL:\n102 2\n103 5\nBUY:\n101 2\n100 10\n99 6\n");
+
+    std::vector<char> bytes;
+    book.checkpoint(bytes);
+
+    // Time priority inside the level: the limit order that was there first, then the group in order.
+    EXPECT_EQ(book.create_order(4, 100, 8, Side::Sell, TimeInForce::GFD), nullptr);
+    ASSERT_EQ(collector.trades.size(), 4u);
+    const ob::types::OrderId expected[] = {21, 3, 10, 11};
+    for (std::size_t i = 0; i < 4; ++i) EXPECT_EQ(collector.trades[i].resting_id, expected[i]);
+    EXPECT_EQ(collector.trades[2].resting_px, 100);
+
+    // Only pegged orders left at 100, so the limit bid is 99 again: the group falls back behind it.
+    shown.str("");
+    book.snapshot(shown);
+    EXPECT_EQ(shown.str(), "SELL:\n101 2\n103 5\nBUY:\n99 10\n");
+    collector.trades.clear();
+    EXPECT_EQ(book.create_order(5, 99, 10, Side::Sell, TimeInForce::GFD), nullptr);
+    ASSERT_EQ(collector.trades.size(), 3u);
+    EXPECT_EQ(collector.trades[2].resting_id, 13u);
+
+    // Groups survive a checkpoint as contiguous runs and keep following the touch.
+    ob::OrderBook restored(/*min_price=*/90, /*max_price=*/110);
+    ASSERT_TRUE(restored.restore(bytes.data(), bytes.size()));
+    restored.cancel(3);
+    shown.str("");
+    restored.snapshot(shown);
+    EXPECT_EQ(shown.str(), "SELL:\n101 2\n103 5\nBUY:\n100 2\n99 15\n");
+    restored.begin_auction();
+    ob::OrderSpec in_call{30, 0, 1, Side::Buy, TimeInForce::GFD};
+    in_call.peg = PegType::Primary;
+    EXPECT_EQ(restored.create_order(in_call), nullptr);
+
+    // A joining peg never overtakes a limit order queued after its group.
+    ob::OrderBook joined(/*min_price=*/90, /*max_price=*/110);
+    collector.trades.clear();
+    joined.set_trade_sink(&TradeCollector::sink, &collector);
+    ASSERT_NE(joined.create_order(1, 100, 10, Side::Buy, TimeInForce::GFD), nullptr);
+    ASSERT_NE(joined.create_order(2, 110, 10, Side::Sell, TimeInForce::GFD), nullptr);
+    ob::OrderSpec joiner{3, 0, 10, Side::Buy, TimeInForce::GFD};
+    joiner.peg = PegType::Primary;
+    ASSERT_NE(joined.create_order(joiner), nullptr);
+    ASSERT_NE(joined.create_order(4, 100, 10, Side::Buy, TimeInForce::GFD), nullptr);
+    joiner.id = 5;
+    ASSERT_NE(joined.create_order(joiner), nullptr);
+    EXPECT_EQ(joined.create_order(6, 100, 40, Side::Sell, TimeInForce::GFD), nullptr);
+    ASSERT_EQ(collector.trades.size(), 4u);
+    const ob::types::OrderId join_order[] = {1, 4, 3, 5};
+    for (std::size_t i = 0; i < 4; ++i) EXPECT_EQ(collector.trades[i].resting_id, join_order[i]);
+
+    engine::SymbolTable symbols;
+    engine::CommandParser parser(symbols);
+    std::uint32_t symbol = 0;
+    engine::CommandRef cmd;
+    ASSERT_TRUE(parser.parse_line("AAPL BUY GFD 0 5 p1 PEG MID", symbol, cmd));
+    EXPECT_EQ(cmd.peg, PegType::Mid);
+}
+
+TEST(OrderBook, SelfTradePreventionModes) {
+    // Owner 5 rests ahead of owner 6 and then buys through both of them.
+    const auto run = [](ob::types::StpMode mode, TradeCollector& collector) {
+        auto book = std::make_unique<ob::OrderBook>(90, 110, 16);
+        book->set_stp_mode(mode);
+        book->set_trade_sink(&TradeCollector::sink, &collector);
+        ob::OrderSpec own{1, 100, 10, ob::types::Side::Sell, ob::types::TimeInForce::GFD};
+        own.owner = 5;
+        ob::OrderSpec other{2, 100, 10, ob::types::Side::Sell, ob::types::TimeInForce::GFD};
+        other.owner = 6;
+        ob::OrderSpec buy{3, 100, 15, ob::types::Side::Buy, ob::types::TimeInForce::GFD};
+        buy.owner = 5;
+        book->create_order(own);
+        book->create_order(other);
+        book->create_order(buy);
+        return book;
+    };
+
+    TradeCollector plain;
+    auto book = run(ob::types::StpMode::None, plain);
+    ASSERT_EQ(plain.trades.size(), 2u);
+    EXPECT_EQ(plain.trades[0].resting_id, 1u);
+
+    TradeCollector resting;
+    book = run(ob::types::StpMode::CancelResting, resting);
+    ASSERT_EQ(resting.trades.size(), 1u);
+    EXPECT_EQ(resting.trades[0].resting_id, 2u);
+    EXPECT_EQ(resting.trades[0].traded_qty, 10);
+    EXPECT_FALSE(book->has_order(1));
+    ASSERT_TRUE(book->has_order(3));
+    EXPECT_EQ(book->find(3)->quantity, 5);
+    EXPECT_EQ(book->open_quantity(5), 5);
+
+    TradeCollector incoming;
+    book = run(ob::types::StpMode::CancelIncoming, incoming);
+    EXPECT_TRUE(incoming.trades.empty());
+    EXPECT_FALSE(book->has_order(3));
+    EXPECT_TRUE(book->has_order(1));
+    EXPECT_TRUE(book->has_order(2));
+    EXPECT_EQ(book->open_quantity(5), 10);
+
+    TradeCollector both;
+    book = run(ob::types::StpMode::DecrementBoth, both);
+    ASSERT_EQ(both.trades.size(), 1u);
+    EXPECT_EQ(both.trades[0].resting_id, 2u);
+    EXPECT_EQ(both.trades[0].traded_qty, 5);
+    EXPECT_FALSE(book->has_order(1));
+    EXPECT_FALSE(book->has_order(3));
+    EXPECT_EQ(book->find(2)->quantity, 5);
+    EXPECT_EQ(book->open_quantity(5), 0);
+}
+
+TEST(OrderBook, MarketOrdersSweepToTheirBound) {
+    ob::OrderBook book(90, 110, 16);
+    TradeCollector collector;
+    book.set_trade_sink(&TradeCollector::sink, &collector);
+    book.set_market_protection(1);
+    book.create_order(1, 100, 5, ob::types::Side::Sell, ob::types::TimeInForce::GFD);
+    book.create_order(2, 101, 5, ob::types::Side::Sell, ob::types::TimeInForce::GFD);
+    book.create_order(3, 105, 5, ob::types::Side::Sell, ob::types::TimeInForce::GFD);
+
+    // Protected: the touch is 100, so the sweep stops at 101 and the rest is cancelled.
+    ob::OrderSpec protected_buy{10, 0, 20, ob::types::Side::Buy, ob::types::TimeInForce::GFD};
+    protected_buy.type = ob::types::OrderType::ProtectedMarket;
+    EXPECT_EQ(book.create_order(protected_buy), nullptr);
+    ASSERT_EQ(collector.trades.size(), 2u);
+    EXPECT_EQ(collector.trades[0].incoming_px, 100);
+    EXPECT_EQ(collector.trades[1].incoming_px, 101);
+    EXPECT_EQ(collector.trades[1].traded_qty, 5);
+    EXPECT_FALSE(book.has_order(10));
+
+    // Unprotected market orders sweep every level they need; FOK counts the whole side.
+    ob::OrderSpec fok{11, 0, 10, ob::types::Side::Buy, ob::types::TimeInForce::FOK};
+    fok.type = ob::types::OrderType::Market;
+    EXPECT_EQ(book.create_order(fok), nullptr);
+    EXPECT_EQ(collector.trades.size(), 2u);
+    ob::OrderSpec market{12, 0, 3, ob::types::Side::Buy, ob::types::TimeInForce::IOC};
+    market.type = ob::types::OrderType::Market;
+    book.create_order(market);
+    ASSERT_EQ(collector.trades.size(), 3u);
+    EXPECT_EQ(collector.trades[2].resting_px, 105);
+    EXPECT_EQ(collector.trades[2].incoming_px, 105);
+    EXPECT_EQ(book.find(3)->quantity, 2);
+
+    // Nothing to sweep: rejected without a trade.
+    ob::OrderSpec sell{13, 0, 3, ob::types::Side::Sell, ob::types::TimeInForce::IOC};
+    sell.type = ob::types::OrderType::Market;
+    EXPECT_EQ(book.create_order(sell), nullptr);
+    EXPECT_EQ(collector.trades.size(), 3u);
+
+    engine::SymbolTable symbols;
+    engine::CommandParser parser(symbols);
+    std::uint32_t symbol = 0;
+    engine::CommandRef cmd;
+    ASSERT_TRUE(parser.parse_line("AAPL BUY IOC 0 10 m1 PROTECTED", symbol, cmd));
+    EXPECT_EQ(cmd.order_type, ob::types::OrderType::ProtectedMarket);
+    ASSERT_TRUE(parser.parse_line("AAPL SELL IOC 0 10 m2 MARKET", symbol, cmd));
+    EXPECT_EQ(cmd.order_type, ob::types::OrderType::Market);
+}
+
+TEST(OrderBook, QueueAheadTracksFillsAndCancels) {
+    using ob::types::Side;
+    using ob::types::TimeInForce;
+    ob::OrderBook book(90, 110, 32);
+    book.create_order(1, 100, 10, Side::Buy, TimeInForce::GFD);
+    book.create_order(2, 100, 20, Side::Buy, TimeInForce::GFD);
+    book.create_order(3, 100, 30, Side::Buy, TimeInForce::GFD);
+    book.create_order(4, 100, 5, Side::Buy, TimeInForce::GFD);
+    EXPECT_EQ(book.queue_ahead(1), 0);
+    EXPECT_EQ(book.queue_ahead(2), 10);
+    EXPECT_EQ(book.queue_ahead(4), 60);
+
+    // Fills leave from the head: order 1 goes, order 2 is now at the front.
+    book.create_order(10, 100, 15, Side::Sell, TimeInForce::GFD);
+    EXPECT_EQ(book.queue_ahead(2), 0);
+    EXPECT_EQ(book.queue_ahead(3), 15);
+    EXPECT_EQ(book.queue_ahead(4), 45);
+
+    // Cancelling the tail changes nothing ahead; a later arrival queues behind the rest.
+    book.cancel(4);
+    book.create_order(5, 100, 7, Side::Buy, TimeInForce::GFD);
+    book.create_order(6, 100, 8, Side::Buy, TimeInForce::GFD);
+    EXPECT_EQ(book.queue_ahead(5), 45);
+    EXPECT_EQ(book.queue_ahead(6), 52);
+
+    // A mid-queue cancel is exact for later arrivals and bounded for those already behind.
+    book.cancel(3);
+    book.create_order(7, 100, 1, Side::Buy, TimeInForce::GFD);
+    EXPECT_EQ(book.queue_ahead(7), 30);
+    EXPECT_EQ(book.queue_ahead(5), 24); // 15 really: the rest of the level bounds it
+    book.create_order(11, 100, 16, Side::Sell, TimeInForce::GFD);
+    EXPECT_EQ(book.queue_ahead(5), 0);
+    EXPECT_EQ(book.queue_ahead(6), 7); // 6 really
+    EXPECT_EQ(book.queue_ahead(7), 14);
+
+    // Only resting, unpegged limit orders have a queue position.
+    EXPECT_EQ(book.queue_ahead(10), std::nullopt);
+    ob::OrderSpec stop{20, 0, 5, Side::Sell, TimeInForce::GFD};
+    stop.type = ob::types::OrderType::Stop;
+    stop.stop_price = 95;
+    book.create_order(stop);
+    EXPECT_EQ(book.queue_ahead(20), std::nullopt);
+    ob::OrderSpec pegged{21, 0, 5, Side::Buy, TimeInForce::GFD};
+    pegged.peg = ob::types::PegType::Primary;
+    book.create_order(pegged);
+    ASSERT_TRUE(book.has_order(21));
+    EXPECT_EQ(book.queue_ahead(21), std::nullopt);
+
+    // Removing the head, by cancel or by the end-of-day sweep, moves everyone behind it up.
+    ob::OrderBook fresh(90, 110, 16);
+    const auto gtt = [](ob::types::OrderId id, ob::types::Quantity qty) {
+        ob::OrderSpec spec{id, 105, qty, Side::Sell, TimeInForce::GTT};
+        spec.expire_at = 1'000'000'000;
+        return spec;
+    };
+    fresh.create_order(30, 105, 10, Side::Sell, TimeInForce::GFD);
+    fresh.create_order(gtt(31, 20));
+    fresh.create_order(gtt(32, 5));
+    fresh.create_order(gtt(33, 5));
+    fresh.create_order(gtt(34, 4));
+    fresh.end_of_day();
+    EXPECT_EQ(fresh.queue_ahead(31), 0);
+    EXPECT_EQ(fresh.queue_ahead(32), 20);
+    fresh.cancel(31);
+    EXPECT_EQ(fresh.queue_ahead(32), 0);
+    EXPECT_EQ(fresh.queue_ahead(33), 5);
+}
+
+TEST(OrderBook, QueueAheadNeverUnderstatesAmongPegArrivals) {
+    using ob::types::Side;
+    using ob::types::TimeInForce;
+    struct Queued {
+        ob::types::OrderId  id;
+        ob::types::Quantity qty;
+        bool                pegged;
+    };
+    for (std::uint32_t seed = 1; seed <= 60; ++seed) {
+        std::mt19937 rng(seed);
+        ob::OrderBook book(90, 110, 256);
+        TradeCollector collector;
+        book.set_trade_sink(&TradeCollector::sink, &collector);
+        // Order 1 holds the best bid at 100 and an ask holds the primary peg's reference.
+        ASSERT_NE(book.create_order(1, 100, 3, Side::Buy, TimeInForce::GFD), nullptr);
+        ASSERT_NE(book.create_order(2, 110, 1, Side::Sell, TimeInForce::GFD), nullptr);
+        std::vector<Queued> queue{{1, 3, false}};
+        for (ob::types::OrderId id = 3; id < 80; ++id) {
+            const ob::types::Quantity qty = 1 + static_cast<ob::types::Quantity>(rng() % 9);
+            switch (rng() % 3) {
+                case 0: {
+                    ob::OrderSpec spec{id, 0, qty, Side::Buy, TimeInForce::GFD};
+                    spec.peg = ob::types::PegType::Primary;
+                    ASSERT_NE(book.create_order(spec), nullptr);
+                    // The group moves to the tail as one run, then the new member queues behind it.
+                    std::vector<Queued> group;
+                    for (auto it = queue.begin(); it != queue.end();) {
+                        if (it->pegged) {
+                            group.push_back(*it);
+                            it = queue.erase(it);
+                        } else {
+                            ++it;
+                        }
+                    }
+                    queue.insert(queue.end(), group.begin(), group.end());
+                    queue.push_back({id, qty, true});
+                    break;
+                }
+                case 1:
+                    ASSERT_NE(book.create_order(id, 100, qty, Side::Buy, TimeInForce::GFD), nullptr);
+                    queue.push_back({id, qty, false});
+                    break;
+                default:
+                    if (queue.size() > 1) {
+                        const std::size_t victim = 1 + rng() % (queue.size() - 1); // order 1 stays
+                        book.cancel(queue[victim].id);
+                        queue.erase(queue.begin() + static_cast<std::ptrdiff_t>(victim));
+                    }
+                    break;
+            }
+            ob::types::Quantity level = 0;
+            for (const auto& entry : queue) level += entry.qty;
+            ob::types::Quantity ahead = 0;
+            for (const auto& entry : queue) {
+                if (!entry.pegged) {
+                    const auto reported = book.queue_ahead(entry.id);
+                    ASSERT_TRUE(reported.has_value());
+                    EXPECT_GE(*reported, ahead) << "seed " << seed << " order " << entry.id;
+                    EXPECT_LE(*reported, level - entry.qty) << "seed " << seed << " order " << entry.id;
+                }
+                ahead += entry.qty;
+            }
+        }
+        // The sweep fills in exactly the modelled priority.
+        ob::types::Quantity level = 0;
+        for (const auto& entry : queue) level += entry.qty;
+        EXPECT_EQ(book.create_order(999, 100, level, Side::Sell, TimeInForce::GFD), nullptr);
+        ASSERT_EQ(collector.trades.size(), queue.size()) << "seed " << seed;
+        for (std::size_t i = 0; i < queue.size(); ++i) {
+            EXPECT_EQ(collector.trades[i].resting_id, queue[i].id) << "seed " << seed;
+        }
+    }
+}
+
+TEST(OrderBook, StatsTrackHotPathWhenEnabled) {
+    // Counters are thread-local; a fresh thread starts from zero.
+    std::thread([] {
+        ob::OrderBook book(100, 110, /*pool_capacity=*/3);
+        book.create_order(0, 105, 5, ob::types::Side::Sell, ob::types::TimeInForce::GFD);
+        book.create_order(1, 105, 5, ob::types::Side::Sell, ob::types::TimeInForce::GFD);
+        book.create_order(2, 120, 5, ob::types::Side::Sell, ob::types::TimeInForce::GFD); // grows the ladder
+        book.create_order(3, 105, 5, ob::types::Side::Buy, ob::types::TimeInForce::GFD);  // pool full
+        book.cancel(2);
+        book.create_order(4, 105, 10, ob::types::Side::Buy, ob::types::TimeInForce::GFD);
+        book.create_order(5, 105, 5, ob::types::Side::Sell, ob::types::TimeInForce::FOK); // only FOK and MIN sum liquidity
+
+        const auto& stats = ob::OrderBook::stats();
+        if constexpr (ob::stats::enabled) {
+            EXPECT_EQ(stats.pool_exhausted, 1u);
+            EXPECT_GE(stats.ladder_growths, 1u);
+            EXPECT_EQ(stats.available_to_calls, 1u);
+            EXPECT_EQ(stats.fifo_depth_at_match.count, 2u);
+            EXPECT_EQ(stats.fifo_depth_at_match.max, 2u);
+            EXPECT_GE(stats.recompute_best_calls, 1u);
+        } else {
+            EXPECT_EQ(stats.pool_exhausted, 0u);
+            EXPECT_EQ(stats.available_to_calls, 0u);
+        }
+    }).join();
+
+    engine::SymbolTable symbols;
+    engine::CommandParser parser(symbols);
+    std::uint32_t symbol = 0;
+    engine::CommandRef cmd;
+    ASSERT_TRUE(parser.parse_line("AAPL STATS", symbol, cmd));
+    EXPECT_EQ(cmd.type, engine::Command::Type::Stats);
+}
+
+TEST(BookSet, BooksShareOnePoolAndIdIndex) {
+    using ob::types::Side;
+    using ob::types::TimeInForce;
+    ob::BookSet set(/*pool_capacity=*/4);
+    ob::OrderBook& low = set.open(0);
+    ob::OrderBook& high = set.open(5);
+    EXPECT_EQ(&set.open(5), &high);
+    EXPECT_EQ(set.size(), 2u);
+    EXPECT_EQ(set.book(3), nullptr);
+    TradeCollector collector;
+    low.set_trade_sink(&TradeCollector::sink, &collector);
+
+    ASSERT_NE(set.create_order(0, ob::OrderSpec{1, 100, 10, Side::Buy, TimeInForce::GFD}), nullptr);
+    ASSERT_NE(set.create_order(5, ob::OrderSpec{2, 1'005, 5, Side::Sell, TimeInForce::GFD}), nullptr);
+    EXPECT_EQ(set.create_order(3, ob::OrderSpec{3, 100, 1, Side::Buy, TimeInForce::GFD}), nullptr);
+
+    // One ID space: a live ID is a duplicate in every book, and only its own book sees it.
+    EXPECT_EQ(set.create_order(5, ob::OrderSpec{1, 1'001, 1, Side::Buy, TimeInForce::GFD}), nullptr);
+    EXPECT_EQ(high.find(1), nullptr);
+    high.cancel(1);
+    EXPECT_TRUE(low.has_order(1));
+    EXPECT_EQ(set.book_of(1), &low);
+    EXPECT_EQ(set.book_of(2), &high);
+    EXPECT_EQ(low.live_orders(), 1u);
+    EXPECT_EQ(set.live_orders(), 2u);
+
+    // Matching stays within a book.
+    set.create_order(0, ob::OrderSpec{4, 100, 4, Side::Sell, TimeInForce::GFD});
+    ASSERT_EQ(collector.trades.size(), 1u);
+    EXPECT_EQ(collector.trades[0].resting_id, 1u);
+    set.modify(1, Side::Buy, 99, 6, TimeInForce::GFD);
+    EXPECT_EQ(low.find(1)->price, 99);
+
+    // One pool: stops arm far from the prices seen so far, and a full pool refuses every book.
+    ob::OrderSpec stop{5, 0, 1, Side::Sell, TimeInForce::GFD};
+    stop.type = ob::types::OrderType::Stop;
+    stop.stop_price = 900;
+    ASSERT_NE(set.create_order(5, stop), nullptr);
+    ASSERT_NE(set.create_order(5, ob::OrderSpec{6, 1'009, 1, Side::Sell, TimeInForce::GFD}), nullptr);
+    EXPECT_EQ(set.live_orders(), 4u);
+    EXPECT_EQ(set.create_order(0, ob::OrderSpec{7, 95, 1, Side::Buy, TimeInForce::GFD}), nullptr);
+    set.cancel(2);
+    EXPECT_EQ(high.live_orders(), 2u);
+    EXPECT_NE(set.create_order(0, ob::OrderSpec{7, 95, 1, Side::Buy, TimeInForce::GFD}), nullptr);
+
+    // Each book checkpoints on its own.
+    std::vector<char> image;
+    low.checkpoint(image);
+    ob::OrderBook restored(90, 110);
+    ASSERT_TRUE(restored.restore(image.data(), image.size()));
+    EXPECT_EQ(restored.live_orders(), 2u);
+    EXPECT_TRUE(restored.has_order(7));
+
+    // The expiry wheel is built by the first GTT order, at whatever the clock says by then.
+    set.cancel(7);
+    ob::OrderBook& idle = set.open(9);
+    idle.advance_time(5'000'000);
+    EXPECT_EQ(idle.now(), 5'000'000u);
+    ob::OrderSpec gtt{8, 50, 1, Side::Buy, TimeInForce::GTT};
+    gtt.expire_at = 4'000'000;
+    EXPECT_EQ(idle.create_order(gtt), nullptr); // already expired
+    gtt.expire_at = 8'000'000;
+    ASSERT_NE(idle.create_order(gtt), nullptr);
+    idle.advance_time(7'000'000);
+    EXPECT_TRUE(idle.has_order(8));
+    idle.advance_time(8'000'000);
+    EXPECT_FALSE(idle.has_order(8));
+}
+
 TEST(EngineApp, ProcessesCommands) {
     testing::internal::CaptureStdout();
     engine::EngineApp app("AAPL", /*min_price=*/90, /*max_price=*/110, /*pool_capacity=*/1024);
@@ -195,6 +1031,627 @@ TEST(EngineApp, ProcessesCommands) {
     EXPECT_NE(output.find("BUY:"), std::string::npos);
 }
 
+TEST(EngineApp, RiskStageRejectsInCommandOrder) {
+    std::vector<std::string> lines;
+    const auto collect = [](std::string_view line, void* ctx) {
+        static_cast<std::vector<std::string>*>(ctx)->emplace_back(line);
+    };
+    {
+        engine::EngineApp app("AAPL", /*min_price=*/1, /*max_price=*/200, /*pool_capacity=*/64);
+        app.set_output_sink(collect, &lines);
+        engine::RiskLimits limits;
+        limits.max_order_qty = 100;
+        limits.max_notional  = 5'000;
+        limits.collar_bps    = 1'000;
+        limits.max_open_qty  = 60;
+        app.set_risk_limits(limits);
+
+        const auto order = [&app](engine::Command::Type type, const char* id, ob::types::Price price,
+                                  ob::types::Quantity qty, ob::types::OwnerId owner) {
+            engine::CommandRef ref;
+            ref.type  = type;
+            ref.id    = id;
+            ref.price = price;
+            ref.qty   = qty;
+            ref.side  = type == engine::Command::Type::Buy ? ob::types::Side::Buy : ob::types::Side::Sell;
+            ref.owner = owner;
+            return app.submit(ref);
+        };
+        using Type = engine::Command::Type;
+        EXPECT_TRUE(order(Type::Sell, "a1", 100, 10, 1));
+        EXPECT_TRUE(order(Type::Buy, "b1", 100, 10, 2));  // trades: the collar is now 90..110
+        EXPECT_FALSE(order(Type::Buy, "b2", 100, 200, 2)); // over the quantity limit
+        EXPECT_FALSE(order(Type::Buy, "b3", 100, 60, 2));  // 6000 over the notional limit
+        EXPECT_TRUE(order(Type::Buy, "b4", 80, 5, 2));     // outside the collar, caught on the worker
+        EXPECT_TRUE(order(Type::Sell, "a2", 105, 40, 1));
+        EXPECT_TRUE(order(Type::Sell, "a3", 106, 30, 1));  // 70 open for owner 1
+        EXPECT_TRUE(order(Type::Modify, "a2", 105, 45, 0)); // replaces its own 40
+        EXPECT_TRUE(order(Type::Sell, "a4", 106, 20, 1));  // 65 open for owner 1
+    }
+    const std::vector<std::string> expected{
+        "AAPL TRADE a1 100 10 b1 100 10",
+        "AAPL REJECT b2 QTY",
+        "AAPL REJECT b3 NOTIONAL",
+        "AAPL REJECT b4 COLLAR",
+        "AAPL REJECT a3 EXPOSURE",
+        "AAPL REJECT a4 EXPOSURE",
+    };
+    EXPECT_EQ(lines, expected);
+
+    // Exposure is counted per account whatever the tag's value; neighbouring tags stay apart.
+    lines.clear();
+    {
+        engine::EngineApp app("AAPL", /*min_price=*/1, /*max_price=*/200, /*pool_capacity=*/64);
+        app.set_output_sink(collect, &lines);
+        engine::RiskLimits limits;
+        limits.max_open_qty = 10;
+        app.set_risk_limits(limits);
+        const auto sell = [&app](const char* id, ob::types::Quantity qty, ob::types::OwnerId owner) {
+            engine::CommandRef ref;
+            ref.type  = engine::Command::Type::Sell;
+            ref.id    = id;
+            ref.price = 100;
+            ref.qty   = qty;
+            ref.side  = ob::types::Side::Sell;
+            ref.owner = owner;
+            return app.submit(ref);
+        };
+        EXPECT_TRUE(sell("c1", 8, 4'294'967'295u));
+        EXPECT_TRUE(sell("c2", 8, 4'294'967'294u));
+        EXPECT_TRUE(sell("c3", 3, 4'294'967'295u)); // 11 open for the first account
+        EXPECT_TRUE(sell("c4", 2, 4'294'967'294u));
+    }
+    EXPECT_EQ(lines, std::vector<std::string>{"AAPL REJECT c3 EXPOSURE"});
+
+    // Open quantity follows fills on both sides and drops with the order.
+    ob::OrderBook book(1, 200, 16);
+    ob::OrderSpec ask{1, 100, 30, ob::types::Side::Sell, ob::types::TimeInForce::GFD};
+    ask.owner   = 7;
+    ask.display = 10;
+    book.create_order(ask);
+    ob::OrderSpec bid{2, 100, 12, ob::types::Side::Buy, ob::types::TimeInForce::GFD};
+    bid.owner = 8;
+    book.create_order(bid);
+    EXPECT_EQ(book.open_quantity(7), 18);
+    EXPECT_EQ(book.open_quantity(8), 0);
+    book.cancel(1);
+    EXPECT_EQ(book.open_quantity(7), 0);
+}
+
+TEST(EngineApp, CheckpointRoundTripsAndReportsWriteFailures) {
+    char path[] = "/tmp/nanobook_ckpt_XXXXXX";
+    const int fd = ::mkstemp(path);
+    ASSERT_GE(fd, 0);
+    ::close(fd);
+
+    std::vector<std::string> lines;
+    const auto collect = [](std::string_view line, void* ctx) {
+        static_cast<std::vector<std::string>*>(ctx)->emplace_back(line);
+    };
+    engine::SymbolTable symbols;
+    engine::CommandParser parser(symbols);
+    {
+        engine::EngineApp app("AAPL", /*min_price=*/90, /*max_price=*/110, /*pool_capacity=*/64);
+        app.set_output_sink(collect, &lines);
+        const std::string script = std::string("AAPL SELL GFD 101 4 a1\n"
+                                               "AAPL BUY GFD 99 3 b1\n"
+                                               "AAPL CHECKPOINT /nonexistent-dir/book.ckpt\n"
+                                               "AAPL CHECKPOINT ") + path + "\n"
+                                 + "AAPL SELL GFD 102 2 a2\n";
+        parser.parse(script.data(), script.size(), [&](std::uint32_t, const engine::CommandRef& cmd) { app.submit(cmd); }, true);
+    }
+    EXPECT_EQ(lines, std::vector<std::string>{"AAPL ERROR WRITE /nonexistent-dir/book.ckpt"});
+
+    // A smaller pool than the one checkpointed refuses the image.
+    EXPECT_FALSE(engine::EngineApp("AAPL", 90, 110, 32).restore(path));
+
+    lines.clear();
+    {
+        engine::EngineApp app("AAPL", /*min_price=*/90, /*max_price=*/110, /*pool_capacity=*/64);
+        app.set_output_sink(collect, &lines);
+        ASSERT_TRUE(app.restore(path));
+        const std::string script = "AAPL BUY GFD 101 4 b2\n";
+        parser.parse(script.data(), script.size(), [&](std::uint32_t, const engine::CommandRef& cmd) { app.submit(cmd); }, true);
+    }
+    ::unlink(path);
+    EXPECT_EQ(lines, std::vector<std::string>{"AAPL TRADE a1 101 4 b2 101 4"});
+}
+
+TEST(EngineApp, InternsLargeOwnerTags) {
+    char path[] = "/tmp/nanobook_owner_XXXXXX";
+    const int fd = ::mkstemp(path);
+    ASSERT_GE(fd, 0);
+    ::close(fd);
+
+    std::vector<std::string> lines;
+    const auto collect = [](std::string_view line, void* ctx) {
+        static_cast<std::vector<std::string>*>(ctx)->emplace_back(line);
+    };
+    engine::SymbolTable symbols;
+    engine::CommandParser parser(symbols);
+    const auto run = [&](engine::EngineApp& app, const std::string& script) {
+        std::size_t accepted = 0;
+        parser.parse(script.data(), script.size(), [&](std::uint32_t, const engine::CommandRef& cmd) {
+            accepted += app.submit(cmd);
+        }, true);
+        return accepted;
+    };
+    {
+        engine::EngineApp app("AAPL", /*min_price=*/90, /*max_price=*/110, /*pool_capacity=*/64);
+        app.set_output_sink(collect, &lines);
+        EXPECT_EQ(run(app, std::string("AAPL SELL GFD 101 4 a1 OWNER 4000000000\n"
+                                       "AAPL SELL GFD 102 4 a2 OWNER 7\n"
+                                       "AAPL SELL GFD 103 4 a3 OWNER 4294967295\n"
+                                       "AAPL MASSCANCEL 12345\n" // never seen: refused
+                                       "AAPL CHECKPOINT ") + path + "\n"),
+                  4u);
+    }
+    {
+        engine::EngineApp app("AAPL", /*min_price=*/90, /*max_price=*/110, /*pool_capacity=*/64);
+        app.set_output_sink(collect, &lines);
+        ASSERT_TRUE(app.restore(path));
+        // The restored account table still maps each tag to its orders.
+        EXPECT_EQ(run(app, "AAPL MASSCANCEL 4000000000\n"
+                           "AAPL SELL GFD 104 1 a4 OWNER 4294967295\n"
+                           "AAPL MASSCANCEL 4294967295\n"
+                           "AAPL BUY IOC 110 20 b1\n"),
+                  4u);
+    }
+    ::unlink(path);
+    EXPECT_EQ(lines, std::vector<std::string>{"AAPL TRADE a2 102 4 b1 110 4"});
+}
+
+TEST(EngineApp, GroupsSymbolsOnOneWorker) {
+    std::vector<std::string> lines;
+    engine::SymbolTable symbols;
+    engine::CommandParser parser(symbols);
+    engine::SymbolStats aapl;
+    engine::SymbolStats msft;
+    {
+        engine::EngineApp app(/*lanes=*/2, /*pool_capacity=*/64);
+        app.set_output_sink([](std::string_view line, void* ctx) {
+            static_cast<std::vector<std::string>*>(ctx)->emplace_back(line);
+        }, &lines);
+        engine::Instrument nickel;
+        nickel.tick_size = 5;
+        EXPECT_TRUE(app.add_symbol(0, "AAPL"));
+        EXPECT_TRUE(app.add_symbol(1, "MSFT", &nickel));
+        EXPECT_FALSE(app.add_symbol(2, "IBM"));
+        app.set_stp_mode(ob::types::StpMode::CancelResting, 1);
+        EXPECT_FALSE(app.restore("/nonexistent"));
+
+        // Each lane has its own client IDs, tick and policy; the parser's symbol index is the lane.
+        std::size_t accepted = 0;
+        const std::string script = "AAPL SELL GFD 100 4 o1\n"
+                                   "MSFT SELL GFD 500 4 o1\n"
+                                   "MSFT SELL GFD 502 1 o2\n"
+                                   "AAPL BUY GFD 100 1 b1\n"
+                                   "AAPL CANCEL o1\n"
+                                   "MSFT BUY GFD 500 2 b1\n"
+                                   "MSFT CANCEL o1\n"
+                                   "MSFT SELL GFD 505 1 s1 OWNER 7\n"
+                                   "MSFT BUY GFD 505 1 s2 OWNER 7\n"
+                                   "AAPL CHECKPOINT /tmp/nanobook_group_checkpoint\n"
+                                   "IBM PRINT\n";
+        parser.parse(script.data(), script.size(), [&](std::uint32_t symbol, const engine::CommandRef& cmd) {
+            accepted += app.submit(symbol, cmd);
+        }, true);
+        EXPECT_EQ(accepted, 8u);
+
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+        do {
+            msft = app.market_stats(1);
+        } while (msft.bid != 505 && std::chrono::steady_clock::now() < deadline);
+        aapl = app.market_stats(0); // published before MSFT's last command ran
+    }
+    const std::vector<std::string> expected{
+        "MSFT REJECT o2 TICK",
+        "AAPL TRADE o1 100 1 b1 100 1",
+        "MSFT TRADE o1 500 2 b1 500 2",
+    };
+    EXPECT_EQ(lines, expected);
+    EXPECT_EQ(aapl.trades, 1u);
+    EXPECT_EQ(aapl.ask, 0);
+    EXPECT_EQ(msft.trades, 1u);
+    EXPECT_EQ(msft.ask, 0); // s1 was cancelled by its owner's own bid
+    EXPECT_EQ(msft.bid_qty, 1);
+}
+
+TEST(EngineApp, PublishesSessionStatsAndBars) {
+    char path[] = "/tmp/nanobook_bars_XXXXXX";
+    const int bars_fd = ::mkstemp(path);
+    ASSERT_GE(bars_fd, 0);
+    ::close(bars_fd);
+
+    engine::SymbolTable symbols;
+    engine::CommandParser parser(symbols);
+    engine::SymbolStats session;
+    {
+        engine::EngineApp app("AAPL", /*min_price=*/90, /*max_price=*/110, /*pool_capacity=*/64);
+        app.set_output_sink([](std::string_view, void*) {}, nullptr);
+        const std::string script = std::string("AAPL SELL GFD 100 4 a1\n"
+                                               "AAPL BUY GFD 100 4 b1\n"
+                                               "AAPL TIME 1500000000\n"
+                                               "AAPL SELL GFD 104 6 a2\n"
+                                               "AAPL BUY GFD 104 6 b2\n"
+                                               "AAPL SELL GFD 103 5 a3\n"
+                                               "AAPL BUY GFD 101 3 b3\n"
+                                               "AAPL BARS ") + path + "\n";
+        parser.parse(script.data(), script.size(), [&](std::uint32_t, const engine::CommandRef& cmd) { app.submit(cmd); }, true);
+
+        // The snapshot is published after each command; wait for the last order's quote.
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+        do {
+            session = app.market_stats();
+        } while (session.bid_qty != 3 && std::chrono::steady_clock::now() < deadline);
+    }
+    EXPECT_EQ(session.open, 100);
+    EXPECT_EQ(session.high, 104);
+    EXPECT_EQ(session.low, 100);
+    EXPECT_EQ(session.close, 104);
+    EXPECT_EQ(session.volume, 10);
+    EXPECT_EQ(session.trades, 2u);
+    EXPECT_DOUBLE_EQ(session.vwap(), 102.4);
+    EXPECT_EQ(session.bid, 101);
+    EXPECT_EQ(session.ask, 103);
+    EXPECT_DOUBLE_EQ(session.imbalance(), -0.25);
+    EXPECT_EQ(session.updated_at, 1'500'000'000u);
+
+    // Only the first second closed: the second trade's 1s bar and the minute are still open.
+    std::ifstream in(path, std::ios::binary);
+    std::vector<char> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    ::unlink(path);
+    ASSERT_EQ(bytes.size(), sizeof(engine::Bar));
+    engine::Bar bar;
+    std::memcpy(&bar, bytes.data(), sizeof(bar));
+    EXPECT_EQ(bar.start, 0u);
+    EXPECT_EQ(bar.interval_ms, 1'000u);
+    EXPECT_EQ(bar.trades, 1u);
+    EXPECT_EQ(bar.open, 100);
+    EXPECT_EQ(bar.volume, 4);
+}
+
+TEST(EngineApp, InstrumentFileSetsTickSizeAndBand) {
+    char path[] = "/tmp/nanobook_instruments_XXXXXX";
+    const int fd = ::mkstemp(path);
+    ASSERT_GE(fd, 0);
+    ::close(fd);
+    const auto write_file = [&path](const char* text) { std::ofstream(path, std::ios::trunc) << text; };
+
+    write_file("# symbol fields\n"
+               "AAPL tick=5 band=9000:11000 open-interest=32 stp=cancel-incoming market-protection=2\n"
+               "\n"
+               "MSFT   # defaults only\n");
+    const engine::InstrumentTable table = engine::InstrumentTable::load(path);
+    EXPECT_EQ(table.size(), 2u);
+    EXPECT_EQ(table.find("IBM"), nullptr);
+    ASSERT_NE(table.find("MSFT"), nullptr);
+    EXPECT_EQ(table.find("MSFT")->tick_size, 1);
+    EXPECT_FALSE(table.find("MSFT")->stp);
+    const engine::Instrument* aapl = table.find("AAPL");
+    ASSERT_NE(aapl, nullptr);
+    EXPECT_EQ(aapl->min_tick(), 1'800);
+    EXPECT_EQ(aapl->max_tick(), 2'200);
+    EXPECT_EQ(aapl->open_interest, 32u);
+    EXPECT_EQ(aapl->stp, ob::types::StpMode::CancelIncoming);
+    EXPECT_EQ(aapl->market_protection, 2);
+
+    write_file("AAPL tick=0\n");
+    EXPECT_THROW(engine::InstrumentTable::load(path), std::runtime_error);
+    write_file("AAPL speed=1\n");
+    EXPECT_THROW(engine::InstrumentTable::load(path), std::runtime_error);
+    write_file("AAPL tick=10 band=101:109\n");
+    EXPECT_THROW(engine::InstrumentTable::load(path), std::runtime_error);
+    // The book allocates a level per tick: the band is capped, overflow included.
+    write_file("AAPL tick=2 band=0:19999998\n");
+    EXPECT_EQ(engine::InstrumentTable::load(path).find("AAPL")->max_tick(), engine::max_band_ticks - 1);
+    write_file("# wide\nAAPL band=0:10000000\n");
+    try {
+        engine::InstrumentTable::load(path);
+        ADD_FAILURE() << "band wider than max_band_ticks accepted";
+    } catch (const std::runtime_error& error) {
+        EXPECT_EQ(std::string(error.what()), std::string(path) + ":2: band spans more than 10000000 ticks");
+    }
+    write_file("AAPL band=-9000000000000000000:9000000000000000000\n");
+    EXPECT_THROW(engine::InstrumentTable::load(path), std::runtime_error);
+    ::unlink(path);
+
+    // Client prices are checked and divided into ticks on the way in, multiplied on the way out.
+    std::vector<std::string> lines;
+    engine::SymbolTable symbols;
+    engine::CommandParser parser(symbols);
+    engine::SymbolStats session;
+    {
+        engine::EngineApp app("AAPL", *aapl);
+        app.set_output_sink([](std::string_view line, void* ctx) {
+            static_cast<std::vector<std::string>*>(ctx)->emplace_back(line);
+        }, &lines);
+        const std::string script = "AAPL SELL GFD 10000 4 a1\n"
+                                   "AAPL SELL GFD 10002 4 a2\n"
+                                   "AAPL SELL GFD 11005 4 a3\n"
+                                   "AAPL BUY GFD 10000 3 b1\n"
+                                   "AAPL MODIFY a1 SELL 10001 1\n";
+        parser.parse(script.data(), script.size(), [&](std::uint32_t, const engine::CommandRef& cmd) { app.submit(cmd); }, true);
+
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+        do {
+            session = app.market_stats();
+        } while (session.trades != 1 && std::chrono::steady_clock::now() < deadline);
+    }
+    const std::vector<std::string> expected{
+        "AAPL REJECT a2 TICK",
+        "AAPL REJECT a3 BAND",
+        "AAPL TRADE a1 10000 3 b1 10000 3",
+        "AAPL REJECT a1 TICK",
+    };
+    EXPECT_EQ(lines, expected);
+    EXPECT_EQ(session.close, 10'000);
+    EXPECT_EQ(session.ask, 10'000);
+    EXPECT_EQ(session.ask_qty, 1);
+}
+
+TEST(CommandParser, TokenizesBlocksInPlace) {
+    engine::SymbolTable symbols;
+    engine::CommandParser parser(symbols);
+    const std::string block =
+        "AAPL BUY IOC 101 5 taker1 MIN 3\n"
+        "MSFT SELL GFD 99 7 ask9\r\n"
+        "AAPL MODIFY taker1 SELL 102 4\n"
+        "AAPL BUY GFD notanumber 5 bad\n"
+        "AAPL CANCEL ask9\n"
+        "MSFT PRI";
+
+    std::vector<std::pair<std::uint32_t, engine::CommandRef>> parsed;
+    auto sink = [&](std::uint32_t symbol, const engine::CommandRef& cmd) { parsed.emplace_back(symbol, cmd); };
+    const auto used = parser.parse(block.data(), block.size(), sink);
+    EXPECT_EQ(block.substr(used), "MSFT PRI");
+    ASSERT_EQ(parsed.size(), 4u);
+
+    EXPECT_EQ(parsed[0].first, symbols.find("AAPL"));
+    EXPECT_EQ(parsed[0].second.type, engine::Command::Type::Buy);
+    EXPECT_EQ(parsed[0].second.tif, ob::types::TimeInForce::IOC);
+    EXPECT_EQ(parsed[0].second.price, 101);
+    EXPECT_EQ(parsed[0].second.qty, 5);
+    EXPECT_EQ(parsed[0].second.id, "taker1");
+    ASSERT_TRUE(parsed[0].second.min_qty.has_value());
+    EXPECT_EQ(*parsed[0].second.min_qty, 3);
+
+    EXPECT_EQ(parsed[1].first, symbols.find("MSFT"));
+    EXPECT_EQ(parsed[1].second.id, "ask9");
+    EXPECT_EQ(parsed[2].second.type, engine::Command::Type::Modify);
+    EXPECT_EQ(parsed[2].second.side, ob::types::Side::Sell);
+    EXPECT_EQ(parsed[3].second.type, engine::Command::Type::Cancel);
+    EXPECT_EQ(symbols.size(), 2u);
+
+    const std::string tail = "MSFT PRINT";
+    parsed.clear();
+    EXPECT_EQ(parser.parse(tail.data(), tail.size(), sink, /*final=*/true), tail.size());
+    ASSERT_EQ(parsed.size(), 1u);
+    EXPECT_EQ(parsed[0].second.type, engine::Command::Type::Print);
+}
+
+TEST(BinaryProtocol, RoundTripsThroughEncoderAndParser) {
+    engine::SymbolTable text_symbols;
+    engine::CommandParser text_parser(text_symbols);
+    engine::wire::BinaryEncoder encoder(text_symbols);
+    const std::string text =
+        "MSFT SELL FOK 99 7 a\n"
+        "AAPL BUY GFD 101 5 b MIN 2\n"
+        "AAPL MODIFY b SELL 102 4\n"
+        "MSFT CANCEL a\n"
+        "AAPL PRINT\n"
+        "AAPL BUY GFD 100 3 c OWNER 9\n"
+        "AAPL MASSCANCEL 9 BUY 95 100\n";
+    std::vector<char> wire_bytes;
+    std::uint64_t next_id = 40;
+    text_parser.parse(text.data(), text.size(), [&](std::uint32_t symbol, const engine::CommandRef& cmd) {
+        ASSERT_TRUE(encoder.encode(symbol, cmd, next_id++, wire_bytes));
+    });
+    EXPECT_EQ(wire_bytes.size(), 2 * sizeof(engine::wire::SymbolDefinition) + 3 * sizeof(engine::wire::NewOrder)
+                                     + sizeof(engine::wire::Modify) + sizeof(engine::wire::Cancel)
+                                     + sizeof(engine::wire::Print) + sizeof(engine::wire::MassCancel));
+
+    engine::SymbolTable symbols;
+    symbols.intern("GOOG"); // stream-local indices are remapped onto the existing table
+    engine::wire::BinaryParser parser(symbols);
+    std::vector<std::pair<std::uint32_t, engine::CommandRef>> decoded;
+    std::vector<std::string> ids;
+    auto sink = [&](std::uint32_t symbol, const engine::CommandRef& cmd) {
+        decoded.emplace_back(symbol, cmd);
+        ids.emplace_back(cmd.id);
+    };
+
+    // Feed a partial block first: the trailing half message must be left unconsumed.
+    const std::size_t split = sizeof(engine::wire::SymbolDefinition) + sizeof(engine::wire::NewOrder) / 2;
+    EXPECT_EQ(parser.parse(wire_bytes.data(), split, sink), sizeof(engine::wire::SymbolDefinition));
+    EXPECT_EQ(parser.parse(wire_bytes.data(), wire_bytes.size(), sink), wire_bytes.size());
+    EXPECT_EQ(parser.errors(), 0u);
+
+    ASSERT_EQ(decoded.size(), 7u);
+    EXPECT_EQ(decoded[0].first, symbols.find("MSFT"));
+    EXPECT_EQ(decoded[0].second.type, engine::Command::Type::Sell);
+    EXPECT_EQ(decoded[0].second.tif, ob::types::TimeInForce::FOK);
+    EXPECT_EQ(ids[0], "40");
+    EXPECT_EQ(decoded[1].first, symbols.find("AAPL"));
+    EXPECT_EQ(decoded[1].second.price, 101);
+    ASSERT_TRUE(decoded[1].second.min_qty.has_value());
+    EXPECT_EQ(*decoded[1].second.min_qty, 2);
+    EXPECT_EQ(decoded[2].second.type, engine::Command::Type::Modify);
+    EXPECT_EQ(decoded[2].second.side, ob::types::Side::Sell);
+    EXPECT_EQ(decoded[3].second.type, engine::Command::Type::Cancel);
+    EXPECT_EQ(decoded[4].second.type, engine::Command::Type::Print);
+    EXPECT_EQ(decoded[1].second.owner, 0u);
+    EXPECT_EQ(decoded[5].second.owner, 9u);
+    EXPECT_EQ(ids[5], "45");
+    EXPECT_EQ(decoded[6].second.type, engine::Command::Type::MassCancel);
+    EXPECT_EQ(decoded[6].second.owner, 9u);
+    EXPECT_EQ(decoded[6].second.cancel_side, ob::types::Side::Buy);
+    ASSERT_TRUE(decoded[6].second.cancel_range.has_value());
+    EXPECT_EQ(decoded[6].second.cancel_range->low, 95);
+    EXPECT_EQ(decoded[6].second.cancel_range->high, 100);
+
+    auto* corrupt = reinterpret_cast<engine::wire::NewOrder*>(wire_bytes.data() + sizeof(engine::wire::SymbolDefinition));
+    corrupt->quantity = 0;
+    decoded.clear();
+    engine::wire::BinaryParser strict(symbols);
+    EXPECT_EQ(strict.parse(wire_bytes.data(), wire_bytes.size(), sink), wire_bytes.size());
+    EXPECT_EQ(strict.errors(), 1u);
+    EXPECT_EQ(decoded.size(), 6u);
+}
+
+TEST(BinaryProtocol, RejectsDefinitionsBeyondSymbolLimit) {
+    engine::SymbolTable symbols;
+    engine::wire::BinaryParser parser(symbols);
+    engine::wire::SymbolDefinition define{};
+    define.header = engine::wire::make_header<engine::wire::SymbolDefinition>(
+        engine::wire::MessageType::SymbolDefinition, 4000000000u);
+    define.name_length = 4;
+    std::memcpy(define.name, "AAPL", 4);
+    engine::wire::Print print{engine::wire::make_header<engine::wire::Print>(engine::wire::MessageType::Print, 4000000000u)};
+
+    std::vector<char> bytes(sizeof(define) + sizeof(print));
+    std::memcpy(bytes.data(), &define, sizeof(define));
+    std::memcpy(bytes.data() + sizeof(define), &print, sizeof(print));
+    std::size_t calls = 0;
+    auto sink = [&](std::uint32_t, const engine::CommandRef&) { ++calls; };
+    EXPECT_EQ(parser.parse(bytes.data(), bytes.size(), sink), bytes.size());
+    EXPECT_EQ(parser.errors(), 2u); // rejected define, then an unknown symbol
+    EXPECT_EQ(calls, 0u);
+    EXPECT_EQ(symbols.size(), 0u);
+
+    define.header.symbol = engine::wire::max_symbols - 1;
+    print.header.symbol  = engine::wire::max_symbols - 1;
+    std::memcpy(bytes.data(), &define, sizeof(define));
+    std::memcpy(bytes.data() + sizeof(define), &print, sizeof(print));
+    EXPECT_EQ(parser.parse(bytes.data(), bytes.size(), sink), bytes.size());
+    EXPECT_EQ(parser.errors(), 2u);
+    EXPECT_EQ(calls, 1u);
+}
+
+TEST(ShmRing, ClientMessagesDecodeFromSegment) {
+    const std::string name = "/nanobook_test_" + std::to_string(::getpid());
+    EXPECT_THROW(engine::shm::RingSegment::create(name, 1, 3), std::invalid_argument);
+
+    auto segment = engine::shm::RingSegment::create(name, /*rings=*/2, /*slot_count=*/4);
+    engine::shm::IngressClient client(name);
+    EXPECT_TRUE(client.define_symbol(1, 0, "AAPL"));
+    EXPECT_TRUE(client.new_order(1, 0, 17, ob::types::Side::Buy, ob::types::TimeInForce::IOC, 101, 5, 2));
+    EXPECT_TRUE(client.cancel(1, 0, 17));
+    EXPECT_TRUE(client.print(1, 0));
+    EXPECT_FALSE(client.print(1, 0)); // ring full
+    EXPECT_FALSE(client.print(2, 0)); // no such ring
+
+    engine::SymbolTable symbols;
+    engine::wire::BinaryParser parser(symbols);
+    std::vector<engine::CommandRef> decoded;
+    std::vector<std::string> ids;
+    EXPECT_EQ(segment.drain(0, [](const char*, std::size_t) {}), 0u);
+    const auto drained = segment.drain(1, [&](const char* slot, std::size_t slot_size) {
+        const auto* header = reinterpret_cast<const engine::wire::MessageHeader*>(slot);
+        parser.parse(slot, std::min<std::size_t>(header->length, slot_size),
+                     [&](std::uint32_t, const engine::CommandRef& cmd) {
+                         decoded.push_back(cmd);
+                         ids.emplace_back(cmd.id);
+                     });
+    });
+    EXPECT_EQ(drained, 4u);
+    ASSERT_EQ(decoded.size(), 3u);
+    EXPECT_EQ(decoded[0].type, engine::Command::Type::Buy);
+    EXPECT_EQ(decoded[0].tif, ob::types::TimeInForce::IOC);
+    EXPECT_EQ(ids[0], "17");
+    EXPECT_EQ(decoded[1].type, engine::Command::Type::Cancel);
+    EXPECT_EQ(decoded[2].type, engine::Command::Type::Print);
+    EXPECT_EQ(symbols.find("AAPL"), 0u);
+
+    EXPECT_TRUE(client.print(1, 0)); // slots are reusable once drained
+    EXPECT_FALSE(segment.shutdown_requested());
+    client.shutdown();
+    EXPECT_TRUE(segment.shutdown_requested());
+}
+
+TEST(InputReader, MergesFilesAndPipesOnBothBackends) {
+    for (bool allow_uring : {true, false}) {
+        char path[] = "/tmp/nanobook_input_XXXXXX";
+        const int file_fd = ::mkstemp(path);
+        ASSERT_GE(file_fd, 0);
+        ::unlink(path);
+        std::string file_text;
+        for (int i = 0; i < 2000; ++i) file_text += "AAPL BUY GFD 100 1 f" + std::to_string(i) + "\n";
+        file_text += "AAPL PRINT"; // no trailing newline: delivered as the final block
+        ASSERT_EQ(::write(file_fd, file_text.data(), file_text.size()), static_cast<ssize_t>(file_text.size()));
+        ::lseek(file_fd, 0, SEEK_SET);
+
+        int pipe_fds[2];
+        ASSERT_EQ(::pipe(pipe_fds), 0);
+        const std::string pipe_text = "MSFT SELL GFD 101 2 p0\nMSFT CANCEL p0\n";
+        ASSERT_EQ(::write(pipe_fds[1], pipe_text.data(), pipe_text.size()), static_cast<ssize_t>(pipe_text.size()));
+        ::close(pipe_fds[1]);
+
+        // A small block forces many partial lines to be carried between reads.
+        engine::io::MultiSourceReader reader({file_fd, pipe_fds[0]}, /*block_size=*/4096, allow_uring);
+        if (!allow_uring) {
+#if defined(__linux__)
+            EXPECT_EQ(reader.backend(), engine::io::MultiSourceReader::Backend::Epoll);
+#else
+            EXPECT_EQ(reader.backend(), engine::io::MultiSourceReader::Backend::Blocking);
+#endif
+        }
+
+        engine::SymbolTable symbols;
+        engine::CommandParser parser(symbols);
+        std::size_t per_source[2] = {0, 0};
+        std::size_t prints = 0;
+        auto consume = [&](std::size_t source, const char* data, std::size_t size, bool final) {
+            return parser.parse(data, size, [&](std::uint32_t, const engine::CommandRef& cmd) {
+                ++per_source[source];
+                if (cmd.type == engine::Command::Type::Print) ++prints;
+            }, final);
+        };
+        reader.run(consume);
+        EXPECT_EQ(per_source[0], 2001u);
+        EXPECT_EQ(per_source[1], 2u);
+        EXPECT_EQ(prints, 1u);
+        ::close(file_fd);
+        ::close(pipe_fds[0]);
+    }
+}
+
+TEST(Workload, SeededStreamsAreDeterministicAndParse) {
+    workload::Config config;
+    config.seed     = 99;
+    config.symbols  = 8;
+    config.arrivals = workload::Arrivals::Hawkes;
+
+    std::ostringstream first;
+    std::ostringstream second;
+    workload::OrderFlow a(config);
+    workload::OrderFlow b(config);
+    std::size_t cancels = 0;
+    std::uint64_t last_ts = 0;
+    std::vector<std::size_t> per_symbol(config.symbols, 0);
+    for (int i = 0; i < 20'000; ++i) {
+        const auto event = a.next();
+        EXPECT_GE(event.timestamp_ns, last_ts);
+        last_ts = event.timestamp_ns;
+        if (event.action == workload::Action::Cancel) ++cancels;
+        ++per_symbol[event.symbol];
+        EXPECT_GE(event.price, 0);
+        workload::OrderFlow::write_text(first, event);
+        workload::OrderFlow::write_text(second, b.next());
+    }
+    EXPECT_EQ(first.str(), second.str());
+    EXPECT_GT(cancels, 5'000u);            // cancel-heavy by default
+    EXPECT_GT(per_symbol[0], per_symbol[7]); // Zipf skew
+
+    engine::SymbolTable symbols;
+    engine::CommandParser parser(symbols);
+    std::size_t parsed = 0;
+    const auto text = first.str();
+    parser.parse(text.data(), text.size(), [&](std::uint32_t, const engine::CommandRef&) { ++parsed; }, true);
+    EXPECT_EQ(parsed, 20'000u);
+    EXPECT_EQ(symbols.size(), 8u);
+}
+
 TEST(OrderBookPerf, OperationsWithinOneSecond) {
     using clock = std::chrono::steady_clock;
     constexpr auto duration = std::chrono::seconds{1};
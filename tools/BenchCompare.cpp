@@ -0,0 +1,209 @@
+#include "BenchResults.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+namespace {
+
+void usage(const char* argv0) {
+    std::cerr << "usage: " << argv0 << " <baseline.json> <current.json> [--threshold FRACTION] [--confidence LEVEL]\n";
+}
+
+/// Continued fraction for the regularized incomplete beta function (Lentz's method).
+double beta_fraction(double a, double b, double x) {
+    constexpr double tiny = 1e-300;
+    double c = 1.0;
+    double d = 1.0 - (a + b) * x / (a + 1.0);
+    if (std::fabs(d) < tiny) d = tiny;
+    d = 1.0 / d;
+    double h = d;
+    for (int m = 1; m <= 300; ++m) {
+        const double m2 = 2.0 * m;
+        double aa = m * (b - m) * x / ((a + m2 - 1.0) * (a + m2));
+        d = 1.0 + aa * d;
+        if (std::fabs(d) < tiny) d = tiny;
+        c = 1.0 + aa / c;
+        if (std::fabs(c) < tiny) c = tiny;
+        d = 1.0 / d;
+        h *= d * c;
+        aa = -(a + m) * (a + b + m) * x / ((a + m2) * (a + m2 + 1.0));
+        d = 1.0 + aa * d;
+        if (std::fabs(d) < tiny) d = tiny;
+        c = 1.0 + aa / c;
+        if (std::fabs(c) < tiny) c = tiny;
+        d = 1.0 / d;
+        const double delta = d * c;
+        h *= delta;
+        if (std::fabs(delta - 1.0) < 1e-12) break;
+    }
+    return h;
+}
+
+double incomplete_beta(double a, double b, double x) {
+    if (x <= 0.0) return 0.0;
+    if (x >= 1.0) return 1.0;
+    const double front =
+        std::exp(std::lgamma(a + b) - std::lgamma(a) - std::lgamma(b) + a * std::log(x) + b * std::log1p(-x));
+    if (x < (a + 1.0) / (a + b + 2.0)) return front * beta_fraction(a, b, x) / a;
+    return 1.0 - front * beta_fraction(b, a, 1.0 - x) / b;
+}
+
+/// Student t CDF with @p df (possibly fractional) degrees of freedom.
+double t_cdf(double t, double df) {
+    const double tail = 0.5 * incomplete_beta(df / 2.0, 0.5, df / (df + t * t));
+    return t >= 0.0 ? 1.0 - tail : tail;
+}
+
+/// Two-sided critical value: P(|T| <= q) == @p confidence.
+double t_quantile(double confidence, double df) {
+    const double target = 0.5 + confidence / 2.0;
+    double lo = 0.0;
+    double hi = 1e3;
+    for (int i = 0; i < 200; ++i) {
+        const double mid = 0.5 * (lo + hi);
+        (t_cdf(mid, df) < target ? lo : hi) = mid;
+    }
+    return 0.5 * (lo + hi);
+}
+
+struct Summary {
+    double mean{0.0};
+    double variance{0.0};
+    double n{0.0};
+};
+
+Summary summarize(const std::vector<double>& samples) {
+    Summary s;
+    s.n = static_cast<double>(samples.size());
+    if (samples.empty()) return s;
+    for (double v : samples) s.mean += v;
+    s.mean /= s.n;
+    for (double v : samples) s.variance += (v - s.mean) * (v - s.mean);
+    s.variance = samples.size() > 1 ? s.variance / (s.n - 1.0) : 0.0;
+    return s;
+}
+
+enum class Verdict { Unchanged, Regression, Improvement, Insufficient };
+
+struct Comparison {
+    double  change{0.0}; ///< Relative change of the mean, signed so that positive is worse.
+    double  low{0.0};    ///< Confidence interval on @ref change.
+    double  high{0.0};
+    Verdict verdict{Verdict::Insufficient};
+};
+
+/**
+ * Welch's t interval on the difference of means, scaled by the baseline mean. The
+ * change counts only when the whole interval lies on one side of zero and the point
+ * estimate exceeds @p threshold, so noise on a quiet machine is not reported as a
+ * regression and a tiny but consistent shift does not fail the check.
+ */
+Comparison compare(const benchres::Metric& base, const benchres::Metric& cur, double threshold, double confidence) {
+    Comparison c;
+    if (base.samples.size() < 2 || cur.samples.size() < 2) return c;
+    const Summary b = summarize(base.samples);
+    const Summary k = summarize(cur.samples);
+    if (b.mean == 0.0) return c;
+
+    const double sign = base.higher_is_better ? -1.0 : 1.0;
+    const double vb = b.variance / b.n;
+    const double vk = k.variance / k.n;
+    const double se = std::sqrt(vb + vk);
+    double margin = 0.0;
+    if (se > 0.0) {
+        const double df = (vb + vk) * (vb + vk) / (vb * vb / (b.n - 1.0) + vk * vk / (k.n - 1.0));
+        margin = t_quantile(confidence, df) * se;
+    }
+    const double diff = sign * (k.mean - b.mean);
+    c.change = diff / std::fabs(b.mean);
+    c.low = (diff - margin) / std::fabs(b.mean);
+    c.high = (diff + margin) / std::fabs(b.mean);
+    if (c.low > 0.0 && c.change > threshold) c.verdict = Verdict::Regression;
+    else if (c.high < 0.0 && -c.change > threshold) c.verdict = Verdict::Improvement;
+    else c.verdict = Verdict::Unchanged;
+    return c;
+}
+
+const char* label(Verdict v) {
+    switch (v) {
+    case Verdict::Regression:  return "REGRESSION";
+    case Verdict::Improvement: return "improved";
+    case Verdict::Unchanged:   return "~";
+    default:                   return "n<2";
+    }
+}
+
+} // namespace
+
+/**
+ * Compare a current `bench_runner` result file against a stored baseline. Prints one
+ * row per metric with the relative change (positive = worse) and its confidence
+ * interval; exits with status 1 when any metric regressed significantly.
+ */
+int main(int argc, char** argv) {
+    std::vector<std::string> files;
+    double threshold = 0.02;
+    double confidence = 0.95;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--threshold" && i + 1 < argc) threshold = std::strtod(argv[++i], nullptr);
+        else if (arg == "--confidence" && i + 1 < argc) confidence = std::strtod(argv[++i], nullptr);
+        else if (!arg.empty() && arg[0] != '-') files.push_back(arg);
+        else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (files.size() != 2 || confidence <= 0.0 || confidence >= 1.0 || threshold < 0.0) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    benchres::Results base;
+    benchres::Results cur;
+    try {
+        base = benchres::read(files[0]);
+        cur = benchres::read(files[1]);
+    } catch (const std::exception& e) {
+        std::cerr << "bench_compare: " << e.what() << '\n';
+        return 2;
+    }
+
+    for (const char* key : {"host", "cpu", "compiler", "build_type", "kernel"}) {
+        if (base.meta(key) != cur.meta(key)) {
+            std::cerr << "warning: " << key << " differs (baseline '" << base.meta(key) << "', current '"
+                      << cur.meta(key) << "'); results may not be comparable\n";
+        }
+    }
+    std::cout << "baseline " << base.meta("git_commit") << " vs current " << cur.meta("git_commit") << ", "
+              << static_cast<int>(confidence * 100) << "% CI, threshold " << threshold * 100 << "%\n\n";
+
+    char line[256];
+    std::snprintf(line, sizeof(line), "%-52s %14s %14s %9s %21s  %s\n", "metric", "baseline", "current", "change",
+                  "interval", "verdict");
+    std::cout << line;
+
+    int regressions = 0;
+    for (const auto& metric : cur.metrics) {
+        const benchres::Metric* reference = base.find(metric.name);
+        if (!reference) {
+            std::cout << metric.name << ": new metric, no baseline\n";
+            continue;
+        }
+        const Comparison c = compare(*reference, metric, threshold, confidence);
+        if (c.verdict == Verdict::Regression) ++regressions;
+        std::snprintf(line, sizeof(line), "%-52s %14.6g %14.6g %+8.2f%% [%+8.2f%%, %+8.2f%%]  %s\n",
+                      metric.name.c_str(), summarize(reference->samples).mean, summarize(metric.samples).mean,
+                      c.change * 100, c.low * 100, c.high * 100, label(c.verdict));
+        std::cout << line;
+    }
+    for (const auto& metric : base.metrics) {
+        if (!cur.find(metric.name)) std::cout << metric.name << ": missing from current run\n";
+    }
+
+    std::cout << '\n' << regressions << " significant regression(s)\n";
+    return regressions ? 1 : 0;
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include "Json.h"
+
+#include <cstdio>
+#include <fstream>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace benchres {
+
+/// One tracked quantity with a sample per repetition.
+struct Metric {
+    std::string         name;
+    std::string         unit;
+    bool                higher_is_better{false};
+    std::vector<double> samples;
+};
+
+/**
+ * @brief Stored benchmark run: free-form metadata plus metrics.
+ *
+ * File format:
+ *
+ *     {"metadata": {"key": "value", ...},
+ *      "metrics": [{"name": ..., "unit": ..., "higher_is_better": bool, "samples": [...]}, ...]}
+ */
+struct Results {
+    std::vector<std::pair<std::string, std::string>> metadata;
+    std::vector<Metric>                              metrics;
+
+    /// Find or create metric @p name.
+    Metric& metric(const std::string& name, const std::string& unit, bool higher_is_better) {
+        for (auto& m : metrics) {
+            if (m.name == name) return m;
+        }
+        metrics.push_back(Metric{name, unit, higher_is_better, {}});
+        return metrics.back();
+    }
+
+    const Metric* find(const std::string& name) const noexcept {
+        for (const auto& m : metrics) {
+            if (m.name == name) return &m;
+        }
+        return nullptr;
+    }
+
+    std::string meta(const std::string& key) const {
+        for (const auto& [k, v] : metadata) {
+            if (k == key) return v;
+        }
+        return {};
+    }
+};
+
+inline void write(std::ostream& os, const Results& results) {
+    os << "{\n  \"metadata\": {";
+    for (std::size_t i = 0; i < results.metadata.size(); ++i) {
+        os << (i ? ",\n    " : "\n    ") << json::quote(results.metadata[i].first) << ": "
+           << json::quote(results.metadata[i].second);
+    }
+    os << "\n  },\n  \"metrics\": [";
+    for (std::size_t i = 0; i < results.metrics.size(); ++i) {
+        const Metric& m = results.metrics[i];
+        os << (i ? ",\n    " : "\n    ") << "{\"name\": " << json::quote(m.name) << ", \"unit\": " << json::quote(m.unit)
+           << ", \"higher_is_better\": " << (m.higher_is_better ? "true" : "false") << ", \"samples\": [";
+        for (std::size_t s = 0; s < m.samples.size(); ++s) {
+            char buf[32];
+            std::snprintf(buf, sizeof(buf), "%.9g", m.samples[s]);
+            os << (s ? ", " : "") << buf;
+        }
+        os << "]}";
+    }
+    os << "\n  ]\n}\n";
+}
+
+/// Load a results file; throws `std::runtime_error` when unreadable or malformed.
+inline Results read(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) throw std::runtime_error("cannot open " + path);
+    std::stringstream buffer;
+    buffer << in.rdbuf();
+    const json::Value root = json::parse(buffer.str());
+
+    Results results;
+    if (const json::Value* meta = root.find("metadata"); meta && meta->type == json::Value::Type::Object) {
+        for (const auto& [key, value] : meta->object) results.metadata.emplace_back(key, value.string);
+    }
+    const json::Value* metrics = root.find("metrics");
+    if (!metrics || metrics->type != json::Value::Type::Array) throw std::runtime_error(path + ": no metrics array");
+    for (const auto& entry : metrics->array) {
+        Metric m;
+        m.name = entry.string_or("name");
+        m.unit = entry.string_or("unit");
+        if (const json::Value* hib = entry.find("higher_is_better")) m.higher_is_better = hib->boolean;
+        if (const json::Value* samples = entry.find("samples")) {
+            for (const auto& s : samples->array) m.samples.push_back(s.number);
+        }
+        if (!m.name.empty()) results.metrics.push_back(std::move(m));
+    }
+    return results;
+}
+
+} // namespace benchres
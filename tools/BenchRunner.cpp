@@ -0,0 +1,249 @@
+#include "BenchResults.h"
+#include "Json.h"
+
+#include <sys/utsname.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef BENCH_COMPILER
+#define BENCH_COMPILER "unknown"
+#endif
+#ifndef BENCH_BUILD_TYPE
+#define BENCH_BUILD_TYPE "unknown"
+#endif
+#ifndef BENCH_SOURCE_DIR
+#define BENCH_SOURCE_DIR "."
+#endif
+
+namespace fs = std::filesystem;
+
+namespace {
+
+struct Options {
+    int         repetitions{5};
+    std::string out{"bench-results.json"};
+    fs::path    bin_dir;
+    bool        quick{false};
+};
+
+void usage(const char* argv0) {
+    std::cerr << "usage: " << argv0 << " [--repetitions N] [--out <path>|-] [--bin-dir DIR] [--quick]\n";
+}
+
+/// Run @p command through the shell and return its stdout; @p ok reports exit status 0.
+std::string capture(const std::string& command, bool& ok) {
+    std::string output;
+    FILE* pipe = ::popen(command.c_str(), "r");
+    if (!pipe) {
+        ok = false;
+        return output;
+    }
+    char buf[4096];
+    std::size_t n;
+    while ((n = std::fread(buf, 1, sizeof(buf), pipe)) > 0) output.append(buf, n);
+    ok = ::pclose(pipe) == 0;
+    return output;
+}
+
+std::string trim(std::string s) {
+    while (!s.empty() && (s.back() == '\n' || s.back() == ' ')) s.pop_back();
+    return s;
+}
+
+std::string cpu_model() {
+    std::ifstream in("/proc/cpuinfo");
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.rfind("model name", 0) == 0) {
+            const auto colon = line.find(':');
+            if (colon != std::string::npos) return line.substr(line.find_first_not_of(' ', colon + 1));
+        }
+    }
+    return "unknown";
+}
+
+void collect_metadata(benchres::Results& results, const Options& opts) {
+    char host[256] = {};
+    ::gethostname(host, sizeof(host) - 1);
+    utsname uts{};
+    ::uname(&uts);
+    bool ok = false;
+    std::string commit = trim(capture("git -C '" BENCH_SOURCE_DIR "' rev-parse --short HEAD 2>/dev/null", ok));
+    if (!ok || commit.empty()) commit = "unknown";
+    std::string dirty = trim(capture("git -C '" BENCH_SOURCE_DIR "' status --porcelain --untracked-files=no 2>/dev/null", ok));
+
+    const std::time_t now = std::time(nullptr);
+    char stamp[32];
+    std::strftime(stamp, sizeof(stamp), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+
+    results.metadata = {
+        {"host", host},
+        {"cpu", cpu_model()},
+        {"hardware_threads", std::to_string(std::thread::hardware_concurrency())},
+        {"kernel", std::string(uts.sysname) + " " + uts.release},
+        {"compiler", BENCH_COMPILER},
+        {"build_type", BENCH_BUILD_TYPE},
+        {"git_commit", commit + (dirty.empty() ? "" : "-dirty")},
+        {"timestamp", stamp},
+        {"repetitions", std::to_string(opts.repetitions)},
+        {"suite", opts.quick ? "quick" : "full"},
+    };
+}
+
+double to_ns(double value, const std::string& unit) {
+    if (unit == "us") return value * 1e3;
+    if (unit == "ms") return value * 1e6;
+    if (unit == "s") return value * 1e9;
+    return value;
+}
+
+/// Google Benchmark binary: one `cpu_time` sample per repetition of each benchmark.
+void run_gbench(benchres::Results& results, const fs::path& binary, const Options& opts) {
+    std::string command = "'" + binary.string() + "' --benchmark_format=json --benchmark_repetitions=" +
+                          std::to_string(opts.repetitions);
+    if (opts.quick) command += " '--benchmark_filter=-BM_Restore|BM_EndOfDay|BM_Uncross'";
+    bool ok = false;
+    const std::string output = capture(command + " 2>/dev/null", ok);
+    if (!ok) {
+        std::cerr << "  " << binary.filename().string() << " failed; skipped\n";
+        return;
+    }
+    const json::Value root = json::parse(output);
+    const json::Value* entries = root.find("benchmarks");
+    if (!entries) return;
+    for (const auto& entry : entries->array) {
+        if (entry.string_or("run_type", "iteration") != "iteration") continue;
+        const std::string name = binary.filename().string() + "/" + entry.string_or("run_name", entry.string_or("name"));
+        results.metric(name, "ns", false)
+            .samples.push_back(to_ns(entry.number_or("cpu_time", 0.0), entry.string_or("time_unit", "ns")));
+    }
+}
+
+/// Harnesses built on `bench::JsonReport`: run once per repetition, keep selected fields.
+void run_report(benchres::Results& results, const fs::path& binary, const std::string& args, const Options& opts) {
+    const fs::path tmp = fs::temp_directory_path() / ("bench_runner_" + std::to_string(::getpid()) + ".json");
+    for (int rep = 0; rep < opts.repetitions; ++rep) {
+        bool ok = false;
+        capture("'" + binary.string() + "' " + args + " --json '" + tmp.string() + "' >/dev/null 2>&1", ok);
+        std::ifstream in(tmp);
+        if (!ok || !in) {
+            std::cerr << "  " << binary.filename().string() << " failed; skipped\n";
+            break;
+        }
+        std::stringstream buffer;
+        buffer << in.rdbuf();
+        const json::Value root = json::parse(buffer.str());
+        const json::Value* entries = root.find("results");
+        if (!entries) break;
+        for (const auto& entry : entries->array) {
+            const std::string prefix = binary.filename().string() + "/" + entry.string_or("name") + "/";
+            for (const char* key : {"p50_ns", "p99_ns"}) {
+                if (entry.find(key)) results.metric(prefix + key, "ns", false).samples.push_back(entry.number_or(key, 0.0));
+            }
+            // Throughput only means something for saturated runs; paced runs achieve the offered rate.
+            if (entry.number_or("offered_per_sec", -1.0) == 0.0) {
+                results.metric(prefix + "achieved_per_sec", "1/s", true)
+                    .samples.push_back(entry.number_or("achieved_per_sec", 0.0));
+            }
+        }
+    }
+    fs::remove(tmp);
+}
+
+} // namespace
+
+/**
+ * Run the fixed regression suite (core, parse, latency and engine benchmarks) with
+ * repetitions and store every sample plus machine/compiler metadata as JSON for
+ * `bench_compare`. Binaries are looked up in `--bin-dir` (default: this executable's
+ * directory); missing ones are skipped with a note.
+ */
+int main(int argc, char** argv) {
+    Options opts;
+    opts.bin_dir = fs::read_symlink("/proc/self/exe").parent_path();
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        auto value = [&]() -> const char* {
+            if (i + 1 >= argc) {
+                usage(argv[0]);
+                std::exit(1);
+            }
+            return argv[++i];
+        };
+        if (arg == "--repetitions") opts.repetitions = std::atoi(value());
+        else if (arg == "--out") opts.out = value();
+        else if (arg == "--bin-dir") opts.bin_dir = value();
+        else if (arg == "--quick") opts.quick = true;
+        else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (opts.repetitions < 1) {
+        std::cerr << "--repetitions must be at least 1\n";
+        return 1;
+    }
+
+    benchres::Results results;
+    collect_metadata(results, opts);
+
+    const std::string latency_args = opts.quick ? "--iterations 20000" : "--iterations 200000";
+    const std::string engine_args =
+        std::string("--symbols 1,10 --loads 0.5 --events ") + (opts.quick ? "20000" : "100000");
+
+    struct Step {
+        const char* binary;
+        bool        gbench;
+        std::string args;
+    };
+    const std::vector<Step> suite = {
+        {"orderbook_bench", true, {}},
+        {"engine_parse_bench", true, {}},
+        {"latency_bench", false, latency_args},
+        {"engine_bench", false, engine_args},
+    };
+
+    try {
+        for (const auto& step : suite) {
+            const fs::path binary = opts.bin_dir / step.binary;
+            if (!fs::exists(binary)) {
+                std::cerr << step.binary << ": not built; skipped\n";
+                continue;
+            }
+            const auto start = std::chrono::steady_clock::now();
+            std::cerr << step.binary << " x" << opts.repetitions << "..." << std::flush;
+            if (step.gbench) run_gbench(results, binary, opts);
+            else run_report(results, binary, step.args, opts);
+            const std::chrono::duration<double> took = std::chrono::steady_clock::now() - start;
+            std::cerr << " " << static_cast<int>(took.count()) << "s\n";
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "\nbench_runner: " << e.what() << '\n';
+        return 1;
+    }
+
+    if (opts.out == "-") {
+        benchres::write(std::cout, results);
+    } else {
+        std::ofstream out(opts.out);
+        if (!out) {
+            std::cerr << "cannot write " << opts.out << '\n';
+            return 1;
+        }
+        benchres::write(out, results);
+        std::cerr << results.metrics.size() << " metrics written to " << opts.out << '\n';
+    }
+    return 0;
+}
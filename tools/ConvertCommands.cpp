@@ -0,0 +1,65 @@
+#include "engine/BinaryProtocol.h"
+#include "engine/CommandParser.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Translate a text command file into the binary ingress protocol.
+ *
+ * Usage: command_converter [input.txt|-] [output.bin|-]
+ *
+ * Client IDs are assigned dense numeric identifiers in order of first appearance;
+ * CHECKPOINT lines have no binary equivalent and are dropped.
+ */
+int main(int argc, char** argv) {
+    const std::string in_path  = argc > 1 ? argv[1] : "-";
+    const std::string out_path = argc > 2 ? argv[2] : "-";
+
+    std::string text;
+    if (in_path == "-") {
+        text.assign(std::istreambuf_iterator<char>(std::cin), std::istreambuf_iterator<char>());
+    } else {
+        std::ifstream in(in_path, std::ios::binary);
+        if (!in) {
+            std::cerr << "cannot open " << in_path << '\n';
+            return 1;
+        }
+        text.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+
+    engine::SymbolTable symbols;
+    engine::CommandParser parser(symbols);
+    engine::wire::BinaryEncoder encoder(symbols);
+    std::unordered_map<std::string, std::uint64_t, engine::TransparentStringHash, std::equal_to<>> client_ids;
+    std::vector<char> out;
+    out.reserve(text.size() * 2);
+    std::size_t dropped = 0;
+
+    auto client_id = [&](std::string_view id) {
+        if (id.empty()) return std::uint64_t{0};
+        if (auto it = client_ids.find(id); it != client_ids.end()) return it->second;
+        const auto next = static_cast<std::uint64_t>(client_ids.size() + 1);
+        client_ids.emplace(std::string(id), next);
+        return next;
+    };
+
+    parser.parse(text.data(), text.size(), [&](std::uint32_t symbol, const engine::CommandRef& cmd) {
+        if (!encoder.encode(symbol, cmd, client_id(cmd.id), out)) ++dropped;
+    }, /*final=*/true);
+
+    std::FILE* sink = out_path == "-" ? stdout : std::fopen(out_path.c_str(), "wb");
+    if (!sink) {
+        std::cerr << "cannot open " << out_path << '\n';
+        return 1;
+    }
+    std::fwrite(out.data(), 1, out.size(), sink);
+    if (sink != stdout) std::fclose(sink);
+    if (dropped > 0) std::cerr << "dropped " << dropped << " commands without a binary encoding\n";
+    return 0;
+}
@@ -0,0 +1,115 @@
+#include "engine/BinaryProtocol.h"
+#include "engine/CommandParser.h"
+#include "workload/OrderFlow.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+void usage(const char* argv0) {
+    std::cerr << "usage: " << argv0 << " [--events N] [--seed S] [--symbols N] [--zipf S]\n"
+              << "       [--rate EV_PER_SEC] [--hawkes ALPHA BETA] [--cancel R] [--amend R] [--aggress R]\n"
+              << "       [--fok-share R] [--distance-exponent A] [--max-distance TICKS] [--mid PRICE]\n"
+              << "       [--drift TICKS] [--max-qty Q] [--binary] [--output <path>]\n";
+}
+
+} // namespace
+
+/**
+ * Emit a deterministic synthetic command stream in the `engine` text format (default)
+ * or the binary ingress protocol (`--binary`). Identical flags and seed always produce
+ * byte-identical output.
+ */
+int main(int argc, char** argv) {
+    workload::Config config;
+    std::size_t events = 1'000'000;
+    bool binary = false;
+    std::string output;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        auto value = [&]() -> const char* {
+            if (i + 1 >= argc) {
+                usage(argv[0]);
+                std::exit(1);
+            }
+            return argv[++i];
+        };
+        if (arg == "--events") events = std::strtoull(value(), nullptr, 10);
+        else if (arg == "--seed") config.seed = std::strtoull(value(), nullptr, 10);
+        else if (arg == "--symbols") config.symbols = static_cast<std::uint32_t>(std::strtoul(value(), nullptr, 10));
+        else if (arg == "--zipf") config.zipf_exponent = std::strtod(value(), nullptr);
+        else if (arg == "--rate") config.rate = std::strtod(value(), nullptr);
+        else if (arg == "--hawkes") {
+            config.arrivals     = workload::Arrivals::Hawkes;
+            config.hawkes_alpha = std::strtod(value(), nullptr);
+            config.hawkes_beta  = std::strtod(value(), nullptr);
+        }
+        else if (arg == "--cancel") config.cancel_ratio = std::strtod(value(), nullptr);
+        else if (arg == "--amend") config.amend_ratio = std::strtod(value(), nullptr);
+        else if (arg == "--aggress") config.aggress_ratio = std::strtod(value(), nullptr);
+        else if (arg == "--fok-share") config.fok_share = std::strtod(value(), nullptr);
+        else if (arg == "--distance-exponent") config.distance_exponent = std::strtod(value(), nullptr);
+        else if (arg == "--max-distance") config.max_distance = std::strtoll(value(), nullptr, 10);
+        else if (arg == "--mid") config.start_mid = std::strtoll(value(), nullptr, 10);
+        else if (arg == "--drift") config.drift_ticks = std::strtod(value(), nullptr);
+        else if (arg == "--max-qty") config.max_quantity = std::strtoll(value(), nullptr, 10);
+        else if (arg == "--binary") binary = true;
+        else if (arg == "--output") output = value();
+        else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (config.cancel_ratio + config.amend_ratio + config.aggress_ratio > 1.0) {
+        std::cerr << "cancel + amend + aggress ratios must not exceed 1\n";
+        return 1;
+    }
+
+    std::ofstream file;
+    if (!output.empty()) {
+        file.open(output, std::ios::binary);
+        if (!file) {
+            std::cerr << "cannot open " << output << '\n';
+            return 1;
+        }
+    }
+    std::ostream& out = output.empty() ? std::cout : file;
+
+    workload::OrderFlow flow(config);
+    if (!binary) {
+        for (std::size_t i = 0; i < events; ++i) workload::OrderFlow::write_text(out, flow.next());
+        return out ? 0 : 1;
+    }
+
+    engine::SymbolTable symbols;
+    for (std::uint32_t s = 0; s < flow.config().symbols; ++s) symbols.intern(workload::OrderFlow::symbol_name(s));
+    engine::wire::BinaryEncoder encoder(symbols);
+    std::vector<char> buffer;
+    for (std::size_t i = 0; i < events; ++i) {
+        const auto event = flow.next();
+        engine::CommandRef cmd;
+        cmd.side  = event.side;
+        cmd.tif   = event.tif;
+        cmd.price = event.price;
+        cmd.qty   = event.quantity;
+        switch (event.action) {
+        case workload::Action::New:
+            cmd.type = event.side == ob::types::Side::Buy ? engine::Command::Type::Buy : engine::Command::Type::Sell;
+            break;
+        case workload::Action::Cancel: cmd.type = engine::Command::Type::Cancel; break;
+        case workload::Action::Amend: cmd.type = engine::Command::Type::Modify; break;
+        }
+        encoder.encode(event.symbol, cmd, event.order, buffer);
+        if (buffer.size() >= (1 << 20)) {
+            out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+            buffer.clear();
+        }
+    }
+    out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    return out ? 0 : 1;
+}
@@ -0,0 +1,174 @@
+#pragma once
+
+#include <cctype>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace json {
+
+/**
+ * @brief Parsed JSON value; just enough for benchmark result files.
+ *
+ * Objects keep insertion order (a vector of pairs) so files written from a parsed
+ * value diff cleanly. Parsing failures throw `std::runtime_error`.
+ */
+struct Value {
+    enum class Type { Null, Bool, Number, String, Array, Object };
+
+    Type                                       type{Type::Null};
+    bool                                       boolean{false};
+    double                                     number{0.0};
+    std::string                                string;
+    std::vector<Value>                         array;
+    std::vector<std::pair<std::string, Value>> object;
+
+    /// @return Member @p key of an object, or nullptr.
+    const Value* find(std::string_view key) const noexcept {
+        if (type != Type::Object) return nullptr;
+        for (const auto& [name, value] : object) {
+            if (name == key) return &value;
+        }
+        return nullptr;
+    }
+
+    double number_or(std::string_view key, double fallback) const noexcept {
+        const Value* v = find(key);
+        return v && v->type == Type::Number ? v->number : fallback;
+    }
+
+    std::string string_or(std::string_view key, std::string fallback = {}) const {
+        const Value* v = find(key);
+        return v && v->type == Type::String ? v->string : fallback;
+    }
+};
+
+class Parser {
+public:
+    explicit Parser(std::string_view text) : text_(text) {}
+
+    Value parse() {
+        Value v = value();
+        skip_ws();
+        if (pos_ != text_.size()) fail("trailing characters");
+        return v;
+    }
+
+private:
+    [[noreturn]] void fail(const char* what) const {
+        throw std::runtime_error(std::string("json: ") + what + " at offset " + std::to_string(pos_));
+    }
+
+    void skip_ws() {
+        while (pos_ < text_.size() && std::isspace(static_cast<unsigned char>(text_[pos_]))) ++pos_;
+    }
+
+    bool consume(char c) {
+        skip_ws();
+        if (pos_ < text_.size() && text_[pos_] == c) {
+            ++pos_;
+            return true;
+        }
+        return false;
+    }
+
+    void expect(char c) {
+        if (!consume(c)) fail("unexpected character");
+    }
+
+    Value value() {
+        skip_ws();
+        if (pos_ >= text_.size()) fail("unexpected end");
+        Value v;
+        const char c = text_[pos_];
+        if (c == '{') {
+            ++pos_;
+            v.type = Value::Type::Object;
+            if (consume('}')) return v;
+            do {
+                skip_ws();
+                std::string key = string_literal();
+                expect(':');
+                v.object.emplace_back(std::move(key), value());
+            } while (consume(','));
+            expect('}');
+        } else if (c == '[') {
+            ++pos_;
+            v.type = Value::Type::Array;
+            if (consume(']')) return v;
+            do {
+                v.array.push_back(value());
+            } while (consume(','));
+            expect(']');
+        } else if (c == '"') {
+            v.type = Value::Type::String;
+            v.string = string_literal();
+        } else if (text_.substr(pos_, 4) == "true" || text_.substr(pos_, 5) == "false") {
+            v.type = Value::Type::Bool;
+            v.boolean = c == 't';
+            pos_ += v.boolean ? 4 : 5;
+        } else if (text_.substr(pos_, 4) == "null") {
+            pos_ += 4;
+        } else {
+            v.type = Value::Type::Number;
+            const std::string token(text_.substr(pos_, text_.find_first_of(",]} \t\r\n", pos_) - pos_));
+            char* end = nullptr;
+            v.number = std::strtod(token.c_str(), &end);
+            if (token.empty() || end != token.c_str() + token.size()) fail("invalid number");
+            pos_ += token.size();
+        }
+        return v;
+    }
+
+    std::string string_literal() {
+        if (pos_ >= text_.size() || text_[pos_] != '"') fail("expected string");
+        ++pos_;
+        std::string out;
+        while (pos_ < text_.size() && text_[pos_] != '"') {
+            char c = text_[pos_++];
+            if (c == '\\' && pos_ < text_.size()) {
+                const char e = text_[pos_++];
+                switch (e) {
+                case 'n': c = '\n'; break;
+                case 't': c = '\t'; break;
+                case 'r': c = '\r'; break;
+                case 'b': c = '\b'; break;
+                case 'f': c = '\f'; break;
+                case 'u':
+                    // Benchmark files are ASCII; keep the escape verbatim rather than decode.
+                    out += "\\u";
+                    continue;
+                default: c = e; break;
+                }
+            }
+            out += c;
+        }
+        if (pos_ >= text_.size()) fail("unterminated string");
+        ++pos_;
+        return out;
+    }
+
+    std::string_view text_;
+    std::size_t      pos_{0};
+};
+
+inline Value parse(std::string_view text) { return Parser(text).parse(); }
+
+/// Quote @p s as a JSON string literal.
+inline std::string quote(std::string_view s) {
+    std::string out = "\"";
+    for (char c : s) {
+        if (c == '"' || c == '\\') out += '\\';
+        if (c == '\n') {
+            out += "\\n";
+            continue;
+        }
+        out += c;
+    }
+    return out + '"';
+}
+
+} // namespace json